@@ -2,9 +2,20 @@
 #include "assert.hpp"
 #include "util/tuple.hpp"
 #include "util/std.hpp"
+#include <mutex>
 
 namespace proptest {
 
+namespace {
+
+std::mutex& getDefaultReporterMutex()
+{
+    static std::mutex mtx;
+    return mtx;
+}
+
+}  // namespace
+
 namespace util {
 
 uint64_t getGlobalSeed()
@@ -18,51 +29,102 @@ uint64_t getGlobalSeed()
     }
 }
 
+Verbosity getGlobalVerbosity()
+{
+    static const char* env_verbosity = std::getenv("PROPTEST_VERBOSITY");
+    if (env_verbosity) {
+        string value(env_verbosity);
+        if (value == "quiet" || value == "0")
+            return Verbosity::Quiet;
+        else if (value == "verbose" || value == "2")
+            return Verbosity::Verbose;
+    }
+    return Verbosity::Normal;
+}
+
 }  // namespace utilr
 
-PropertyContext* PropertyBase::context = nullptr;
+thread_local PropertyContext* PropertyBase::context = nullptr;
 uint32_t PropertyBase::defaultNumRuns = 1000;
+shared_ptr<Reporter> PropertyBase::defaultReporter;
+Verbosity PropertyBase::verbosity = util::getGlobalVerbosity();
+
+void PropertyBase::setDefaultReporter(shared_ptr<Reporter> reporter)
+{
+    std::lock_guard<std::mutex> guard(getDefaultReporterMutex());
+    defaultReporter = reporter;
+}
+
+shared_ptr<Reporter> PropertyBase::getDefaultReporter()
+{
+    std::lock_guard<std::mutex> guard(getDefaultReporterMutex());
+    if (!defaultReporter) {
+        static const char* env_report_json = std::getenv("PROPTEST_REPORT_JSON");
+        if (env_report_json) {
+            defaultReporter = util::make_shared<MultiReporter>(vector<shared_ptr<Reporter>>{
+                util::make_shared<ConsoleReporter>(), util::make_shared<JsonLinesReporter>(string(env_report_json))});
+        } else {
+            defaultReporter = util::make_shared<ConsoleReporter>();
+        }
+    }
+    return defaultReporter;
+}
+
+void PropertyBase::setVerbosity(Verbosity v)
+{
+    verbosity = v;
+}
+
+Verbosity PropertyBase::getVerbosity()
+{
+    return verbosity;
+}
 
 void PropertyBase::setContext(PropertyContext* ctx)
 {
     context = ctx;
 }
 
-void PropertyBase::tag(const char* file, int lineno, string key, string value)
+PropertyContext& PropertyBase::getCurrentContext()
 {
-    if (!context)
-        throw runtime_error("context is not set");
-
-    context->tag(file, lineno, key, value);
+    if (context)
+        return *context;
+
+    // e.g. a thread spawned by the property function
+    PropertyContext* fallback = PropertyContext::getFallbackContext();
+    if (!fallback)
+        throw runtime_error("context is not set (threads spawned while several properties run need their own context)");
+    return *fallback;
 }
 
-void PropertyBase::succeed(const char* file, int lineno, const char* condition, const stringstream& str)
+void PropertyBase::tag(const char* file, int lineno, string key, string value)
 {
-    if (!context)
-        throw runtime_error("context is not set");
+    getCurrentContext().tag(file, lineno, key, value);
+}
 
-    context->succeed(file, lineno, condition, str);
+util::TagCounters& PropertyBase::getTagCounters()
+{
+    return getCurrentContext().getTagCounters();
 }
 
-void PropertyBase::fail(const char* file, int lineno, const char* condition, const stringstream& str)
+stringstream& PropertyBase::succeed()
 {
-    if (!context)
-        throw runtime_error("context is not set");
+    return getCurrentContext().succeed();
+}
 
-    context->fail(file, lineno, condition, str);
+void PropertyBase::succeed(const char* file, int lineno, const char* condition, const stringstream& str)
+{
+    getCurrentContext().succeed(file, lineno, condition, str);
 }
 
-bool PropertyBase::invoke(Random&)
+void PropertyBase::fail(const char* file, int lineno, const char* condition, const stringstream& str)
 {
-    return true;
+    getCurrentContext().fail(file, lineno, condition, str);
 }
 
 stringstream& PropertyBase::getLastStream()
 {
-    if (!context)
-        throw runtime_error("context is not set");
-
-    return context->getLastStream();
+    return getCurrentContext().getLastStream();
 }
 
 }  // namespace proptest
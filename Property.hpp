@@ -12,6 +12,7 @@
 #include "PropertyContext.hpp"
 #include "PropertyBase.hpp"
 #include "Stream.hpp"
+#include "util/workerpool.hpp"
 #include "util/std.hpp"
 
 /**
@@ -69,31 +70,32 @@ struct Matrix {
 
 /**
  * @brief Holder class for properties
- * @details When a property is defined using `proptest::property` or `proptest::forAll`, a `Property` object is created to hold the property.
+ * @details When a property is defined using `proptest::property` or `proptest::forAll`, a `BasicProperty` object is
+ * created to hold the property. The property function and the generators are stored with their concrete types, so
+ * that generation and invocation in each run can be inlined by the compiler instead of going through type erasure.
+ * `Property<ARGS...>` is the type-erased form, to which any `BasicProperty` with the same arguments can be converted.
+ *
+ * @tparam Func property function type, callable as `(ARGS...) -> bool`
+ * @tparam GenTuple tuple of generator types, one for each of `ARGS`
  */
-template <typename... ARGS>
-class Property final : public PropertyBase {
-public:
-    using Func = function<bool(ARGS...)>;
-    using GenTuple = tuple<GenFunction<decay_t<ARGS>>...>;
-private:
-    using ValueTuple = tuple<Shrinkable<decay_t<ARGS>>...>;
-    using ShrinksTuple = tuple<Stream<Shrinkable<decay_t<ARGS>>>...>;
-
+template <typename Func, typename GenTuple, typename... ARGS>
+class BasicProperty : public PropertyBase {
 public:
-    Property(const Func& f, const GenTuple& g) : PropertyBase(new Func(f), new GenTuple(g)) {}
+    BasicProperty(const Func& f, const GenTuple& g) : func(f), genTup(g) {}
 
-private:
-    bool invoke(Random& rand) { return util::invokeWithGenTuple(rand, getFunc(), getGenTup()); }
+    template <typename Func2, typename GenTuple2>
+    BasicProperty(const BasicProperty<Func2, GenTuple2, ARGS...>& other)
+        : PropertyBase(other), func(other.func), genTup(other.genTup)
+    {
+    }
 
-public:
     /**
      * @brief Sets the seed value for deterministic input generation
      *
      * @param s Seed in uint64_t type
-     * @return Property& `Property` object itself for chaining
+     * @return BasicProperty& `BasicProperty` object itself for chaining
      */
-    Property& setSeed(uint64_t s)
+    BasicProperty& setSeed(uint64_t s)
     {
         seed = s;
         return *this;
@@ -103,21 +105,99 @@ public:
      * @brief Sets the number of runs
      *
      * @param runs Number of runs
-     * @return Property& `Property` object itself for chaining
+     * @return BasicProperty& `BasicProperty` object itself for chaining
      */
-    Property& setNumRuns(uint32_t runs)
+    BasicProperty& setNumRuns(uint32_t runs)
     {
         numRuns = runs;
         return *this;
     }
 
+    /**
+     * @brief Enables or disables growing size schedule (enabled by default)
+     * @details If enabled, size ranges of container generators such as `Arbi<vector<T>>` or `Arbi<string>` are scaled
+     * down in early runs and grow over the run index, so that small inputs are tried first and shrinking starts from
+     * smaller counterexamples. If disabled, every run draws sizes from the full range.
+     *
+     * @param enable whether to grow the size range over the runs
+     * @return BasicProperty& `BasicProperty` object itself for chaining
+     */
+    BasicProperty& setGrowingSize(bool enable)
+    {
+        growingSize = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the number of shrink candidates tested concurrently (1 by default, i.e. sequential shrinking)
+     * @details If greater than 1, shrinking tests the next candidates in batches of `numThreads`, on a pool of
+     * `numThreads` threads kept for the whole shrinking, and continues with the first failing one in order. The
+     * simplest input found is the same as with sequential shrinking, but candidates after a failing one in a batch may
+     * be tested needlessly. The property function, and the startup and cleanup functions if set, must be safe to be
+     * called concurrently.
+     *
+     * @param numThreads Maximum number of candidates tested at once
+     * @return BasicProperty& `BasicProperty` object itself for chaining
+     */
+    BasicProperty& setShrinkThreads(uint32_t numThreads)
+    {
+        shrinkThreads = numThreads > 0 ? numThreads : 1;
+        return *this;
+    }
+
+    /**
+     * @brief Sets how much of the arguments is printed in reports (`ShowLimits::summary()` by default)
+     * @details Failed arguments and the counterexample are printed within the limits. Steps of shrinking an argument
+     * with a size (e.g. a container or a string) are reported only as the change of its size, e.g. `size 1000 -> 500`,
+     * unless the limits are unlimited. Pass `ShowLimits()` to print everything in full.
+     *
+     * @param limits Bounds of printed elements, nesting and string bytes
+     * @return BasicProperty& `BasicProperty` object itself for chaining
+     */
+    BasicProperty& setShowLimits(const ShowLimits& limits)
+    {
+        showLimits = limits;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the name of the property, used in reports
+     *
+     * @param n Name of the property
+     * @return BasicProperty& `BasicProperty` object itself for chaining
+     */
+    BasicProperty& setName(const string& n)
+    {
+        name = n;
+        return *this;
+    }
+
+    /**
+     * @brief Sets the reporter of progress and results of `forAll`, overriding the default reporter
+     * @details @see Reporter, PropertyBase::setDefaultReporter
+     *
+     * @param r Reporter to use
+     * @return BasicProperty& `BasicProperty` object itself for chaining
+     */
+    BasicProperty& setReporter(shared_ptr<Reporter> r)
+    {
+        reporter = r;
+        return *this;
+    }
+
+    /**
+     * @brief Returns the instrumentation counters of the last `forAll` call, per phase
+     * @details Counters are zero unless the library is built with `PROPTEST_ENABLE_INSTRUMENTATION`
+     */
+    const InstrumentationReport& getInstrumentationReport() const { return instrumentation; }
+
     /**
      * @brief Sets the startup function
      *
      * @param onStartUp Invoked in each run before running the property function
-     * @return Property& `Property` object itself for chaining
+     * @return BasicProperty& `BasicProperty` object itself for chaining
      */
-    Property& setOnStartup(function<void()> onStartup) {
+    BasicProperty& setOnStartup(function<void()> onStartup) {
         onStartupPtr = util::make_shared<function<void()>>(onStartup);
         return *this;
     }
@@ -126,9 +206,9 @@ public:
      * @brief Sets the cleanup function
      *
      * @param onCleanup Invoked in each run after running the property function.
-     * @return Property& `Property` object itself for chaining
+     * @return BasicProperty& `BasicProperty` object itself for chaining
      */
-    Property& setOnCleanup(function<void()> onCleanup) {
+    BasicProperty& setOnCleanup(function<void()> onCleanup) {
         onCleanupPtr = util::make_shared<function<void()>>(onCleanup);
         return *this;
     }
@@ -151,69 +231,8 @@ public:
     template <typename... ExplicitGens>
     bool forAll(ExplicitGens&&... gens)
     {
-        Random rand(seed);
-        Random savedRand(seed);
-        cout << "random seed: " << seed << endl;
-        PropertyContext ctx;
-        auto curGenTup = util::overrideTuple(getGenTup(), gens...);
-
-        int i = 0;
-        try {
-            for (; i < numRuns; i++) {
-                bool pass = true;
-                do {
-                    pass = true;
-                    try {
-                        savedRand = rand;
-                        if(onStartupPtr)
-                            (*onStartupPtr)();
-                        bool result = util::invokeWithGenTuple(rand, getFunc(), curGenTup);
-                        if(onCleanupPtr)
-                            (*onCleanupPtr)();
-                        stringstream failures = ctx.flushFailures();
-                        // failed expectations
-                        if (failures.rdbuf()->in_avail()) {
-                            cerr << "Falsifiable, after " << (i + 1) << " tests: ";
-                            cerr << failures.str();
-                            shrink(savedRand, util::forward<GenTuple>(curGenTup));
-                            return false;
-                        } else if (!result) {
-                            cerr << "Falsifiable, after " << (i + 1) << " tests" << endl;
-                            shrink(savedRand, util::forward<GenTuple>(curGenTup));
-                            return false;
-                        }
-                        pass = true;
-                    } catch (const Success&) {
-                        pass = true;
-                    } catch (const Discard&) {
-                        // silently discard combination
-                        pass = false;
-                    }
-                } while (!pass);
-            }
-        } catch (const AssertFailed& e) {
-            cerr << "Falsifiable, after " << (i + 1) << " tests: " << e.what() << " (" << e.filename << ":"
-                      << e.lineno << ")" << endl;
-            // shrink
-            shrink(savedRand, util::forward<GenTuple>(curGenTup));
-            return false;
-        } catch (const PropertyFailedBase& e) {
-            cerr << "Falsifiable, after " << (i + 1) << " tests: " << e.what() << " (" << e.filename << ":"
-                      << e.lineno << ")" << endl;
-            // shrink
-            shrink(savedRand, util::forward<GenTuple>(curGenTup));
-            return false;
-        } catch (const exception& e) {
-            cerr << "Falsifiable, after " << (i + 1) << " tests - unhandled exception thrown: " << e.what()
-                      << endl;
-            // shrink
-            shrink(savedRand, util::forward<GenTuple>(curGenTup));
-            return false;
-        }
-
-        cout << "OK, passed " << numRuns << " tests" << endl;
-        ctx.printSummary();
-        return true;
+        auto curGenTup = util::overrideTupleHead(genTup, util::forward<ExplicitGens>(gens)...);
+        return runForAll(curGenTup);
     }
 
     /**
@@ -238,7 +257,7 @@ private:
                 try {
                     if(onStartupPtr)
                         (*onStartupPtr)();
-                    bool result = util::invokeWithArgs(getFunc(), valueTup);
+                    bool result = util::invokeWithArgs(func, valueTup);
                     if(onCleanupPtr)
                         (*onCleanupPtr)();
                     return result;
@@ -252,11 +271,13 @@ private:
                 cerr << "Discard is not supported for single run" << endl;
             }
         } catch (const PropertyFailedBase& e) {
+            util::ScopedShowLimits limits(showLimits);
             cerr << "example failed: " << e.what() << " (" << e.filename << ":" << e.lineno << ")" << endl;
             cerr << "  with args: " << Show<tuple<ARGS...>>(valueTup) << endl;
             return false;
         } catch (const exception& e) {
             // skip shrinking?
+            util::ScopedShowLimits limits(showLimits);
             cerr << "example failed by exception: " << e.what() << endl;
             cerr << "  with args: " << Show<tuple<ARGS...>>(valueTup) << endl;
             return false;
@@ -298,7 +319,97 @@ public:
     }
 
 private:
-    template <size_t N, typename Replace>
+    template <typename CurGenTuple>
+    bool runForAll(CurGenTuple& curGenTup)
+    {
+        using clock = std::chrono::steady_clock;
+        PROPTEST_INSTRUMENT_PHASE(Execution);
+        Reporter& rep = getReporter();
+        PropertyReport report;
+        report.name = name;
+        report.seed = seed;
+        report.numRuns = numRuns;
+        auto start = clock::now();
+        rep.onStart(report);
+        {
+            PropertyContext ctx;
+            report.passed = runAndShrink(ctx, curGenTup, report, rep);
+            instrumentation = ctx.getInstrumentation();
+            report.tags = ctx.getTagCounts();
+        }
+        report.instrumentation = instrumentation;
+        report.elapsedMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        rep.onEnd(report);
+        return report.passed;
+    }
+
+    template <typename CurGenTuple>
+    bool runAndShrink(PropertyContext& ctx, CurGenTuple& curGenTup, PropertyReport& report, Reporter& rep)
+    {
+        Random rand(seed);
+        Random savedRand(seed);
+
+        int i = 0;
+        try {
+            for (; i < numRuns; i++) {
+                bool pass = true;
+                do {
+                    pass = true;
+                    try {
+                        if (growingSize)
+                            rand.setSizeFactor(i + 1, numRuns);
+                        savedRand = rand;
+                        if(onStartupPtr)
+                            (*onStartupPtr)();
+                        bool result = util::invokeWithGenTuple(rand, func, curGenTup);
+                        if(onCleanupPtr)
+                            (*onCleanupPtr)();
+                        // failed expectations
+                        if (ctx.hasFailures()) {
+                            report.runs = i + 1;
+                            report.failure = ctx.flushFailures().str();
+                            shrink(savedRand, util::forward<CurGenTuple>(curGenTup), report, rep);
+                            return false;
+                        } else if (!result) {
+                            report.runs = i + 1;
+                            shrink(savedRand, util::forward<CurGenTuple>(curGenTup), report, rep);
+                            return false;
+                        }
+                        pass = true;
+                    } catch (const Success&) {
+                        pass = true;
+                    } catch (const Discard&) {
+                        // silently discard combination
+                        report.discards++;
+                        pass = false;
+                    }
+                } while (!pass);
+            }
+        } catch (const AssertFailed& e) {
+            report.runs = i + 1;
+            report.failure = string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")";
+            // shrink
+            shrink(savedRand, util::forward<CurGenTuple>(curGenTup), report, rep);
+            return false;
+        } catch (const PropertyFailedBase& e) {
+            report.runs = i + 1;
+            report.failure = string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")";
+            // shrink
+            shrink(savedRand, util::forward<CurGenTuple>(curGenTup), report, rep);
+            return false;
+        } catch (const exception& e) {
+            report.runs = i + 1;
+            report.failure = string("unhandled exception thrown: ") + e.what();
+            // shrink
+            shrink(savedRand, util::forward<CurGenTuple>(curGenTup), report, rep);
+            return false;
+        }
+
+        report.runs = numRuns;
+        return true;
+    }
+
+    template <size_t N, typename ValueTuple, typename Replace>
     bool test(ValueTuple&& valueTup, Replace&& replace)
     {
         bool result = false;
@@ -306,8 +417,9 @@ private:
         try {
             if(onStartupPtr)
                 (*onStartupPtr)();
+            PROPTEST_INSTRUMENT(countInvocation());
             result =
-                util::invokeWithArgTupleWithReplace<N>(getFunc(), util::forward<decltype(values)>(values), replace.get());
+                util::invokeWithArgTupleWithReplace<N>(func, util::forward<decltype(values)>(values), replace.get());
             if(onCleanupPtr)
                 (*onCleanupPtr)();
         } catch (const AssertFailed&) {
@@ -331,32 +443,63 @@ private:
         }
     }
 
+    // size of a container or a string, or -1 for other types
+    template <typename T>
+    static auto sizeOf(const T& value, int) -> decltype(static_cast<int64_t>(value.size()))
+    {
+        return static_cast<int64_t>(value.size());
+    }
+
+    template <typename T>
+    static int64_t sizeOf(const T&, long)
+    {
+        return -1;
+    }
+
     template <size_t N, typename ValueTuple, typename ShrinksTuple>
-    decltype(auto) shrinkN(ValueTuple&& valueTup, ShrinksTuple&& shrinksTuple)
+    decltype(auto) shrinkN(ValueTuple&& valueTup, ShrinksTuple&& shrinksTuple, PropertyReport& report, Reporter& rep,
+                           util::WorkerPool* pool)
     {
         auto shrinks = get<N>(shrinksTuple);
+        int64_t size = sizeOf(get<N>(valueTup).getRef(), 0);
         // keep shrinking until no shrinking is possible
         while (!shrinks.isEmpty()) {
             // printShrinks(shrinks);
             auto iter = shrinks.iterator();
             bool shrinkFound = false;
-            PropertyContext context;
-            // keep trying until failure is reproduced
-            while (iter.hasNext()) {
-                // get shrinkable
-                auto next = iter.next();
-                if (!test<N>(util::forward<ValueTuple>(valueTup), next) || context.hasFailures()) {
-                    shrinks = next.shrinks();
-                    get<N>(valueTup) = next;
-                    shrinkFound = true;
-                    break;
+            string failures;
+            if (pool) {
+                shrinkFound = findShrinkConcurrently<N>(util::forward<ValueTuple>(valueTup), iter, failures, *pool);
+                if (shrinkFound)
+                    shrinks = get<N>(valueTup).shrinks();
+            } else {
+                PropertyContext context;
+                // keep trying until failure is reproduced
+                while (iter.hasNext()) {
+                    // get shrinkable
+                    auto next = iter.next();
+                    if (!test<N>(util::forward<ValueTuple>(valueTup), next) || context.hasFailures()) {
+                        shrinks = next.shrinks();
+                        get<N>(valueTup) = next;
+                        shrinkFound = true;
+                        break;
+                    }
                 }
+                if (context.hasFailures())
+                    failures = context.flushFailures(4).str();
             }
             if (shrinkFound) {
-                cout << "  shrinking found simpler failing arg " << N << ": " << Show<ValueTuple>(valueTup)
-                          << endl;
-                if (context.hasFailures())
-                    cout << "    by failed expectation: " << context.flushFailures(4).str() << endl;
+                int64_t newSize = sizeOf(get<N>(valueTup).getRef(), 0);
+                stringstream args;
+                if (newSize >= 0 && !showLimits.isUnlimited()) {
+                    args << "size " << size << " -> " << newSize;
+                } else {
+                    util::ScopedShowLimits limits(showLimits);
+                    args << Show<ValueTuple>(valueTup);
+                }
+                report.shrinkSteps.emplace_back(N, args.str(), failures, size, newSize);
+                size = newSize;
+                rep.onShrinkStep(report, report.shrinkSteps.back());
             } else {
                 break;
             }
@@ -365,97 +508,176 @@ private:
         return get<N>(valueTup);
     }
 
+    // tests candidates in batches of the pool size concurrently, and replaces argument N with the first failing one
+    template <size_t N, typename ValueTuple, typename Iterator>
+    bool findShrinkConcurrently(ValueTuple&& valueTup, Iterator& iter, string& failures, util::WorkerPool& pool)
+    {
+        using shrinkable_t = decay_t<decltype(iter.next())>;
+        const size_t batchSize = static_cast<size_t>(pool.size());
+        vector<shrinkable_t> batch;
+        batch.reserve(batchSize);
+        while (iter.hasNext()) {
+            // candidates are taken on this thread, as streams are evaluated lazily
+            batch.clear();
+            while (batch.size() < batchSize && iter.hasNext())
+                batch.push_back(iter.next());
+
+            vector<char> failed(batch.size(), false);
+            vector<string> batchFailures(batch.size());
+            vector<exception_ptr> exceptions(batch.size());
+            vector<InstrumentationReport> instrumentations(batch.size());
+            auto testCandidate = [&](size_t i) {
+                // the phase is per thread
+                PROPTEST_INSTRUMENT_PHASE(Shrinking);
+                // tasks of the pool must not throw; exceptions test() does not handle are rethrown on this thread
+                try {
+                    PropertyContext context;
+                    decay_t<ValueTuple> args = valueTup;
+                    failed[i] = !test<N>(util::move(args), batch[i]) || context.hasFailures();
+                    if (context.hasFailures())
+                        batchFailures[i] = context.flushFailures(4).str();
+                    instrumentations[i] = context.getInstrumentation();
+                } catch (...) {
+                    exceptions[i] = current_exception();
+                }
+            };
+            pool.run([&](int worker) {
+                if (static_cast<size_t>(worker) < batch.size())
+                    testCandidate(static_cast<size_t>(worker));
+            });
+            // counted on the workers, and added to the context of this thread
+            if (util::Instrumentation::isEnabled() && PropertyBase::getContext()) {
+                for (auto& instrumentation : instrumentations)
+                    PropertyBase::getContext()->addInstrumentation(instrumentation);
+            }
+
+            for (size_t i = 0; i < batch.size(); i++) {
+                if (exceptions[i])
+                    rethrow_exception(exceptions[i]);
+                if (failed[i]) {
+                    get<N>(valueTup) = batch[i];
+                    failures = batchFailures[i];
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     template <size_t... index, typename ValueTuple, typename ShrinksTuple>
-    decltype(auto) shrinkEach(ValueTuple&& valueTup, ShrinksTuple&& shrinksTup, index_sequence<index...>)
+    decltype(auto) shrinkEach(ValueTuple&& valueTup, ShrinksTuple&& shrinksTup, PropertyReport& report, Reporter& rep,
+                              util::WorkerPool* pool, index_sequence<index...>)
     {
-        return util::make_tuple(
-            shrinkN<index>(util::forward<ValueTuple>(valueTup), util::forward<ShrinksTuple>(shrinksTup))...);
+        return util::make_tuple(shrinkN<index>(util::forward<ValueTuple>(valueTup),
+                                               util::forward<ShrinksTuple>(shrinksTup), report, rep, pool)...);
     }
 
-    void shrink(Random& savedRand, GenTuple&& curGenTup)
+    template <typename CurGenTuple>
+    void shrink(Random& savedRand, CurGenTuple&& curGenTup, PropertyReport& report, Reporter& rep)
     {
+        using clock = std::chrono::steady_clock;
+        PROPTEST_INSTRUMENT_PHASE(Shrinking);
+        auto start = clock::now();
         // regenerate failed value tuple
         auto generatedValueTup =
-            util::transformHeteroTupleWithArg<util::Generate>(util::forward<GenTuple>(curGenTup), savedRand);
+            util::transformHeteroTupleWithArg<util::Generate>(util::forward<CurGenTuple>(curGenTup), savedRand);
 
-        cout << "  with args: " << Show<decltype(generatedValueTup)>(generatedValueTup) << endl;
+        util::ScopedShowLimits limits(showLimits);
+        stringstream failedArgs;
+        failedArgs << Show<decltype(generatedValueTup)>(generatedValueTup);
+        report.failedArgs = failedArgs.str();
+        rep.onFailure(report);
         // cout << (valueTup == valueTup2 ? "gen equals original" : "gen not equals original") << endl;
-        static constexpr auto Size = tuple_size<GenTuple>::value;
+        static constexpr auto Size = tuple_size<decay_t<CurGenTuple>>::value;
         auto shrinksTuple =
             util::transformHeteroTuple<util::GetShrinks>(util::forward<decltype(generatedValueTup)>(generatedValueTup));
+        // threads testing shrink candidates are reused for the whole shrinking
+        unique_ptr<util::WorkerPool> pool;
+        if (shrinkThreads > 1)
+            pool.reset(new util::WorkerPool(static_cast<int>(shrinkThreads)));
         auto shrunk = shrinkEach(util::forward<decltype(generatedValueTup)>(generatedValueTup),
-                                 util::forward<decltype(shrinksTuple)>(shrinksTuple), make_index_sequence<Size>{});
-        cout << "  simplest args found by shrinking: " << Show<decltype(shrunk)>(shrunk) << endl;
+                                 util::forward<decltype(shrinksTuple)>(shrinksTuple), report, rep, pool.get(),
+                                 make_index_sequence<Size>{});
+        stringstream counterexample;
+        counterexample << Show<decltype(shrunk)>(shrunk);
+        report.counterexample = counterexample.str();
+        report.shrinkMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
     }
 
-    Func& getFunc() {
-        return *static_pointer_cast<Func>(funcPtr);
-    }
+    Func func;
+    GenTuple genTup;
 
-    GenTuple& getGenTup() {
-        return *static_pointer_cast<GenTuple>(genTupPtr);
-    }
+    template <typename, typename, typename...>
+    friend class BasicProperty;
+};
+
+/**
+ * @brief Type-erased property holder, storing the property function as `std::function` and generators as
+ * `GenFunction`s
+ * @details Any `BasicProperty` with the same arguments converts to it, e.g. to store properties of different callables
+ * in the same variable or container.
+ */
+template <typename... ARGS>
+class Property final : public BasicProperty<function<bool(ARGS...)>, tuple<GenFunction<decay_t<ARGS>>...>, ARGS...> {
+    using base_t = BasicProperty<function<bool(ARGS...)>, tuple<GenFunction<decay_t<ARGS>>...>, ARGS...>;
+
+public:
+    using base_t::base_t;
+
+    // e.g. from the result of a setter chained on a `Property`
+    Property(const base_t& other) : base_t(other) {}
 };
 
 namespace util {
 
 /// * private
-template <typename RetType, typename Callable, typename... ARGS>
-enable_if_t<is_same<RetType, bool>::value, function<bool(ARGS...)>> functionWithBoolResultHelper(
-    util::TypeList<ARGS...>, Callable&& callable)
-{
-    return static_cast<function<RetType(ARGS...)>>(callable);
-}
+template <typename Callable, typename RetType, typename ArgumentTypeList>
+struct FunctionWithBoolResult;
 
 /// * private
-template <typename RetType, typename Callable, typename... ARGS>
-enable_if_t<is_same<RetType, void>::value, function<bool(ARGS...)>> functionWithBoolResultHelper(
-    util::TypeList<ARGS...>, Callable&& callable)
+template <typename Callable, typename... ARGS>
+struct FunctionWithBoolResult<Callable, bool, util::TypeList<ARGS...>>
 {
-    return function<bool(ARGS...)>([callable](ARGS&&... args) {
-        callable(util::forward<ARGS>(args)...);
-        return true;
-    });
-}
+    bool operator()(ARGS... args) { return callable(util::forward<ARGS>(args)...); }
 
-/// * private
-template <class Callable>
-decltype(auto) functionWithBoolResult(Callable&& callable)
-{
-    using RetType = typename function_traits<Callable>::return_type;
-    typename function_traits<Callable>::argument_type_list argument_type_list;
-    return functionWithBoolResultHelper<RetType>(argument_type_list, util::forward<Callable>(callable));
-}
+    Callable callable;
+};
 
 /// * private
-template <typename RetType, typename Callable, typename... ARGS>
-function<RetType(ARGS...)> asFunctionHelper(util::TypeList<ARGS...>, Callable&& callable)
+template <typename Callable, typename... ARGS>
+struct FunctionWithBoolResult<Callable, void, util::TypeList<ARGS...>>
 {
-    return static_cast<function<RetType(ARGS...)>>(callable);
-}
+    bool operator()(ARGS... args)
+    {
+        callable(util::forward<ARGS>(args)...);
+        return true;
+    }
+
+    Callable callable;
+};
 
 /// * private
 template <class Callable>
-decltype(auto) asFunction(Callable&& callable)
+decltype(auto) functionWithBoolResult(Callable&& callable)
 {
-    using RetType = typename function_traits<Callable>::return_type;
-    typename function_traits<Callable>::argument_type_list argument_type_list;
-    return asFunctionHelper<RetType>(argument_type_list, util::forward<Callable>(callable));
+    using CallableType = decay_t<Callable>;
+    using RetType = typename function_traits<CallableType>::return_type;
+    using ArgumentTypeList = typename function_traits<CallableType>::argument_type_list;
+    return FunctionWithBoolResult<CallableType, RetType, ArgumentTypeList>{util::forward<Callable>(callable)};
 }
 
 /// * private
-template <typename... ARGS>
-decltype(auto) createProperty(function<bool(ARGS...)> func,
-                              tuple<GenFunction<decay_t<ARGS>>...>&& genTup)
+template <typename... ARGS, typename Func, typename GenTuple>
+decltype(auto) createProperty(util::TypeList<ARGS...>, Func&& func, GenTuple&& genTup)
 {
-    return Property<ARGS...>(func, genTup);
+    return BasicProperty<decay_t<Func>, decay_t<GenTuple>, ARGS...>(func, genTup);
 }
 
 }  // namespace util
 
 /**
  * @brief creates a property object that can be used to run various property tests
- * @details @see Property
+ * @details @see BasicProperty
  * @tparam Callable property callable type in either `(ARGS...) -> bool` (success/fail by boolean return value) or `(ARGS...) -> void` (fail if exception is thrown, success eitherwise)
  * @tparam ExplicitGens Explicit generator callable types for each `ARG` in `(Random&) -> Shrinkable<ARG>`
  * @param callable passed as any either `std::function`, functor object, function pointer
@@ -466,9 +688,9 @@ auto property(Callable&& callable, ExplicitGens&&... gens)
 {
     // acquire full tuple of generators
     typename function_traits<Callable>::argument_type_list argument_type_list;
-    auto func = util::functionWithBoolResult(callable);
-    auto genTup = util::createGenTuple(argument_type_list, util::asFunction(util::forward<decltype(gens)>(gens))...);
-    return util::createProperty(func, util::forward<decltype(genTup)>(genTup));
+    auto func = util::functionWithBoolResult(util::forward<Callable>(callable));
+    auto genTup = util::createTypedGenTuple(argument_type_list, util::forward<ExplicitGens>(gens)...);
+    return util::createProperty(argument_type_list, util::move(func), util::move(genTup));
 }
 /**
  * @brief immediately executes a randomized property test
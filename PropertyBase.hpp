@@ -3,19 +3,21 @@
 #include "api.hpp"
 #include "gen.hpp"
 #include "PropertyContext.hpp"
+#include "Reporter.hpp"
+#include "util/printing.hpp"
+#include "util/instrumentation.hpp"
 #include "util/std.hpp"
 
-#define PROP_EXPECT_STREAM(condition, a, sign, b)                                            \
-    ([&]() -> stringstream& {                                                           \
-        if (!(condition)) {                                                                  \
-            stringstream __prop_expect_stream_str;                                      \
-            __prop_expect_stream_str << (a) << (sign) << (b);                                      \
-            ::proptest::PropertyBase::fail(__FILE__, __LINE__, #condition, __prop_expect_stream_str);    \
-        } else {                                                                             \
-            stringstream __prop_expect_stream_str;                                      \
-            ::proptest::PropertyBase::succeed(__FILE__, __LINE__, #condition, __prop_expect_stream_str); \
-        }                                                                                    \
-        return ::proptest::PropertyBase::getLastStream();                                                \
+// operands are formatted only if the expectation fails
+#define PROP_EXPECT_STREAM(condition, a, sign, b)                                                     \
+    ([&]() -> stringstream& {                                                                         \
+        if (!(condition)) {                                                                           \
+            stringstream __prop_expect_stream_str;                                                    \
+            __prop_expect_stream_str << (a) << (sign) << (b);                                         \
+            ::proptest::PropertyBase::fail(__FILE__, __LINE__, #condition, __prop_expect_stream_str); \
+            return ::proptest::PropertyBase::getLastStream();                                         \
+        }                                                                                             \
+        return ::proptest::PropertyBase::succeed();                                                   \
     })()
 
 #define PROP_EXPECT(cond) PROP_EXPECT_STREAM(cond, "", "", "")
@@ -38,31 +40,25 @@
     PROP_EXPECT_STREAM(memcmp(a, b, (n1 <= n2 ? n1 : n2)) != 0, ::proptest::Show<char*>(a, n1), " equals ", \
                        ::proptest::Show<char*>(b, n2))
 
-#define PROP_STAT(VALUE)                                                                       \
-    do {                                                                                       \
-        stringstream __prop_stat_key;                                                     \
-        __prop_stat_key << (#VALUE);                                                           \
-        stringstream __prop_stat_value;                                                   \
-        __prop_stat_value << boolalpha;                                                   \
-        __prop_stat_value << (VALUE);                                                          \
-        ::proptest::PropertyBase::tag(__FILE__, __LINE__, __prop_stat_key.str(), __prop_stat_value.str()); \
+// key ids are cached per call site and thread, and boolean/integral values are formatted only for the summary
+#define PROP_STAT(VALUE)                                                                \
+    do {                                                                                \
+        static thread_local ::proptest::util::TagSite __prop_tag_site;                 \
+        ::proptest::PropertyBase::tag(__prop_tag_site, #VALUE, (VALUE));                \
     } while (false)
 
-#define PROP_TAG(KEY, VALUE)                                                                   \
-    do {                                                                                       \
-        stringstream __prop_stat_key;                                                     \
-        __prop_stat_key << (KEY);                                                              \
-        stringstream __prop_stat_value;                                                   \
-        __prop_stat_value << boolalpha;                                                   \
-        __prop_stat_value << (VALUE);                                                          \
-        ::proptest::PropertyBase::tag(__FILE__, __LINE__, __prop_stat_key.str(), __prop_stat_value.str()); \
+#define PROP_TAG(KEY, VALUE)                                                            \
+    do {                                                                                \
+        static thread_local ::proptest::util::TagSite __prop_tag_site;                 \
+        ::proptest::PropertyBase::tag(__prop_tag_site, (KEY), (VALUE));                 \
     } while (false)
 
-#define PROP_CLASSIFY(condition, KEY, VALUE)                   \
-    do {                                                       \
-        if (condition) {                                       \
-            ::proptest::PropertyBase::tag(__FILE__, __LINE__, KEY, VALUE); \
-        }                                                      \
+#define PROP_CLASSIFY(condition, KEY, VALUE)                                            \
+    do {                                                                                \
+        if (condition) {                                                                \
+            static thread_local ::proptest::util::TagSite __prop_tag_site;             \
+            ::proptest::PropertyBase::tag(__prop_tag_site, (KEY), (VALUE));             \
+        }                                                                               \
     } while (false)
 
 namespace proptest {
@@ -74,36 +70,76 @@ uint64_t getGlobalSeed();
 
 class PROPTEST_API PropertyBase {
 public:
-    template <typename Func, typename GenTuple>
-    PropertyBase(Func* _funcPtr, GenTuple* _genTupPtr)
- : seed(util::getGlobalSeed()), numRuns(defaultNumRuns), funcPtr(_funcPtr), genTupPtr(_genTupPtr)  {}
+    PropertyBase()
+        : seed(util::getGlobalSeed()),
+          numRuns(defaultNumRuns),
+          growingSize(true),
+          shrinkThreads(1),
+          showLimits(ShowLimits::summary())
+    {
+    }
 
     static void setDefaultNumRuns(uint32_t);
+    /**
+     * @brief Sets the reporter used by properties without their own reporter
+     * @details If not set, a `ConsoleReporter` is used. If environment variable `PROPTEST_REPORT_JSON` is set to a
+     * file path, a `JsonLinesReporter` appending to the file is used in addition.
+     */
+    static void setDefaultReporter(shared_ptr<Reporter> reporter);
+    static shared_ptr<Reporter> getDefaultReporter();
+    /**
+     * @brief Sets the amount of console output (`Verbosity::Normal` by default)
+     * @details If not set, environment variable `PROPTEST_VERBOSITY` (`quiet`, `normal` or `verbose`) is used.
+     */
+    static void setVerbosity(Verbosity verbosity);
+    static Verbosity getVerbosity();
     static void tag(const char* filename, int lineno, string key, string value);
+    template <typename Key, typename Value>
+    static void tag(util::TagSite& site, const Key& key, const Value& value)
+    {
+        util::TagValue<decay_t<Value>>::count(getTagCounters(), util::tagKeyId(site, key), value);
+    }
+    static util::TagCounters& getTagCounters();
     static void succeed(const char* filename, int lineno, const char* condition, const stringstream& str);
     static void fail(const char* filename, int lineno, const char* condition, const stringstream& str);
+    static stringstream& succeed();
     static stringstream& getLastStream();
+    /// context of the property test running on the calling thread (`nullptr` if none)
+    static PropertyContext* getContext() { return context; }
 
 protected:
     static void setContext(PropertyContext* context);
-    static PropertyContext* getContext() { return context; }
-    static PropertyContext* context;
+    // context of the calling thread, or its fallback context if the thread has none
+    static PropertyContext& getCurrentContext();
+    static thread_local PropertyContext* context;
 
 protected:
-    bool invoke(Random& rand);
+    Reporter& getReporter() const { return reporter ? *reporter : *getDefaultReporter(); }
 
     static uint32_t defaultNumRuns;
+    static shared_ptr<Reporter> defaultReporter;
+    static Verbosity verbosity;
 
     // TODO: configurations
     uint64_t seed;
     uint32_t numRuns;
+    bool growingSize;
+    uint32_t shrinkThreads;
+    ShowLimits showLimits;
+    InstrumentationReport instrumentation;
+    string name;
+    shared_ptr<Reporter> reporter;
 
-    shared_ptr<void> funcPtr;
-    shared_ptr<void> genTupPtr;
     shared_ptr<function<void()>> onStartupPtr;
     shared_ptr<function<void()>> onCleanupPtr;
 
     friend struct PropertyContext;
 };
 
+template <typename Func, typename GenTuple, typename... ARGS>
+class BasicProperty;
+
+template <typename... ARGS>
+class Property;
+
 }  // namespace proptest
@@ -1,9 +1,76 @@
 #include "PropertyContext.hpp"
 #include "PropertyBase.hpp"
+#include "Reporter.hpp"
 #include "util/std.hpp"
+#include <atomic>
 
 namespace proptest {
 
+namespace {
+
+// text written after a successful expectation is never shown, so it goes to a stream in failed state that ignores it
+stringstream& getDiscardingStream()
+{
+    static thread_local stringstream str;
+    str.setstate(ios::badbit);
+    return str;
+}
+
+}  // namespace
+
+// the current context of the root's thread, shared with the fallback contexts of other threads
+struct PropertyContext::RootLink
+{
+    explicit RootLink(PropertyContext* _target) : target(_target), hasPending(false) {}
+
+    std::mutex mtx;
+    PropertyContext* target;
+    // flushed fallback contexts, merged by the root's thread into its current context
+    list<unique_ptr<PropertyContext>> pending;
+    std::atomic<bool> hasPending;
+};
+
+// fallback context of a thread, handed over to its root link when replaced or when the thread exits
+struct PropertyContext::FallbackHolder
+{
+    ~FallbackHolder() { flush(); }
+
+    void flush()
+    {
+        if (link && context) {
+            // counted on this thread, before the context is handed over
+            context->settleInstrumentation();
+            std::lock_guard<std::mutex> guard(link->mtx);
+            if (link->target) {
+                link->pending.push_back(util::move(context));
+                link->hasPending = true;
+            }
+        }
+        context.reset();
+        link.reset();
+    }
+
+    shared_ptr<RootLink> link;
+    unique_ptr<PropertyContext> context;
+};
+
+namespace {
+
+std::mutex& getRootMutex()
+{
+    static std::mutex mtx;
+    return mtx;
+}
+
+// links of the root contexts of the running properties
+list<shared_ptr<void>>& getRootLinks()
+{
+    static list<shared_ptr<void>> links;
+    return links;
+}
+
+}  // namespace
+
 ostream& operator<<(ostream& os, const Failure& f)
 {
     auto detail = f.str.str();
@@ -14,41 +81,144 @@ ostream& operator<<(ostream& os, const Failure& f)
     return os;
 }
 
-PropertyContext::PropertyContext() : lastStreamExists(false), oldContext(PropertyBase::getContext())
+PropertyContext::PropertyContext()
+    : lastStreamExists(false), oldContext(PropertyBase::getContext()), parent(nullptr), attached(true)
 {
     PropertyBase::setContext(this);
+    if (oldContext) {
+        // nested on the root's thread, e.g. for shrinking: becomes the target of fallback contexts
+        rootLink = oldContext->rootLink;
+        if (rootLink) {
+            // fallback contexts flushed so far belong to the enclosing context
+            oldContext->mergeFallbacks();
+            std::lock_guard<std::mutex> guard(rootLink->mtx);
+            rootLink->target = this;
+        }
+    } else {
+        rootLink = util::make_shared<RootLink>(this);
+        std::lock_guard<std::mutex> guard(getRootMutex());
+        getRootLinks().push_back(rootLink);
+    }
+    if (util::Instrumentation::isEnabled())
+        instrumentationStart = util::Instrumentation::snapshot();
 }
 
-PropertyContext::~PropertyContext()
+PropertyContext::PropertyContext(PropertyContext& _parent)
+    : lastStreamExists(false), oldContext(PropertyBase::getContext()), parent(&_parent), attached(true)
 {
-    PropertyBase::setContext(oldContext);
+    PropertyBase::setContext(this);
+    if (util::Instrumentation::isEnabled())
+        instrumentationStart = util::Instrumentation::snapshot();
 }
 
-void PropertyContext::tag(const char* file, int lineno, string key, string value)
+PropertyContext::PropertyContext(Detached)
+    : lastStreamExists(false), oldContext(nullptr), parent(nullptr), attached(false)
 {
-    auto itr = tags.find(key);
-    // key already exists
-    if (itr != tags.end()) {
-        auto& valueMap = itr->second;
-        auto valueItr = valueMap.find(value);
-        // value already exists
-        if (valueItr != valueMap.end()) {
-            auto& tag = valueItr->second;
-            tag.count++;
+    if (util::Instrumentation::isEnabled())
+        instrumentationStart = util::Instrumentation::snapshot();
+}
+
+PropertyContext::~PropertyContext()
+{
+    if (parent) {
+        settleInstrumentation();
+        parent->merge(*this);
+    } else if (oldContext && attached && util::Instrumentation::isEnabled()) {
+        // counters of this thread are already those of the enclosing context
+        oldContext->addInstrumentation(instrumentationMerged);
+    }
+    if (rootLink) {
+        if (oldContext && oldContext->rootLink == rootLink) {
+            std::lock_guard<std::mutex> guard(rootLink->mtx);
+            rootLink->target = oldContext;
         } else {
-            valueMap.insert(pair<string, Tag>(value, Tag(file, lineno, value)));
+            {
+                std::lock_guard<std::mutex> guard(getRootMutex());
+                getRootLinks().remove(rootLink);
+            }
+            std::lock_guard<std::mutex> guard(rootLink->mtx);
+            rootLink->target = nullptr;
+            rootLink->pending.clear();
         }
-    } else {
-        map<string, Tag> valueMap;
-        valueMap.insert(pair<string, Tag>(value, Tag(file, lineno, value)));
-        tags.insert(pair<string, map<string, Tag>>(key, valueMap));
     }
+    if (attached)
+        PropertyBase::setContext(oldContext);
+}
+
+PropertyContext* PropertyContext::getFallbackContext()
+{
+    static thread_local FallbackHolder holder;
+    shared_ptr<RootLink> link;
+    {
+        // the thread cannot be told apart between several running properties
+        std::lock_guard<std::mutex> guard(getRootMutex());
+        if (getRootLinks().size() == 1)
+            link = static_pointer_cast<RootLink>(getRootLinks().front());
+    }
+    if (!link)
+        return nullptr;
+    if (holder.link != link || !holder.context) {
+        holder.flush();
+        holder.link = link;
+        holder.context.reset(new PropertyContext(Detached()));
+    }
+    return holder.context.get();
+}
+
+void PropertyContext::merge(PropertyContext& child)
+{
+    std::lock_guard<std::mutex> guard(mergeMutex);
+    tagCounters.merge(child.tagCounters);
+    failures.splice(failures.end(), child.failures);
+    lastStreamExists = false;
+    instrumentationMerged += child.instrumentationMerged;
+}
+
+void PropertyContext::settleInstrumentation()
+{
+    if (!util::Instrumentation::isEnabled())
+        return;
+
+    auto current = util::Instrumentation::snapshot();
+    instrumentationMerged += current - instrumentationStart;
+    instrumentationStart = current;
+}
+
+void PropertyContext::mergeFallbacks()
+{
+    if (!rootLink || !rootLink->hasPending)
+        return;
+
+    list<unique_ptr<PropertyContext>> pending;
+    {
+        std::lock_guard<std::mutex> guard(rootLink->mtx);
+        pending.swap(rootLink->pending);
+        rootLink->hasPending = false;
+    }
+    for (auto& fallback : pending)
+        merge(*fallback);
+}
+
+bool PropertyContext::hasFailures()
+{
+    mergeFallbacks();
+    return !failures.empty();
+}
+
+void PropertyContext::tag(const char*, int, string key, string value)
+{
+    tagCounters.count(util::TagKeys::intern(key), value);
 }
 
 void PropertyContext::succeed(const char*, int, const char*, const stringstream&)
 {
-    // DO NOTHING
+    succeed();
+}
+
+stringstream& PropertyContext::succeed()
+{
     lastStreamExists = false;
+    return getDiscardingStream();
 }
 
 void PropertyContext::fail(const char* filename, int lineno, const char* condition, const stringstream& str)
@@ -59,9 +229,8 @@ void PropertyContext::fail(const char* filename, int lineno, const char* conditi
 
 stringstream& PropertyContext::getLastStream()
 {
-    static stringstream defaultStr;
     if (failures.empty() || !lastStreamExists)
-        return defaultStr;
+        return getDiscardingStream();
 
     return failures.back().str;
 }
@@ -73,6 +242,7 @@ stringstream PropertyContext::flushFailures(int indent)
             str << " ";
     };
 
+    mergeFallbacks();
     stringstream allFailures;
     auto itr = failures.begin();
     if (itr != failures.end()) {
@@ -90,23 +260,40 @@ stringstream PropertyContext::flushFailures(int indent)
 
 void PropertyContext::printSummary()
 {
-    for (auto tagKV : tags) {
-        auto& key = tagKV.first;
-        auto& valueMap = tagKV.second;
-        cout << "  " << key << ": " << endl;
-        size_t total = 0;
-        for (auto valueKV : valueMap) {
-            auto tag = valueKV.second;
-            total += tag.count;
-        }
+    ConsoleReporter::printTags(cout, getTagCounts());
+    printInstrumentation();
+}
 
-        for (auto valueKV : valueMap) {
-            auto value = valueKV.first;
-            auto tag = valueKV.second;
-            cout << "    " << value << ": " << tag.count << "/" << total << " ("
-                      << static_cast<double>(tag.count) / total * 100 << "%)" << endl;
-        }
-    }
+map<string, map<string, size_t>> PropertyContext::getTagCounts()
+{
+    mergeFallbacks();
+    return tagCounters.toMap();
+}
+
+InstrumentationReport PropertyContext::getInstrumentation()
+{
+    if (!util::Instrumentation::isEnabled())
+        return InstrumentationReport();
+
+    mergeFallbacks();
+    InstrumentationReport report = util::Instrumentation::snapshot() - instrumentationStart;
+    std::lock_guard<std::mutex> guard(mergeMutex);
+    report += instrumentationMerged;
+    return report;
+}
+
+void PropertyContext::addInstrumentation(const InstrumentationReport& report)
+{
+    std::lock_guard<std::mutex> guard(mergeMutex);
+    instrumentationMerged += report;
+}
+
+void PropertyContext::printInstrumentation()
+{
+    if (!util::Instrumentation::isEnabled())
+        return;
+
+    ConsoleReporter::printInstrumentation(cout, getInstrumentation());
 }
 
 }  // namespace proptest
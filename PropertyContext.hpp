@@ -1,23 +1,17 @@
 #pragma once
 
 #include "api.hpp"
+#include "util/instrumentation.hpp"
+#include "util/tagcounter.hpp"
 #include "util/std.hpp"
+#include <mutex>
 
 namespace proptest {
 
-struct Tag
-{
-    Tag(const char* f, int l, const string& v) : filename(f), lineno(l), value(v), count(1) {}
-    const char* filename;
-    const int lineno;
-    string value;
-    size_t count;
-};
-
 struct Failure
 {
     Failure(const char* f, int l, const char* c, const stringstream& s)
-        : filename(f), lineno(l), condition(c), str(s.str())
+        : filename(f), lineno(l), condition(c), str(s.str(), ios::in | ios::out | ios::ate)
     {
     }
     const char* filename;
@@ -28,27 +22,87 @@ struct Failure
 
 ostream& operator<<(ostream&, const Failure&);
 
+/**
+ * @brief Collects failed expectations and tags of a property test
+ * @details A context becomes the current context of the thread creating it, until it is destroyed. Expectations and
+ * tags in threads spawned within a run (e.g. concurrent actions) are recorded in a child context created on each of
+ * those threads. A child context records into its own buffers without locking, and merges them into its parent when
+ * destroyed.
+ *
+ * The first context created on a thread without a context is a root context, one for each running property. A thread
+ * without a context of its own (e.g. a `std::thread` spawned by a property function) records into a fallback context,
+ * which is handed over when the thread exits and merged into the current context of the root's thread when the root's
+ * thread checks for failures or tags. This requires the root to be the only running one; while several properties run
+ * at the same time (or shrink candidates are tested in parallel), such a thread should create a child context of
+ * `PropertyBase::getContext()` captured by the property function.
+ *
+ * Instrumentation counters are kept per thread. A context counts those of its own thread since its creation, and adds
+ * those of the child and fallback contexts merged into it. A context nested on the same thread passes on what was
+ * merged into it to the enclosing context when destroyed.
+ */
 struct PROPTEST_API PropertyContext
 {
     PropertyContext();
+    /// creates a child context of `parent` for the calling thread
+    explicit PropertyContext(PropertyContext& parent);
     ~PropertyContext();
 
+    PropertyContext(const PropertyContext&) = delete;
+    PropertyContext& operator=(const PropertyContext&) = delete;
+
     void tag(const char* filename, int lineno, string key, string value);
     void succeed(const char* filename, int lineno, const char* condition, const stringstream& str);
+    /// marks success of an expectation, and returns a stream that ignores text written to it
+    stringstream& succeed();
     void fail(const char* filename, int lineno, const char* condition, const stringstream& str);
     void tag(string key, string value) { tag("?", -1, key, value); }
+    /// counters updated by `PROP_TAG`, `PROP_STAT` and `PROP_CLASSIFY`
+    util::TagCounters& getTagCounters() { return tagCounters; }
     stringstream& getLastStream();
     stringstream flushFailures(int indent = 0);
     void printSummary();
-    bool hasFailures() const { return !failures.empty(); }
+    /// tag counts by key and value
+    map<string, map<string, size_t>> getTagCounts();
+    void printInstrumentation();
+    /// instrumentation counters of this thread since this context was created, and of the contexts merged into it
+    InstrumentationReport getInstrumentation();
+    /// adds instrumentation counters of another thread, e.g. of a context the calling thread waited for
+    void addInstrumentation(const InstrumentationReport& report);
+    bool hasFailures();
+
+    /// fallback context of the calling thread, if it has no context of its own (`nullptr` unless exactly one root
+    /// context exists)
+    static PropertyContext* getFallbackContext();
 
 private:
-    // key -> (value -> Tag(count, detail))
-    map<string, map<string, Tag> > tags;
+    struct RootLink;
+    struct FallbackHolder;
+    struct Detached
+    {
+    };
+
+    // neither becomes the context of the calling thread nor the root context
+    explicit PropertyContext(Detached);
+
+    void merge(PropertyContext& child);
+    // moves the counters of this thread since the creation of this context into instrumentationMerged
+    void settleInstrumentation();
+    // merges fallback contexts handed over to the root link, on the thread of this context
+    void mergeFallbacks();
+
+    util::TagCounters tagCounters;
     list<Failure> failures;
     bool lastStreamExists;
+    InstrumentationReport instrumentationStart;
+    // counters of other threads, and of this context's own thread once settled
+    InstrumentationReport instrumentationMerged;
 
     PropertyContext* oldContext;
+    PropertyContext* parent;
+    bool attached;
+    // set on the root context and the contexts nested in it on the root's thread
+    shared_ptr<RootLink> rootLink;
+    std::mutex mergeMutex;
 };
 
 }  // namespace proptest
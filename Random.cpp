@@ -3,14 +3,22 @@
 
 namespace proptest {
 
-Random::Random(uint64_t seed) : engine(seed) {}
+Random::Random(uint64_t seed) : engine(seed), sizeNumerator(1), sizeDenominator(1) {}
 
-Random::Random(const Random& other) : engine(other.engine), dist(other.dist) {}
+Random::Random(const Random& other)
+    : engine(other.engine),
+      dist(other.dist),
+      sizeNumerator(other.sizeNumerator),
+      sizeDenominator(other.sizeDenominator)
+{
+}
 
 Random& Random::operator=(const Random& other)
 {
     engine = other.engine;
     dist = other.dist;
+    sizeNumerator = other.sizeNumerator;
+    sizeDenominator = other.sizeDenominator;
 
     return *this;
 }
@@ -93,6 +101,44 @@ uint32_t Random::getRandomSize(size_t fromIncluded, size_t toExcluded)
     return (next8U() % (toExcluded - fromIncluded)) + fromIncluded;
 }
 
+void Random::getRandomBytes(uint8_t* buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t value = next8U();
+        // in the same order regardless of endianness
+        for (size_t j = 0; j < 8 && i + j < size; j++)
+            buffer[i + j] = static_cast<uint8_t>(value >> (j * 8));
+    }
+}
+
+size_t Random::getScaledSize(size_t minSize, size_t maxSize)
+{
+    if (maxSize <= minSize)
+        return minSize;
+
+    uint64_t span = maxSize - minSize;
+    if (sizeNumerator < sizeDenominator) {
+        // ceil(span * numerator / denominator) without overflow, as remainder * numerator < denominator^2 <= 2^64
+        uint64_t quotient = span / sizeDenominator;
+        uint64_t remainder = span % sizeDenominator;
+        span = quotient * sizeNumerator + (remainder * sizeNumerator + sizeDenominator - 1) / sizeDenominator;
+    }
+    return static_cast<size_t>(getRandomUInt64(minSize, minSize + span));
+}
+
+void Random::setSizeFactor(uint32_t numerator, uint32_t denominator)
+{
+    if (denominator == 0 || numerator > denominator)
+        throw invalid_argument("invalid size factor: " + to_string(numerator) + "/" + to_string(denominator));
+    sizeNumerator = numerator;
+    sizeDenominator = denominator;
+}
+
+double Random::getSizeFactor() const
+{
+    return static_cast<double>(sizeNumerator) / static_cast<double>(sizeDenominator);
+}
+
 float Random::getRandomFloat()
 {
     uint32_t intVal = getRandomUInt32();
@@ -116,7 +162,11 @@ int64_t getCurrentTime()
 template <>
 char Random::getRandom<char>(int64_t min, int64_t max)
 {
-    return static_cast<char>(getRandomUInt8(min, max));
+    // char is signed on some platforms (e.g. x86) and unsigned on others (e.g. ARM, PowerPC)
+    if (numeric_limits<char>::is_signed)
+        return static_cast<char>(getRandomInt8(static_cast<int8_t>(min), static_cast<int8_t>(max)));
+    else
+        return static_cast<char>(getRandomUInt8(static_cast<uint8_t>(min), static_cast<uint8_t>(max)));
 }
 
 template <>
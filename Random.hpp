@@ -24,6 +24,26 @@ public:
     double getRandomDouble();
     uint32_t getRandomSize(size_t fromIncluded, size_t toExcluded);
 
+    /**
+     * @brief Fills `size` bytes at `buffer` with uniformly random bytes, eight bytes per draw
+     */
+    void getRandomBytes(uint8_t* buffer, size_t size);
+
+    /**
+     * @brief Draws a container size in [minSize, maxSize], where the upper end is scaled down by the size factor
+     * @details With size factor `f`, the size is drawn from `[minSize, minSize + ceil((maxSize - minSize) * f)]`, computed
+     * exactly in integer arithmetic
+     */
+    size_t getScaledSize(size_t minSize, size_t maxSize);
+
+    /**
+     * @brief Sets the size factor `numerator / denominator` in `[0, 1]` that scales the size range of container generators
+     * @details `1/1` (default) leaves size ranges unchanged. Properties grow the factor over the run index as
+     * `(run + 1) / numRuns`, so that small inputs are tried first
+     */
+    void setSizeFactor(uint32_t numerator, uint32_t denominator);
+    double getSizeFactor() const;
+
     Random& operator=(const Random& other);
 
     template <typename T>
@@ -43,6 +63,8 @@ private:
     // default_random_engine engine;
     mt19937_64 engine;
     uniform_int_distribution<uint64_t> dist;
+    uint32_t sizeNumerator;
+    uint32_t sizeDenominator;
 };
 
 template <>
@@ -0,0 +1,336 @@
+#include "Reporter.hpp"
+#include "PropertyBase.hpp"
+#include "util/std.hpp"
+#include <fstream>
+#include <mutex>
+
+namespace proptest {
+
+namespace {
+
+// buffers of the tests in progress on this thread, innermost last, by reporter
+map<const ConsoleReporter*, vector<unique_ptr<stringstream>>>& getConsoleBufferMap()
+{
+    static thread_local map<const ConsoleReporter*, vector<unique_ptr<stringstream>>> buffers;
+    return buffers;
+}
+
+vector<unique_ptr<stringstream>>& getConsoleBuffers(const ConsoleReporter* reporter)
+{
+    return getConsoleBufferMap()[reporter];
+}
+
+// ends the innermost test of the reporter on this thread, removing the reporter's entry once none is in progress
+void popConsoleBuffer(const ConsoleReporter* reporter)
+{
+    auto& buffers = getConsoleBufferMap();
+    auto itr = buffers.find(reporter);
+    if (itr == buffers.end())
+        return;
+    if (!itr->second.empty())
+        itr->second.pop_back();
+    if (itr->second.empty())
+        buffers.erase(itr);
+}
+
+// serializes writes of reporters to their streams
+std::mutex& getOutputMutex()
+{
+    static std::mutex mtx;
+    return mtx;
+}
+
+// length of the valid UTF-8 sequence starting at str[pos], or 0 if invalid (overlong, surrogate, above U+10FFFF)
+size_t validUTF8Length(const string& str, size_t pos)
+{
+    const unsigned char lead = static_cast<unsigned char>(str[pos]);
+    size_t length;
+    unsigned char min = 0x80, max = 0xbf;  // range of the first continuation byte
+    if (lead >= 0xc2 && lead <= 0xdf) {
+        length = 2;
+    } else if (lead >= 0xe0 && lead <= 0xef) {
+        length = 3;
+        if (lead == 0xe0)
+            min = 0xa0;
+        else if (lead == 0xed)
+            max = 0x9f;
+    } else if (lead >= 0xf0 && lead <= 0xf4) {
+        length = 4;
+        if (lead == 0xf0)
+            min = 0x90;
+        else if (lead == 0xf4)
+            max = 0x8f;
+    } else {
+        return 0;
+    }
+    if (pos + length > str.size())
+        return 0;
+    for (size_t i = 1; i < length; i++) {
+        const unsigned char c = static_cast<unsigned char>(str[pos + i]);
+        if (c < (i == 1 ? min : 0x80) || c > (i == 1 ? max : 0xbf))
+            return 0;
+    }
+    return length;
+}
+
+}  // namespace
+
+PropertyReport::PropertyReport()
+    : seed(0), numRuns(0), runs(0), discards(0), passed(false), elapsedMs(0), shrinkMs(0)
+{
+}
+
+Reporter::~Reporter() {}
+
+void Reporter::onStart(const PropertyReport&) {}
+
+void Reporter::onLog(const PropertyReport&, const string&) {}
+
+void Reporter::onFailure(const PropertyReport&) {}
+
+void Reporter::onShrinkStep(const PropertyReport&, const ShrinkStep&) {}
+
+void Reporter::onEnd(const PropertyReport&) {}
+
+ConsoleReporter::ConsoleReporter() : out(cout), err(cerr) {}
+
+ConsoleReporter::ConsoleReporter(ostream& _out, ostream& _err) : out(_out), err(_err) {}
+
+void ConsoleReporter::onStart(const PropertyReport& report)
+{
+    getConsoleBuffers(this).emplace_back(new stringstream());
+    buffer() << "random seed: " << report.seed << '\n';
+}
+
+void ConsoleReporter::onLog(const PropertyReport&, const string& log)
+{
+    if (PropertyBase::getVerbosity() >= Verbosity::Verbose)
+        buffer() << log << '\n';
+}
+
+void ConsoleReporter::onFailure(const PropertyReport& report)
+{
+    stringstream failure;
+    failure << "Falsifiable, after " << report.runs << " tests";
+    if (!report.failure.empty())
+        failure << ": " << report.failure;
+    {
+        // keep the seed and logs before the failure message
+        std::lock_guard<std::mutex> guard(getOutputMutex());
+        out << buffer().str() << std::flush;
+        err << failure.str() << endl;
+    }
+    buffer().str("");
+    if (!report.log.empty())
+        buffer() << report.log << '\n';
+    if (!report.failedArgs.empty())
+        buffer() << "  with args: " << report.failedArgs << '\n';
+    flush();
+}
+
+void ConsoleReporter::onShrinkStep(const PropertyReport&, const ShrinkStep& step)
+{
+    buffer() << "  shrinking found simpler failing arg " << step.argIndex << ": " << step.args << '\n';
+    if (!step.failures.empty())
+        buffer() << "    by failed expectation: " << step.failures << '\n';
+}
+
+void ConsoleReporter::onEnd(const PropertyReport& report)
+{
+    if (report.passed) {
+        if (PropertyBase::getVerbosity() == Verbosity::Quiet) {
+            popConsoleBuffer(this);
+            return;
+        }
+        buffer() << "OK, passed " << report.numRuns << " tests" << '\n';
+        printTags(buffer(), report.tags);
+    } else if (!report.counterexample.empty()) {
+        buffer() << "  simplest args found by shrinking: " << report.counterexample << '\n';
+    }
+    if (util::Instrumentation::isEnabled())
+        printInstrumentation(buffer(), report.instrumentation);
+    flush();
+    popConsoleBuffer(this);
+}
+
+stringstream& ConsoleReporter::buffer()
+{
+    auto& buffers = getConsoleBuffers(this);
+    // e.g. a reporter used without `onStart`
+    if (buffers.empty())
+        buffers.emplace_back(new stringstream());
+    return *buffers.back();
+}
+
+void ConsoleReporter::flush()
+{
+    std::lock_guard<std::mutex> guard(getOutputMutex());
+    out << buffer().str() << std::flush;
+    buffer().str("");
+}
+
+void ConsoleReporter::printTags(ostream& os, const map<string, map<string, size_t>>& tags)
+{
+    for (auto& tagKV : tags) {
+        auto& key = tagKV.first;
+        auto& valueMap = tagKV.second;
+        os << "  " << key << ": " << endl;
+        size_t total = 0;
+        for (auto& valueKV : valueMap)
+            total += valueKV.second;
+
+        for (auto& valueKV : valueMap) {
+            auto& value = valueKV.first;
+            auto count = valueKV.second;
+            os << "    " << value << ": " << count << "/" << total << " ("
+               << static_cast<double>(count) / total * 100 << "%)" << endl;
+        }
+    }
+}
+
+void ConsoleReporter::printInstrumentation(ostream& os, const InstrumentationReport& instrumentation)
+{
+    os << "  instrumentation: " << endl;
+    os << instrumentation;
+}
+
+JsonLinesReporter::JsonLinesReporter(ostream& _os) : os(_os) {}
+
+JsonLinesReporter::JsonLinesReporter(const string& path)
+    : fileStream(util::make_shared<std::ofstream>(path, ios::app)), os(*fileStream)
+{
+    if (!*fileStream)
+        throw runtime_error("cannot open report file: " + path);
+}
+
+void JsonLinesReporter::onEnd(const PropertyReport& report)
+{
+    stringstream line;
+    line << "{\"name\":\"" << escape(report.name) << "\"";
+    line << ",\"seed\":" << report.seed;
+    line << ",\"num_runs\":" << report.numRuns;
+    line << ",\"runs\":" << report.runs;
+    line << ",\"discards\":" << report.discards;
+    line << ",\"passed\":" << (report.passed ? "true" : "false");
+    line << ",\"elapsed_ms\":" << report.elapsedMs;
+    line << ",\"shrink_ms\":" << report.shrinkMs;
+    line << ",\"failure\":\"" << escape(report.failure) << "\"";
+    line << ",\"failed_args\":\"" << escape(report.failedArgs) << "\"";
+    line << ",\"log\":\"" << escape(report.log) << "\"";
+    line << ",\"shrink_steps\":[";
+    for (size_t i = 0; i < report.shrinkSteps.size(); i++) {
+        auto& step = report.shrinkSteps[i];
+        line << (i == 0 ? "" : ",") << "{\"arg\":" << step.argIndex << ",\"args\":\"" << escape(step.args)
+             << "\",\"failures\":\"" << escape(step.failures) << "\",\"size_before\":" << step.sizeBefore
+             << ",\"size_after\":" << step.sizeAfter << "}";
+    }
+    line << "]";
+    line << ",\"counterexample\":\"" << escape(report.counterexample) << "\"";
+    line << ",\"tags\":{";
+    bool firstKey = true;
+    for (auto& tagKV : report.tags) {
+        line << (firstKey ? "" : ",") << "\"" << escape(tagKV.first) << "\":{";
+        firstKey = false;
+        bool firstValue = true;
+        for (auto& valueKV : tagKV.second) {
+            line << (firstValue ? "" : ",") << "\"" << escape(valueKV.first) << "\":" << valueKV.second;
+            firstValue = false;
+        }
+        line << "}";
+    }
+    line << "}";
+    if (util::Instrumentation::isEnabled()) {
+        static const char* phaseNames[InstrumentationReport::NumPhases] = {"generation", "execution", "shrinking"};
+        line << ",\"instrumentation\":{";
+        for (int i = 0; i < InstrumentationReport::NumPhases; i++) {
+            auto& counters = report.instrumentation.phases[i];
+            line << (i == 0 ? "" : ",") << "\"" << phaseNames[i] << "\":{\"allocations\":" << counters.allocations
+                 << ",\"allocated_bytes\":" << counters.allocatedBytes << ",\"shrinkables\":" << counters.shrinkables
+                 << ",\"stream_tails\":" << counters.streamTails << ",\"invocations\":" << counters.invocations
+                 << "}";
+        }
+        line << "}";
+    }
+    line << "}";
+    // a line is written at once, so that reports from concurrent tests are not interleaved within a line
+    std::lock_guard<std::mutex> guard(getOutputMutex());
+    os << line.str() << endl;
+}
+
+string JsonLinesReporter::escape(const string& str)
+{
+    static const char* hexDigits = "0123456789abcdef";
+    string escaped;
+    escaped.reserve(str.size());
+    for (size_t pos = 0; pos < str.size(); pos++) {
+        const char c = str[pos];
+        switch (c) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    escaped += "\\u00";
+                    escaped += hexDigits[(c >> 4) & 0xf];
+                    escaped += hexDigits[c & 0xf];
+                } else if (static_cast<unsigned char>(c) < 0x80) {
+                    escaped += c;
+                } else if (size_t length = validUTF8Length(str, pos)) {
+                    escaped.append(str, pos, length);
+                    pos += length - 1;
+                } else {
+                    // a byte of a non-UTF-8 string is kept as the code point of the same value, so the line stays valid
+                    escaped += "\\u00";
+                    escaped += hexDigits[(c >> 4) & 0xf];
+                    escaped += hexDigits[c & 0xf];
+                }
+        }
+    }
+    return escaped;
+}
+
+MultiReporter::MultiReporter(const vector<shared_ptr<Reporter>>& _reporters) : reporters(_reporters) {}
+
+void MultiReporter::onStart(const PropertyReport& report)
+{
+    for (auto& reporter : reporters)
+        reporter->onStart(report);
+}
+
+void MultiReporter::onLog(const PropertyReport& report, const string& log)
+{
+    for (auto& reporter : reporters)
+        reporter->onLog(report, log);
+}
+
+void MultiReporter::onFailure(const PropertyReport& report)
+{
+    for (auto& reporter : reporters)
+        reporter->onFailure(report);
+}
+
+void MultiReporter::onShrinkStep(const PropertyReport& report, const ShrinkStep& step)
+{
+    for (auto& reporter : reporters)
+        reporter->onShrinkStep(report, step);
+}
+
+void MultiReporter::onEnd(const PropertyReport& report)
+{
+    for (auto& reporter : reporters)
+        reporter->onEnd(report);
+}
+
+}  // namespace proptest
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "api.hpp"
+#include "util/instrumentation.hpp"
+#include "util/std.hpp"
+
+/**
+ * @file Reporter.hpp
+ * @brief Pluggable reporters of property test progress and results
+ */
+
+namespace proptest {
+
+/**
+ * @brief Amount of console output, set with `PropertyBase::setVerbosity` or environment variable `PROPTEST_VERBOSITY`
+ */
+enum class Verbosity {
+    Quiet = 0,    // only failed tests are printed
+    Normal = 1,   // seeds, results and tag summaries of all tests (default)
+    Verbose = 2,  // additionally, diagnostic logs of passed runs (e.g. interleavings of concurrent actions)
+};
+
+/**
+ * @brief A step of shrinking that found a simpler failing input
+ */
+struct PROPTEST_API ShrinkStep
+{
+    ShrinkStep(int _argIndex, const string& _args, const string& _failures, int64_t _sizeBefore = -1,
+               int64_t _sizeAfter = -1)
+        : argIndex(_argIndex), args(_args), failures(_failures), sizeBefore(_sizeBefore), sizeAfter(_sizeAfter)
+    {
+    }
+
+    int argIndex;        // index of the shrunk argument
+    string args;         // all arguments after this step, or the change of size of the shrunk argument (if it has one)
+    string failures;     // failed expectations of this step, if any
+    int64_t sizeBefore;  // size of the shrunk argument before this step (-1 if it has no size)
+    int64_t sizeAfter;   // size of the shrunk argument after this step (-1 if it has no size)
+};
+
+/**
+ * @brief Progress and result of a property test, filled in as the test proceeds
+ */
+struct PROPTEST_API PropertyReport
+{
+    PropertyReport();
+
+    string name;  // optional name given with `setName`
+    uint64_t seed;
+    uint32_t numRuns;  // configured number of runs
+    uint32_t runs;     // completed runs, including the failed one
+    uint32_t discards;
+    bool passed;
+    double elapsedMs;  // total time, including shrinking
+    double shrinkMs;
+
+    string failure;     // failure message of the failed run (may be empty, e.g. if the property returned false)
+    string failedArgs;  // arguments of the failed run (empty if not available)
+    string log;         // diagnostic log of the failed run, e.g. interleaving of concurrent actions (may be empty)
+    vector<ShrinkStep> shrinkSteps;
+    string counterexample;  // simplest arguments found by shrinking (empty if not available)
+
+    map<string, map<string, size_t>> tags;  // key -> (value -> count)
+    InstrumentationReport instrumentation;
+};
+
+/**
+ * @brief Receives progress and results of property tests
+ * @details Methods are called in order of `onStart`, `onLog` (for passed runs with a diagnostic log, only if verbosity is
+ * `Verbose`), `onFailure` (if a run fails), `onShrinkStep` (for each simpler failing input found) and `onEnd`. Default
+ * implementations do nothing.
+ */
+class PROPTEST_API Reporter {
+public:
+    virtual ~Reporter();
+
+    /// `name`, `seed` and `numRuns` are available
+    virtual void onStart(const PropertyReport& report);
+    virtual void onLog(const PropertyReport& report, const string& log);
+    /// `runs`, `failure`, `failedArgs` and `log` are available
+    virtual void onFailure(const PropertyReport& report);
+    virtual void onShrinkStep(const PropertyReport& report, const ShrinkStep& step);
+    /// all fields are available
+    virtual void onEnd(const PropertyReport& report);
+};
+
+/**
+ * @brief Human-readable progress and results written to console (the default reporter)
+ * @details Output of a test is buffered and written at once when a run fails or the test ends, depending on the current
+ * `Verbosity`. Failure messages are written to the error stream, everything else to the output stream. Buffers are kept
+ * per thread, so that tests running in parallel do not mix their output.
+ */
+class PROPTEST_API ConsoleReporter : public Reporter {
+public:
+    ConsoleReporter();
+    ConsoleReporter(ostream& out, ostream& err);
+
+    void onStart(const PropertyReport& report) override;
+    void onLog(const PropertyReport& report, const string& log) override;
+    void onFailure(const PropertyReport& report) override;
+    void onShrinkStep(const PropertyReport& report, const ShrinkStep& step) override;
+    void onEnd(const PropertyReport& report) override;
+
+    static void printTags(ostream& os, const map<string, map<string, size_t>>& tags);
+    static void printInstrumentation(ostream& os, const InstrumentationReport& instrumentation);
+
+private:
+    stringstream& buffer();
+    void flush();
+
+    ostream& out;
+    ostream& err;
+};
+
+/**
+ * @brief Writes one JSON object per property test in a line, when the test ends
+ * @details Fields: `name`, `seed`, `num_runs`, `runs`, `discards`, `passed`, `elapsed_ms`, `shrink_ms`, `failure`,
+ * `failed_args`, `log`, `shrink_steps` (array of `{"arg", "args", "failures", "size_before", "size_after"}`),
+ * `counterexample`, `tags` (object of value-count objects), and `instrumentation` (if enabled)
+ */
+class PROPTEST_API JsonLinesReporter : public Reporter {
+public:
+    /// writes to given stream, which should outlive the reporter
+    explicit JsonLinesReporter(ostream& os);
+    /// appends to given file
+    explicit JsonLinesReporter(const string& path);
+
+    void onEnd(const PropertyReport& report) override;
+
+    /// escapes a string for a JSON string literal, escaping bytes that are not part of valid UTF-8 as `\u00XX`
+    static string escape(const string& str);
+
+private:
+    shared_ptr<ostream> fileStream;
+    ostream& os;
+};
+
+/**
+ * @brief Forwards to multiple reporters, in order
+ */
+class PROPTEST_API MultiReporter : public Reporter {
+public:
+    explicit MultiReporter(const vector<shared_ptr<Reporter>>& reporters);
+
+    void onStart(const PropertyReport& report) override;
+    void onLog(const PropertyReport& report, const string& log) override;
+    void onFailure(const PropertyReport& report) override;
+    void onShrinkStep(const PropertyReport& report, const ShrinkStep& step) override;
+    void onEnd(const PropertyReport& report) override;
+
+private:
+    vector<shared_ptr<Reporter>> reporters;
+};
+
+}  // namespace proptest
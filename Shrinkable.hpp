@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Stream.hpp"
+#include "util/instrumentation.hpp"
 #include "util/std.hpp"
 
 namespace proptest {
@@ -15,7 +16,11 @@ struct Shrinkable
 {
     using type = T;
 
-    Shrinkable(shared_ptr<T> p) : ptr(p) { shrinksPtr = emptyPtr(); }
+    Shrinkable(shared_ptr<T> p) : ptr(p)
+    {
+        shrinksPtr = emptyPtr();
+        PROPTEST_INSTRUMENT(countShrinkable());
+    }
     Shrinkable(const Shrinkable& other) : ptr(other.ptr), shrinksPtr(other.shrinksPtr) {}
 
     Shrinkable& operator=(const Shrinkable& other)
@@ -258,6 +263,7 @@ private:
 
     Shrinkable(shared_ptr<T> p, shared_ptr<function<Stream<Shrinkable<T>>()>> s) : ptr(p), shrinksPtr(s)
     {
+        PROPTEST_INSTRUMENT(countShrinkable());
     }
 
     shared_ptr<function<Stream<Shrinkable<T>>()>> emptyPtr()
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "util/instrumentation.hpp"
 #include "util/std.hpp"
 
 namespace proptest {
@@ -66,6 +67,8 @@ struct Stream
         if (isEmpty())
             return Stream();
 
+        // counted only here: the tails of wrapping streams (transform, concat, take) force the wrapped tails directly
+        PROPTEST_INSTRUMENT(countStreamTail());
         return Stream((*tailGen)());
     }
 
@@ -118,8 +121,9 @@ struct Stream
         if (isEmpty())
             return other;
         else {
-            return Stream<T>(headPtr,
-                             [tailGen = this->tailGen, other]() { return Stream((*tailGen)()).concat(other); });
+            return Stream<T>(headPtr, [tailGen = this->tailGen, other]() {
+                return Stream((*tailGen)()).concat(other);
+            });
         }
     }
 
@@ -132,7 +136,7 @@ struct Stream
             if (n == 0)
                 return Stream::empty();
 
-            return Stream(headPtr, [self, n]() { return Stream<T>(self.tail()).take(n - 1); });
+            return Stream(headPtr, [self, n]() { return Stream<T>((*self.tailGen)()).take(n - 1); });
         }
     }
 
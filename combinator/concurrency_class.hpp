@@ -1,13 +1,16 @@
 #pragma once
 
 #include "stateful_class.hpp"
+#include "concurrency_shrink.hpp"
 #include "../gen.hpp"
 #include "../Random.hpp"
 #include "../Shrinkable.hpp"
 #include "../api.hpp"
 #include "../PropertyContext.hpp"
+#include "../PropertyBase.hpp"
 #include "../GenBase.hpp"
 #include "../util/std.hpp"
+#include "../util/workerpool.hpp"
 #include <thread>
 #include <mutex>
 #include <atomic>
@@ -38,12 +41,17 @@ public:
     using ActionListGen = GenFunction<ActionList>;
 
     static constexpr uint32_t defaultNumRuns = 200;
+    static constexpr int defaultShrinkAttempts = 4;
+    static constexpr int defaultShrinkBudget = 1000;
 
     Concurrency(shared_ptr<ObjectTypeGen> _initialGenPtr, shared_ptr<ActionListGen> _actionListGenPtr)
         : initialGenPtr(_initialGenPtr),
           actionListGenPtr(_actionListGenPtr),
           seed(getCurrentTime()),
-          numRuns(defaultNumRuns)
+          numRuns(defaultNumRuns),
+          growingSize(true),
+          shrinkAttempts(defaultShrinkAttempts),
+          shrinkBudget(defaultShrinkBudget)
     {
     }
 
@@ -53,7 +61,10 @@ public:
           modelFactoryPtr(_modelFactoryPtr),
           actionListGenPtr(_actionListGenPtr),
           seed(getCurrentTime()),
-          numRuns(defaultNumRuns)
+          numRuns(defaultNumRuns),
+          growingSize(true),
+          shrinkAttempts(defaultShrinkAttempts),
+          shrinkBudget(defaultShrinkBudget)
     {
     }
 
@@ -61,7 +72,11 @@ public:
     bool go(function<void(ObjectType&, ModelType&)> postCheck);
     bool go(function<void(ObjectType&)> postCheck);
     bool invoke(Random& rand, function<void(ObjectType&, ModelType&)> postCheck);
-    void handleShrink(Random& savedRand);
+    // shrinks the action lists of the failed run generated from savedRand, and reports the steps and the result
+    void handleShrink(Random& savedRand, function<void(ObjectType&, ModelType&)> postCheck, PropertyReport& report,
+                      Reporter& rep);
+    // rendered interleaving of the last run, if it failed or verbosity is `Verbose`
+    const string& getRunLog() const { return runLog; }
 
     Concurrency& setSeed(uint64_t s)
     {
@@ -75,12 +90,76 @@ public:
         return *this;
     }
 
+    // grows size ranges of generated action lists over the runs (enabled by default)
+    Concurrency& setGrowingSize(bool enable)
+    {
+        growingSize = enable;
+        return *this;
+    }
+
+    // name used in reports
+    Concurrency& setName(const string& n)
+    {
+        name = n;
+        return *this;
+    }
+
+    // overrides PropertyBase::getDefaultReporter()
+    Concurrency& setReporter(shared_ptr<Reporter> r)
+    {
+        reporter = r;
+        return *this;
+    }
+
+    // number of times a shrunk candidate is run to reproduce the failure (4 by default)
+    Concurrency& setShrinkAttempts(int attempts)
+    {
+        shrinkAttempts = attempts > 0 ? attempts : 1;
+        return *this;
+    }
+
+    // maximum number of shrunk candidates tried after a failure (1000 by default)
+    Concurrency& setShrinkBudget(int candidates)
+    {
+        shrinkBudget = candidates;
+        return *this;
+    }
+
 private:
     shared_ptr<ObjectTypeGen> initialGenPtr;
     shared_ptr<ModelTypeGen> modelFactoryPtr;
     shared_ptr<ActionListGen> actionListGenPtr;
     uint64_t seed;
     int numRuns;
+    bool growingSize;
+    int shrinkAttempts;
+    int shrinkBudget;
+    string name;
+    shared_ptr<Reporter> reporter;
+    // order of rear action completions by thread id, reused across runs
+    vector<int> interleaving;
+    // the two rear threads, created by the first run of a test and reused by the following runs
+    shared_ptr<util::WorkerPool> workerPool;
+    // positions in the interleaving of the action completions of each rear thread
+    vector<int> rearLogs[2];
+    string runLog;
+    // copy of the object at the start of the last run, for shrinking to rerun from (if the object can be copied)
+    shared_ptr<ObjectType> startObject;
+
+    // runs the front and the two rear action lists on obj, rendering the interleaving into runLog if the run fails
+    bool runActions(ObjectType& obj, const vector<Shrinkable<ActionList>>& lists,
+                    function<void(ObjectType&, ModelType&)> postCheck);
+    // whether running given lists on the object of the failed run fails in any of the attempts
+    bool reproduce(Random& savedRand, const vector<Shrinkable<ActionList>>& lists,
+                   function<void(ObjectType&, ModelType&)> postCheck, string& failure);
+
+    void saveStartObject(const ObjectType& obj, true_type) { startObject = util::make_shared<ObjectType>(obj); }
+    void saveStartObject(const ObjectType&, false_type) {}
+    // the object at the start of the failed run, copied from startObject, or generated anew if it cannot be copied
+    Shrinkable<ObjectType> restartObject(Random& savedRand, true_type);
+    Shrinkable<ObjectType> restartObject(Random& savedRand, false_type);
+
+    string renderInterleaving(int count) const;
 };
 
 template <typename ActionType>
@@ -100,45 +179,74 @@ bool Concurrency<ActionType>::go(function<void(ObjectType&)> postCheck)
 template <typename ActionType>
 bool Concurrency<ActionType>::go(function<void(ObjectType&, ModelType&)> postCheck)
 {
+    using clock = std::chrono::steady_clock;
+    Reporter& rep = reporter ? *reporter : *PropertyBase::getDefaultReporter();
+    PropertyReport report;
+    report.name = name;
+    report.seed = seed;
+    report.numRuns = numRuns;
+    auto start = clock::now();
+    rep.onStart(report);
+    // collects expectations and tags of the front, the rear threads and the post-check
+    PropertyContext ctx;
     Random rand(seed);
     Random savedRand(seed);
-    cout << "random seed: " << seed << endl;
     int i = 0;
+
+    auto finish = [&]() {
+        workerPool.reset();
+        report.tags = ctx.getTagCounts();
+        report.elapsedMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        rep.onEnd(report);
+        return report.passed;
+    };
+
+    auto falsify = [&](const string& failure) {
+        report.runs = i + 1;
+        report.failure = failure;
+        report.log = runLog;
+        rep.onFailure(report);
+        // shrink
+        handleShrink(savedRand, postCheck, report, rep);
+        return finish();
+    };
+
     try {
         for (; i < numRuns; i++) {
             bool pass = true;
             do {
                 pass = true;
                 try {
+                    if (growingSize)
+                        rand.setSizeFactor(i + 1, numRuns);
                     savedRand = rand;
                     invoke(rand, postCheck);
+                    // failed expectations
+                    if (ctx.hasFailures())
+                        return falsify(ctx.flushFailures().str());
+                    if (!runLog.empty())
+                        rep.onLog(report, runLog);
                     pass = true;
                 } catch (const Success&) {
                     pass = true;
                 } catch (const Discard&) {
                     // silently discard combination
+                    report.discards++;
                     pass = false;
                 }
             } while (!pass);
         }
+    } catch (const AssertFailed& e) {
+        return falsify(string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")");
     } catch (const PropertyFailedBase& e) {
-        cerr << "Falsifiable, after " << (i + 1) << " tests: " << e.what() << " (" << e.filename << ":" << e.lineno
-                  << ")" << endl;
-
-        // shrink
-        handleShrink(savedRand);
-        return false;
+        return falsify(string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")");
     } catch (const exception& e) {
-        cerr << "Falsifiable, after " << (i + 1) << " tests - exception occurred: " << e.what() << endl;
-        cerr << "    seed: " << seed << endl;
-        // shrink
-        handleShrink(savedRand);
-        return false;
+        return falsify(string("exception occurred: ") + e.what());
     }
 
-    cout << "OK, passed " << numRuns << " tests" << endl;
-
-    return true;
+    report.runs = numRuns;
+    report.passed = true;
+    return finish();
 }
 
 template <typename ActionType>
@@ -148,97 +256,210 @@ struct RearRunner
     using ModelType = typename ActionType::ModelType;
     using ActionList = list<shared_ptr<ActionType>>;
 
-    RearRunner(int _n, ObjectType& _obj, ModelType& _model, ActionList& _actions, atomic_bool& _thread_ready,
-               atomic_bool& _sync_ready, vector<int>& _log, atomic_int& _counter)
-        : n(_n),
-          obj(_obj),
+    RearRunner(ObjectType& _obj, ModelType& _model, ActionList& _actions, vector<int>& _log, atomic_int& _counter,
+               PropertyContext* _parentContext, std::exception_ptr& _error)
+        : obj(_obj),
           model(_model),
           actions(_actions),
-          thread_ready(_thread_ready),
-          sync_ready(_sync_ready),
           log(_log),
-          counter(_counter)
+          counter(_counter),
+          parentContext(_parentContext),
+          error(_error)
     {
     }
 
     void operator()()
     {
-        thread_ready = true;
-        while (!sync_ready) {}
-
-        for (auto action : actions) {
-            if (!action->precondition(obj, model))
-                continue;
-            PROP_ASSERT(action->run(obj, model));
-            // cout << "rear2" << endl;
-            log[counter++] = n;
+        // expectations and tags of this thread are merged into the parent context when the runner finishes
+        unique_ptr<PropertyContext> context;
+        if (parentContext)
+            context.reset(new PropertyContext(*parentContext));
+
+        // the thread's own log takes positions in the interleaving, to be merged by the invoking thread
+        size_t numEvents = 0;
+        try {
+            for (auto action : actions) {
+                if (!action->precondition(obj, model))
+                    continue;
+                PROP_ASSERT(action->run(obj, model));
+                log[numEvents++] = counter++;
+            }
+        } catch (...) {
+            // rethrown on the invoking thread
+            error = std::current_exception();
         }
+        log.resize(numEvents);
     }
 
-    int n;
     ObjectType& obj;
     ModelType& model;
     ActionList& actions;
-    atomic_bool& thread_ready;
-    atomic_bool& sync_ready;
     vector<int>& log;
     atomic_int& counter;
+    PropertyContext* parentContext;
+    std::exception_ptr& error;
 };
 
 template <typename ActionType>
 bool Concurrency<ActionType>::invoke(Random& rand, function<void(ObjectType&, ModelType&)> postCheck)
 {
     Shrinkable<ObjectType> initialShr = (*initialGenPtr)(rand);
-    ObjectType& obj = initialShr.getRef();
+    // front, rear1 and rear2
+    vector<Shrinkable<ActionList>> lists;
+    for (int i = 0; i < 3; i++)
+        lists.push_back((*actionListGenPtr)(rand));
+    // the object may be shared between runs (e.g. by `just`), so its state is kept before the run modifies it
+    if (shrinkBudget > 0)
+        saveStartObject(initialShr.getRef(), std::is_copy_constructible<ObjectType>());
+    return runActions(initialShr.getRef(), lists, postCheck);
+}
+
+template <typename ActionType>
+bool Concurrency<ActionType>::runActions(ObjectType& obj, const vector<Shrinkable<ActionList>>& lists,
+                                         function<void(ObjectType&, ModelType&)> postCheck)
+{
     ModelType model = modelFactoryPtr ? (*modelFactoryPtr)(obj) : ModelType();
-    Shrinkable<ActionList> frontShr = (*actionListGenPtr)(rand);
-    Shrinkable<ActionList> rear1Shr = (*actionListGenPtr)(rand);
-    Shrinkable<ActionList> rear2Shr = (*actionListGenPtr)(rand);
-    ActionList& front = frontShr.getRef();
-    ActionList& rear1 = rear1Shr.getRef();
-    ActionList& rear2 = rear2Shr.getRef();
-
-    // front
-    for (auto action : front) {
-        if (action->precondition(obj, model))
-            PROP_ASSERT(action->run(obj, model));
-    }
+    ActionList& front = lists[0].getRef();
+    ActionList& rear1 = lists[1].getRef();
+    ActionList& rear2 = lists[2].getRef();
 
-    // rear
-    thread spawner([&]() {
-        atomic_bool thread1_ready(false);
-        atomic_bool thread2_ready(false);
-        atomic_bool sync_ready(false);
-        atomic<int> counter{0};
-        vector<int> log;
-        log.resize(5000);
+    runLog.clear();
+    interleaving.assign(rear1.size() + rear2.size(), 0);
+    atomic<int> counter{0};
+    // context of the calling thread, for the rear threads to merge into
+    PropertyContext* parentContext = PropertyBase::getContext();
 
-        thread rearRunner1(RearRunner<ActionType>(1, obj, model, rear1, thread1_ready, sync_ready, log, counter));
-        thread rearRunner2(RearRunner<ActionType>(2, obj, model, rear2, thread2_ready, sync_ready, log, counter));
-        while (!thread1_ready) {}
-        while (!thread2_ready) {}
+    try {
+        // front
+        for (auto action : front) {
+            if (action->precondition(obj, model))
+                PROP_ASSERT(action->run(obj, model));
+        }
 
-        sync_ready = true;
+        // rear
+        if (!workerPool)
+            workerPool = util::make_shared<util::WorkerPool>(2);
+        rearLogs[0].assign(rear1.size(), 0);
+        rearLogs[1].assign(rear2.size(), 0);
+        std::exception_ptr errors[2];
+        ActionList* rears[2] = {&rear1, &rear2};
+        workerPool->run([&](int i) {
+            RearRunner<ActionType>(obj, model, *rears[i], rearLogs[i], counter, parentContext, errors[i])();
+        });
+
+        // thread ids are 0 and 1, as in the counterexample
+        for (int i = 0; i < 2; i++) {
+            for (int pos : rearLogs[i])
+                interleaving[pos] = i;
+        }
+        for (auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+        postCheck(obj, model);
+    } catch (...) {
+        runLog = renderInterleaving(counter);
+        throw;
+    }
 
-        rearRunner1.join();
-        rearRunner2.join();
+    if (PropertyBase::getVerbosity() >= Verbosity::Verbose || (parentContext && parentContext->hasFailures()))
+        runLog = renderInterleaving(counter);
+    return true;
+}
 
-        cout << "count: " << counter << ", order: ";
-        for (int i = 0; i < counter; i++) {
-            cout << log[i];
+template <typename ActionType>
+string Concurrency<ActionType>::renderInterleaving(int count) const
+{
+    stringstream str;
+    str << "count: " << count << ", order: ";
+    for (int i = 0; i < count; i++)
+        str << (i == 0 ? "" : " ") << "thr" << interleaving[i];
+    return str.str();
+}
+
+template <typename ActionType>
+bool Concurrency<ActionType>::reproduce(Random& savedRand, const vector<Shrinkable<ActionList>>& lists,
+                                        function<void(ObjectType&, ModelType&)> postCheck, string& failure)
+{
+    for (int attempt = 0; attempt < shrinkAttempts; attempt++) {
+        // each attempt starts from the object of the failed run, as runs modify it
+        Shrinkable<ObjectType> initialShr = restartObject(savedRand, std::is_copy_constructible<ObjectType>());
+        // collects failed expectations of this attempt only
+        PropertyContext context;
+        try {
+            runActions(initialShr.getRef(), lists, postCheck);
+            if (context.hasFailures()) {
+                failure = context.flushFailures().str();
+                return true;
+            }
+        } catch (const Success&) {
+        } catch (const Discard&) {
+        } catch (const AssertFailed& e) {
+            failure = string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")";
+            return true;
+        } catch (const PropertyFailedBase& e) {
+            failure = string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")";
+            return true;
+        } catch (const exception& e) {
+            failure = string("exception occurred: ") + e.what();
+            return true;
         }
-        cout << endl;
-    });
+    }
+    return false;
+}
 
-    spawner.join();
-    postCheck(obj, model);
+template <typename ActionType>
+Shrinkable<typename ActionType::ObjectType> Concurrency<ActionType>::restartObject(Random& savedRand, true_type)
+{
+    if (!startObject)
+        return restartObject(savedRand, false_type());
+    return make_shrinkable<ObjectType>(*startObject);
+}
 
-    return true;
+template <typename ActionType>
+Shrinkable<typename ActionType::ObjectType> Concurrency<ActionType>::restartObject(Random& savedRand, false_type)
+{
+    Random rand = savedRand;
+    return (*initialGenPtr)(rand);
 }
 
 template <typename ActionType>
-void Concurrency<ActionType>::handleShrink(Random&)
+void Concurrency<ActionType>::handleShrink(Random& savedRand, function<void(ObjectType&, ModelType&)> postCheck,
+                                           PropertyReport& report, Reporter& rep)
 {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    // regenerate the action lists of the failed run
+    Random rand = savedRand;
+    (*initialGenPtr)(rand);
+    vector<Shrinkable<ActionList>> lists;
+    for (int i = 0; i < 3; i++)
+        lists.push_back((*actionListGenPtr)(rand));
+
+    string failure;
+    string shrunkLog;
+    auto fails = [&](const vector<Shrinkable<ActionList>>& candidate) {
+        if (!reproduce(savedRand, candidate, postCheck, failure))
+            return false;
+        shrunkLog = runLog;
+        return true;
+    };
+    auto onStep = [&](size_t index, const string& change, int64_t sizeBefore, int64_t sizeAfter) {
+        report.shrinkSteps.emplace_back(static_cast<int>(index), change, failure, sizeBefore, sizeAfter);
+        rep.onShrinkStep(report, report.shrinkSteps.back());
+    };
+    // there are always two rear threads
+    lists = shrinkActionLists<ActionList>(lists, 2, shrinkBudget, fails, onStep);
+
+    if (!report.shrinkSteps.empty()) {
+        stringstream counterexample;
+        counterexample << "front: size " << lists[0].getRef().size() << ", thr0: size " << lists[1].getRef().size()
+                       << ", thr1: size " << lists[2].getRef().size();
+        if (!shrunkLog.empty())
+            counterexample << "; " << shrunkLog;
+        report.counterexample = counterexample.str();
+    }
+    report.shrinkMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
 }
 
 template <typename ActionType, typename InitialGen, typename ActionListGen>
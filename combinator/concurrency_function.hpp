@@ -1,13 +1,18 @@
 #pragma once
 
 #include "stateful_function.hpp"
+#include "linearizability.hpp"
+#include "concurrency_shrink.hpp"
 #include "../gen.hpp"
 #include "../Random.hpp"
 #include "../Shrinkable.hpp"
 #include "../api.hpp"
 #include "../PropertyContext.hpp"
+#include "../PropertyBase.hpp"
 #include "../GenBase.hpp"
 #include "../util/std.hpp"
+#include "../util/workerpool.hpp"
+#include "../util/scheduler.hpp"
 #include <thread>
 #include <atomic>
 
@@ -37,13 +42,18 @@ public:
 
     static constexpr uint32_t defaultNumRuns = 200;
     static constexpr int defaultNumThreads = 2;
+    static constexpr int defaultShrinkAttempts = 4;
+    static constexpr int defaultShrinkBudget = 1000;
 
     Concurrency(shared_ptr<ObjectTypeGen> _initialGenPtr, shared_ptr<ActionGen> _actionGenPtr)
         : initialGenPtr(_initialGenPtr),
           actionGenPtr(_actionGenPtr),
           seed(getCurrentTime()),
           numRuns(defaultNumRuns),
-          numThreads(defaultNumThreads)
+          numThreads(defaultNumThreads),
+          growingSize(true),
+          shrinkAttempts(defaultShrinkAttempts),
+          shrinkBudget(defaultShrinkBudget)
     {
     }
 
@@ -54,7 +64,10 @@ public:
           actionGenPtr(_actionGenPtr),
           seed(getCurrentTime()),
           numRuns(defaultNumRuns),
-          numThreads(defaultNumThreads)
+          numThreads(defaultNumThreads),
+          growingSize(true),
+          shrinkAttempts(defaultShrinkAttempts),
+          shrinkBudget(defaultShrinkBudget)
     {
     }
 
@@ -75,13 +88,16 @@ public:
 
     Concurrency& setPostCheck(function<void(ObjectType&)> postCheck)  {
         function<void(ObjectType&,ModelType&)>  fullPostCheck = [postCheck](ObjectType& sys, ModelType&) { postCheck(sys); };
-        postCheckPtr = util::make_shared(fullPostCheck);
+        postCheckPtr = util::make_shared<function<void(ObjectType&, ModelType&)>>(fullPostCheck);
         return *this;
     }
 
     bool go();
     bool invoke(Random& rand);
-    void handleShrink(Random& savedRand);
+    // shrinks the action lists of the failed run generated from savedRand, and reports the steps and the result
+    void handleShrink(Random& savedRand, PropertyReport& report, Reporter& rep);
+    // rendered interleaving of the last run, if it failed or verbosity is `Verbose`
+    const string& getRunLog() const { return runLog; }
 
     Concurrency& setSeed(uint64_t s)
     {
@@ -95,12 +111,58 @@ public:
         return *this;
     }
 
+    // grows size ranges of generated action lists over the runs (enabled by default)
+    Concurrency& setGrowingSize(bool enable)
+    {
+        growingSize = enable;
+        return *this;
+    }
+
+    // name used in reports
+    Concurrency& setName(const string& n)
+    {
+        name = n;
+        return *this;
+    }
+
+    // overrides PropertyBase::getDefaultReporter()
+    Concurrency& setReporter(shared_ptr<Reporter> r)
+    {
+        reporter = r;
+        return *this;
+    }
+
     Concurrency& setMaxConcurrency(uint32_t numThr)
     {
         numThreads = numThr;
         return *this;
     }
 
+    // runs the rear threads one at a time, switching between them before each action and at calls to
+    // proptest::yield(), in an order drawn from the seed of the run (see util::Scheduler)
+    Concurrency& setScheduling(util::Scheduler::Policy policy, int depth = 3)
+    {
+        scheduled = true;
+        schedulePolicy = policy;
+        scheduleDepth = depth;
+        return *this;
+    }
+
+    // number of times a shrunk candidate is run to reproduce the failure (4 by default). scheduled runs are retried
+    // under other schedules
+    Concurrency& setShrinkAttempts(int attempts)
+    {
+        shrinkAttempts = attempts > 0 ? attempts : 1;
+        return *this;
+    }
+
+    // maximum number of shrunk candidates tried after a failure (1000 by default)
+    Concurrency& setShrinkBudget(int candidates)
+    {
+        shrinkBudget = candidates;
+        return *this;
+    }
+
 private:
     shared_ptr<ObjectTypeGen> initialGenPtr;
     shared_ptr<ModelTypeGen> modelFactoryPtr;
@@ -111,54 +173,128 @@ private:
     uint64_t seed;
     int numRuns;
     int numThreads;
+    bool growingSize;
+    // whether the rear threads are run by a util::Scheduler instead of the OS scheduler
+    bool scheduled = false;
+    util::Scheduler::Policy schedulePolicy = util::Scheduler::Policy::PCT;
+    int scheduleDepth = 3;
+    int shrinkAttempts;
+    int shrinkBudget;
+    string name;
+    shared_ptr<Reporter> reporter;
+    // order of action starts/ends by thread id, reused across runs
+    vector<int> interleaving;
+    // rear threads, created by the first run of a test and reused by the following runs
+    shared_ptr<util::WorkerPool> workerPool;
+    // positions in the interleaving of the action starts/ends of each rear thread
+    vector<vector<int>> rearLogs;
+    // observations of operations, in order of the actions of the front and each rear thread
+    vector<Observation<ModelType>> frontObservations;
+    vector<vector<Observation<ModelType>>> rearObservations;
+    LinearizabilityChecker<ModelType> checker;
+    string runLog;
+    // copy of the object at the start of the last run, for shrinking to rerun from (if the object can be copied)
+    shared_ptr<ObjectType> startObject;
+
+    Shrinkable<ObjectType> generate(Random& rand, vector<Shrinkable<ActionList>>& lists, uint64_t& scheduleSeed);
+    // runs the front and rear action lists on obj, rendering the interleaving into runLog if the run fails
+    bool runActions(ObjectType& obj, ActionList& front, vector<Shrinkable<ActionList>>& rearShrs,
+                    uint64_t scheduleSeed);
+    // whether running given lists on the object of the failed run fails in any of the attempts
+    bool reproduce(Random& savedRand, const vector<Shrinkable<ActionList>>& lists, uint64_t scheduleSeed,
+                   string& failure);
+
+    void saveStartObject(const ObjectType& obj, true_type) { startObject = util::make_shared<ObjectType>(obj); }
+    void saveStartObject(const ObjectType&, false_type) {}
+    // the object at the start of the failed run, copied from startObject, or generated anew if it cannot be copied
+    Shrinkable<ObjectType> restartObject(Random& savedRand, true_type);
+    Shrinkable<ObjectType> restartObject(Random& savedRand, false_type);
+
+    // fails the run if the observations of operations are not those of a sequential order on the model
+    void checkLinearizability(const ModelType& initialModel, const ActionList& front,
+                              const vector<Shrinkable<ActionList>>& rearShrs, true_type);
+    void checkLinearizability(const ModelType&, const ActionList&, const vector<Shrinkable<ActionList>>&, false_type)
+    {
+    }
+
+    string renderInterleaving(const ActionList& front, const vector<Shrinkable<ActionList>>& rearShrs, int count) const;
 };
 
 template <typename ObjectType, typename ModelType>
 bool Concurrency<ObjectType, ModelType>::go()
 {
+    using clock = std::chrono::steady_clock;
+    Reporter& rep = reporter ? *reporter : *PropertyBase::getDefaultReporter();
+    PropertyReport report;
+    report.name = name;
+    report.seed = seed;
+    report.numRuns = numRuns;
+    auto start = clock::now();
+    rep.onStart(report);
+    // collects expectations and tags of the front, the rear threads and the post-check
+    PropertyContext ctx;
     Random rand(seed);
     Random savedRand(seed);
-    cout << "random seed: " << seed << endl;
     int i = 0;
+
+    auto finish = [&]() {
+        workerPool.reset();
+        report.tags = ctx.getTagCounts();
+        report.elapsedMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        rep.onEnd(report);
+        return report.passed;
+    };
+
+    auto falsify = [&](const string& failure) {
+        report.runs = i + 1;
+        report.failure = failure;
+        report.log = runLog;
+        rep.onFailure(report);
+        // shrink
+        handleShrink(savedRand, report, rep);
+        return finish();
+    };
+
     try {
         for (; i < numRuns; i++) {
             bool pass = true;
             do {
                 pass = true;
                 try {
+                    if (growingSize)
+                        rand.setSizeFactor(i + 1, numRuns);
                     savedRand = rand;
                     if(onStartupPtr)
                         (*onStartupPtr)();
                     if(invoke(rand) && onCleanupPtr)
                         (*onCleanupPtr)();
+                    // failed expectations
+                    if (ctx.hasFailures())
+                        return falsify(ctx.flushFailures().str());
+                    if (!runLog.empty())
+                        rep.onLog(report, runLog);
 
                     pass = true;
                 } catch (const Success&) {
                     pass = true;
                 } catch (const Discard&) {
                     // silently discard combination
+                    report.discards++;
                     pass = false;
                 }
             } while (!pass);
         }
+    } catch (const AssertFailed& e) {
+        return falsify(string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")");
     } catch (const PropertyFailedBase& e) {
-        cerr << "Falsifiable, after " << (i + 1) << " tests: " << e.what() << " (" << e.filename << ":" << e.lineno
-                  << ")" << endl;
-        cerr << "    seed: " << seed << endl;
-        // shrink
-        handleShrink(savedRand);
-        return false;
+        return falsify(string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")");
     } catch (const exception& e) {
-        cerr << "Falsifiable, after " << (i + 1) << " tests - exception occurred: " << e.what() << endl;
-        cerr << "    seed: " << seed << endl;
-        // shrink
-        handleShrink(savedRand);
-        return false;
+        return falsify(string("exception occurred: ") + e.what());
     }
 
-    cout << "OK, passed " << numRuns << " tests" << endl;
-
-    return true;
+    report.runs = numRuns;
+    report.passed = true;
+    return finish();
 }
 
 template <typename ObjectType, typename ModelType>
@@ -167,152 +303,346 @@ struct RearRunner
     using ActionType = Action<ObjectType,ModelType>;
     using ActionList = list<ActionType>;
 
-    RearRunner(int _num, ObjectType& _obj, ModelType& _model, ActionList& _actions, atomic_bool& _thread_ready,
-               atomic_bool& _sync_ready, vector<int>& _log, atomic_int& _counter)
+    RearRunner(int _num, ObjectType& _obj, ModelType& _model, ActionList& _actions, vector<int>& _log,
+               vector<Observation<ModelType>>& _observations, atomic_int& _counter, PropertyContext* _parentContext,
+               util::Scheduler* _scheduler, std::exception_ptr& _error)
         : num(_num),
           obj(_obj),
           model(_model),
           actions(_actions),
-          thread_ready(_thread_ready),
-          sync_ready(_sync_ready),
           log(_log),
-          counter(_counter)
+          observations(_observations),
+          counter(_counter),
+          parentContext(_parentContext),
+          scheduler(_scheduler),
+          error(_error)
     {
     }
 
     void operator()()
     {
-        thread_ready = true;
-        while (!sync_ready) {}
-
-        for (auto action : actions) {
-            log[counter++] = num; // start
-            action(obj, model);
-            // cout << "rear2" << endl;
-            log[counter++] = num; // end
+        // expectations and tags of this thread are merged into the parent context when the runner finishes
+        unique_ptr<PropertyContext> context;
+        if (parentContext)
+            context.reset(new PropertyContext(*parentContext));
+
+        // waits for the first turn, if scheduled
+        unique_ptr<util::Scheduler::Participant> participant;
+        if (scheduler)
+            participant.reset(new util::Scheduler::Participant(*scheduler, num));
+
+        // the thread's own log takes positions in the interleaving, to be merged by the invoking thread
+        size_t numEvents = 0;
+        Observation<ModelType>& observation = lastObservation<ModelType>();
+        try {
+            for (auto action : actions) {
+                if (scheduler)
+                    proptest::yield();
+                log[numEvents++] = counter++; // start
+                action(obj, model);
+                log[numEvents++] = counter++; // end
+                observations.push_back(util::move(observation));
+                observation = Observation<ModelType>();
+            }
+        } catch (...) {
+            // rethrown on the invoking thread
+            error = std::current_exception();
         }
+        log.resize(numEvents);
     }
 
     int num;
     ObjectType& obj;
     ModelType model;
     ActionList& actions;
-    atomic_bool& thread_ready;
-    atomic_bool& sync_ready;
     vector<int>& log;
+    vector<Observation<ModelType>>& observations;
     atomic_int& counter;
+    PropertyContext* parentContext;
+    util::Scheduler* scheduler;
+    std::exception_ptr& error;
 };
 
+template <typename ObjectType, typename ModelType>
+Shrinkable<ObjectType> Concurrency<ObjectType, ModelType>::generate(Random& rand, vector<Shrinkable<ActionList>>& lists,
+                                                                    uint64_t& scheduleSeed)
+{
+    Shrinkable<ObjectType> initialShr = (*initialGenPtr)(rand);
+    // front, then one list per rear thread
+    auto actionListGen = Arbi<list<Action<ObjectType,ModelType>>>(*actionGenPtr);
+    lists.clear();
+    for (int i = 0; i <= numThreads; i++) {
+        lists.push_back(actionListGen(rand));
+    }
+    // schedule of the rear threads is drawn from the run, to be replayed with the seed
+    scheduleSeed = scheduled && numThreads > 1 ? rand.getRandomUInt64() : 0;
+    return initialShr;
+}
+
 template <typename ObjectType, typename ModelType>
 bool Concurrency<ObjectType, ModelType>::invoke(Random& rand)
+{
+    vector<Shrinkable<ActionList>> lists;
+    uint64_t scheduleSeed;
+    Shrinkable<ObjectType> initialShr = generate(rand, lists, scheduleSeed);
+    // the object may be shared between runs (e.g. by `just`), so its state is kept before the run modifies it
+    if (shrinkBudget > 0)
+        saveStartObject(initialShr.getRef(), std::is_copy_constructible<ObjectType>());
+    vector<Shrinkable<ActionList>> rearShrs(lists.begin() + 1, lists.end());
+    return runActions(initialShr.getRef(), lists[0].getRef(), rearShrs, scheduleSeed);
+}
+
+template <typename ObjectType, typename ModelType>
+bool Concurrency<ObjectType, ModelType>::runActions(ObjectType& obj, ActionList& front,
+                                                    vector<Shrinkable<ActionList>>& rearShrs, uint64_t scheduleSeed)
 {
     constexpr int UNINITIALIZED_THREAD_ID = -2;
     constexpr int FRONT_THREAD_ID = -1;
-    Shrinkable<ObjectType> initialShr = (*initialGenPtr)(rand);
-
-    auto actionListGen = Arbi<list<Action<ObjectType,ModelType>>>(*actionGenPtr);
-    Shrinkable<ActionList> frontShr = actionListGen(rand);
-    vector<Shrinkable<ActionList>> rearShrs;
-    for (int i = 0; i < numThreads; i++) {
-        rearShrs.push_back(actionListGen(rand));
+    runLog.clear();
+    int numRear = static_cast<int>(rearShrs.size());
+
+    unique_ptr<util::Scheduler> scheduler;
+    if (scheduled && numRear > 1) {
+        int numSteps = 1;
+        for (auto& rearShr : rearShrs)
+            numSteps += static_cast<int>(rearShr.getRef().size());
+        scheduler.reset(new util::Scheduler(numRear, scheduleSeed, schedulePolicy, scheduleDepth, numSteps));
     }
 
-    ObjectType& obj = initialShr.getRef();
     ModelType model = modelFactoryPtr ? (*modelFactoryPtr)(obj) : ModelType();
-    ActionList& front = frontShr.getRef();
-
+    // operations are checked from the state of the model before the run
+    ModelType initialModel = model;
+
+    // preallocate the log for every action in front and start/end of every action in rear
+    size_t logSize = front.size();
+    for (int i = 0; i < numRear; i++)
+        logSize += rearShrs[i].getRef().size() * 2;
+    interleaving.assign(logSize, UNINITIALIZED_THREAD_ID);
     atomic<int> counter{0};
-    vector<int> log;
+    // context of the calling thread, for the rear threads to merge into
+    PropertyContext* parentContext = PropertyBase::getContext();
+    vector<std::exception_ptr> errors(numRear);
 
-    // run front
-    for (auto action : front) {
-        action(obj, model);
-        log.push_back(FRONT_THREAD_ID);
-        counter++;
-    }
+    try {
+        // run front
+        Observation<ModelType>& observation = lastObservation<ModelType>();
+        frontObservations.clear();
+        for (auto& observations : rearObservations)
+            observations.clear();
+        for (auto action : front) {
+            action(obj, model);
+            interleaving[counter++] = FRONT_THREAD_ID;
+            frontObservations.push_back(util::move(observation));
+            observation = Observation<ModelType>();
+        }
+
+        // run rear
+        if (numRear > 1) {
+            if (!workerPool || workerPool->size() != numRear)
+                workerPool = util::make_shared<util::WorkerPool>(numRear);
+            rearLogs.resize(numRear);
+            rearObservations.resize(numRear);
+            for (int i = 0; i < numRear; i++) {
+                rearLogs[i].assign(rearShrs[i].getRef().size() * 2, UNINITIALIZED_THREAD_ID);
+                rearObservations[i].reserve(rearShrs[i].getRef().size());
+            }
+
+            workerPool->run([&](int i) {
+                RearRunner<ObjectType, ModelType>(i, obj, model, rearShrs[i].getRef(), rearLogs[i],
+                                                  rearObservations[i], counter, parentContext, scheduler.get(),
+                                                  errors[i])();
+            });
+
+            for (int i = 0; i < numRear; i++) {
+                for (int pos : rearLogs[i])
+                    interleaving[pos] = i;
+            }
+
+            for (auto& error : errors) {
+                if (error)
+                    std::rethrow_exception(error);
+            }
+        }
+
+        checkLinearizability(initialModel, front, rearShrs, util::IsEqualityComparable<ModelType>());
 
-    // serial execution
-    if (numThreads <= 1) {
         if(postCheckPtr)
             (*postCheckPtr)(obj, model);
-        return true;
+    } catch (...) {
+        runLog = renderInterleaving(front, rearShrs, counter);
+        throw;
     }
 
-    // run rear
-    thread spawner([&]() {
-        atomic_bool sync_ready(false);
-        vector<shared_ptr<atomic_bool>> thread_ready;
-        vector<thread> rearRunners;
-        vector<ActionList> rears;
-
-        for (int i = 0; i < numThreads; i++) {
-            thread_ready.emplace_back(new atomic_bool(false));
-            auto& rear = rearShrs[i].getRef();
-            rears.emplace_back(rear);
-
-            // logging start/end of action
-            for(size_t j = 0; j < rear.size() * 2; j++)
-                log.push_back(UNINITIALIZED_THREAD_ID);
-        }
+    if (numRear > 1 && (PropertyBase::getVerbosity() >= Verbosity::Verbose ||
+                           (parentContext && parentContext->hasFailures())))
+        runLog = renderInterleaving(front, rearShrs, counter);
+    return true;
+}
 
-        // start threads
-        for(int i = 0; i < numThreads; i++) {
-            rearRunners.emplace_back(RearRunner<ObjectType, ModelType>(i, obj, model, rearShrs[i].getRef(),
-                                                                       *thread_ready[i], sync_ready, log, counter));
+template <typename ObjectType, typename ModelType>
+void Concurrency<ObjectType, ModelType>::checkLinearizability(const ModelType& initialModel, const ActionList& front,
+                                                              const vector<Shrinkable<ActionList>>& rearShrs,
+                                                              true_type)
+{
+    // the front runs alone, so its operations take effect in order
+    ModelType model = initialModel;
+    auto frontItr = front.begin();
+    for (size_t k = 0; k < frontObservations.size(); k++, ++frontItr) {
+        const Observation<ModelType>& observation = frontObservations[k];
+        if (observation.step && !observation.step(model)) {
+            stringstream str;
+            str << "front " << frontItr->name;
+            if (observation.show) {
+                str << " returning ";
+                observation.show(str);
+            }
+            str << " disagrees with the model";
+            throw AssertFailed(__FILE__, __LINE__, {}, str.str().c_str(), nullptr);
         }
+    }
 
-        for (int i = 0; i < numThreads; i++) {
-            while (!*thread_ready[i]) {}
+    // actions of the rear without observations are left out of the history
+    checker.clear();
+    for (size_t i = 0; i < rearObservations.size(); i++) {
+        auto rearItr = rearShrs[i].getRef().begin();
+        for (size_t k = 0; k < rearObservations[i].size(); k++, ++rearItr) {
+            if (rearObservations[i][k].step)
+                checker.add(rearItr->name, static_cast<int>(i), rearLogs[i][2 * k], rearLogs[i][2 * k + 1],
+                            rearObservations[i][k]);
         }
+    }
+
+    if (!checker.check(model))
+        throw AssertFailed(__FILE__, __LINE__, {}, checker.getFailure().c_str(), nullptr);
+}
 
-        sync_ready = true;
+template <typename ObjectType, typename ModelType>
+string Concurrency<ObjectType, ModelType>::renderInterleaving(const ActionList& front,
+                                                              const vector<Shrinkable<ActionList>>& rearShrs,
+                                                              int count) const
+{
+    constexpr int FRONT_THREAD_ID = -1;
+    stringstream str;
+    str << "count: " << count << ", order: ";
+    auto frontItr = front.begin();
+    vector<typename ActionList::const_iterator> rearItrs;
+    vector<bool> rearStarted;
+    for (auto& rearShr : rearShrs) {
+        rearItrs.push_back(rearShr.getRef().begin());
+        rearStarted.push_back(false);
+    }
 
-        for (int i = 0; i < numThreads; i++) {
-            rearRunners[i].join();
+    for (int i = 0; i < count; i++) {
+        int threadId = interleaving[i];
+        // front
+        if (threadId == FRONT_THREAD_ID) {
+            str << (*frontItr) << " -> ";
+            ++frontItr;
         }
-
-        cout << "count: " << counter << ", order: ";
-        auto frontItr = front.begin();
-        vector<typename ActionList::iterator> rearItrs;
-        vector<bool> rearStarted;
-        for(int i = 0; i < numThreads; i++) {
-            rearItrs.push_back(rears[i].begin());
-            rearStarted.push_back(false);
+        // rear
+        else {
+            if (rearStarted[threadId]) {
+                str << "thr" << threadId << " " << (*rearItrs[threadId]) << " end -> ";
+                ++rearItrs[threadId];
+            } else {
+                str << "thr" << threadId << " " << (*rearItrs[threadId]) << " start -> ";
+            }
+            rearStarted[threadId] = !rearStarted[threadId];
         }
+    }
+    str << "onCleanup";
+    return str.str();
+}
 
-        for (int i = 0; i < counter; i++) {
-            int threadId = log[i];
-            // front
-            if(threadId == FRONT_THREAD_ID) {
-                cout << (*frontItr) << " -> ";
-                ++frontItr;
-            }
-            // rear
-            else {
-                if(rearStarted[threadId]) {
-                    cout << "thr" << threadId << " " << (*rearItrs[threadId]) << " end -> ";
-                    ++rearItrs[threadId];
-                }
-                else {
-                    cout << "thr" << threadId << " " << (*rearItrs[threadId]) << " start -> ";
-                }
-                rearStarted[threadId] = rearStarted[threadId] ? false : true;
+template <typename ObjectType, typename ModelType>
+bool Concurrency<ObjectType, ModelType>::reproduce(Random& savedRand, const vector<Shrinkable<ActionList>>& lists,
+                                                   uint64_t scheduleSeed, string& failure)
+{
+    vector<Shrinkable<ActionList>> rearShrs(lists.begin() + 1, lists.end());
+    for (int attempt = 0; attempt < shrinkAttempts; attempt++) {
+        // each attempt starts from the object of the failed run, as runs modify it
+        Shrinkable<ObjectType> initialShr = restartObject(savedRand, std::is_copy_constructible<ObjectType>());
+        // collects failed expectations of this attempt only
+        PropertyContext context;
+        try {
+            if (onStartupPtr)
+                (*onStartupPtr)();
+            // a scheduled run is retried under other schedules
+            if (runActions(initialShr.getRef(), lists[0].getRef(), rearShrs, scheduleSeed + attempt) && onCleanupPtr)
+                (*onCleanupPtr)();
+            if (context.hasFailures()) {
+                failure = context.flushFailures().str();
+                return true;
             }
+        } catch (const Success&) {
+        } catch (const Discard&) {
+        } catch (const AssertFailed& e) {
+            failure = string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")";
+            return true;
+        } catch (const PropertyFailedBase& e) {
+            failure = string(e.what()) + " (" + e.filename + ":" + to_string(e.lineno) + ")";
+            return true;
+        } catch (const exception& e) {
+            failure = string("exception occurred: ") + e.what();
+            return true;
         }
+    }
+    return false;
+}
 
-        cout << "onCleanup" << endl;
-    });
-
-    spawner.join();
+template <typename ObjectType, typename ModelType>
+Shrinkable<ObjectType> Concurrency<ObjectType, ModelType>::restartObject(Random& savedRand, true_type)
+{
+    if (!startObject)
+        return restartObject(savedRand, false_type());
+    return make_shrinkable<ObjectType>(*startObject);
+}
 
-    if(postCheckPtr)
-        (*postCheckPtr)(obj, model);
-    return true;
+template <typename ObjectType, typename ModelType>
+Shrinkable<ObjectType> Concurrency<ObjectType, ModelType>::restartObject(Random& savedRand, false_type)
+{
+    Random rand = savedRand;
+    return (*initialGenPtr)(rand);
 }
 
 template <typename ObjectType, typename ModelType>
-void Concurrency<ObjectType, ModelType>::handleShrink(Random&)
+void Concurrency<ObjectType, ModelType>::handleShrink(Random& savedRand, PropertyReport& report, Reporter& rep)
 {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    // regenerate the action lists of the failed run
+    Random rand = savedRand;
+    vector<Shrinkable<ActionList>> lists;
+    uint64_t scheduleSeed;
+    generate(rand, lists, scheduleSeed);
+
+    // rear actions run only with two threads or more, so that the number of threads is kept at two at least
+    size_t minRear = numThreads > 1 ? 2 : lists.size() - 1;
+    string failure;
+    string shrunkLog;
+    auto fails = [&](const vector<Shrinkable<ActionList>>& candidate) {
+        if (!reproduce(savedRand, candidate, scheduleSeed, failure))
+            return false;
+        shrunkLog = runLog;
+        return true;
+    };
+    auto onStep = [&](size_t index, const string& change, int64_t sizeBefore, int64_t sizeAfter) {
+        report.shrinkSteps.emplace_back(static_cast<int>(index), change, failure, sizeBefore, sizeAfter);
+        rep.onShrinkStep(report, report.shrinkSteps.back());
+    };
+    lists = shrinkActionLists<ActionList>(lists, minRear, shrinkBudget, fails, onStep);
+
+    if (!report.shrinkSteps.empty()) {
+        util::ScopedShowLimits limits(ShowLimits::summary());
+        stringstream counterexample;
+        counterexample << "front: " << Show<ActionList>(lists[0].getRef());
+        for (size_t i = 1; i < lists.size(); i++)
+            counterexample << ", thr" << (i - 1) << ": " << Show<ActionList>(lists[i].getRef());
+        if (!shrunkLog.empty())
+            counterexample << "; " << shrunkLog;
+        report.counterexample = counterexample.str();
+    }
+    report.shrinkMs = std::chrono::duration<double, std::milli>(clock::now() - start).count();
 }
 
 /* without model */
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Shrinkable.hpp"
+#include "../util/std.hpp"
+
+namespace proptest {
+namespace concurrent {
+
+/**
+ * @brief Shrinks the action lists of a failed run of a concurrency test, within a budget of candidates
+ * @details `lists[0]` is the front list and the others are the lists of the rear threads. Rear lists are removed whole
+ * first, down to `minRear` of them, then each list is replaced by the first of its shrinks that still fails, until no
+ * list shrinks further. `fails` tells whether given lists fail, and may run them several times to catch a failure that
+ * depends on the interleaving. It is called at most `budget` times. `onStep` is called for each simpler failing lists
+ * found, with the index of the changed list and a description of the change.
+ */
+template <typename ActionList>
+vector<Shrinkable<ActionList>> shrinkActionLists(
+    vector<Shrinkable<ActionList>> lists, size_t minRear, int budget,
+    function<bool(const vector<Shrinkable<ActionList>>&)> fails,
+    function<void(size_t index, const string& change, int64_t sizeBefore, int64_t sizeAfter)> onStep)
+{
+    auto test = [&budget, &fails](const vector<Shrinkable<ActionList>>& candidate) {
+        return budget-- > 0 && fails(candidate);
+    };
+    auto nameOf = [](size_t index) { return index == 0 ? string("front") : "thr" + to_string(index - 1); };
+
+    // fewer rear threads
+    for (size_t i = 1; i < lists.size() && lists.size() - 1 > minRear && budget > 0;) {
+        vector<Shrinkable<ActionList>> candidate = lists;
+        candidate.erase(candidate.begin() + i);
+        if (!test(candidate)) {
+            i++;
+            continue;
+        }
+        int64_t numRear = static_cast<int64_t>(lists.size() - 1);
+        lists = candidate;
+        onStep(i, nameOf(i) + " removed", numRear, numRear - 1);
+    }
+
+    // shorter or simpler lists
+    for (size_t i = 0; i < lists.size() && budget > 0; i++) {
+        auto shrinks = lists[i].shrinks();
+        while (!shrinks.isEmpty() && budget > 0) {
+            auto iter = shrinks.iterator();
+            bool shrinkFound = false;
+            while (iter.hasNext() && budget > 0) {
+                vector<Shrinkable<ActionList>> candidate = lists;
+                candidate[i] = iter.next();
+                if (!test(candidate))
+                    continue;
+                int64_t size = static_cast<int64_t>(lists[i].getRef().size());
+                int64_t newSize = static_cast<int64_t>(candidate[i].getRef().size());
+                lists = candidate;
+                shrinks = lists[i].shrinks();
+                shrinkFound = true;
+                onStep(i, nameOf(i) + ": size " + to_string(size) + " -> " + to_string(newSize), size, newSize);
+                break;
+            }
+            if (!shrinkFound)
+                break;
+        }
+    }
+    return lists;
+}
+
+}  // namespace concurrent
+}  // namespace proptest
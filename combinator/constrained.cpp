@@ -0,0 +1,135 @@
+#include "constrained.hpp"
+
+namespace proptest {
+
+namespace util {
+
+IntegralDomain::IntegralDomain(vector<KeyInterval> intervals, uint64_t _modulus, uint64_t residue,
+                               vector<uint64_t> excluded, uint64_t zeroKey)
+    : lastRank(0), pivotRank(0), modulus(_modulus)
+{
+    if (modulus == 0)
+        throw invalid_argument("modulus must be positive");
+
+    residue %= modulus;
+
+    // sort and merge overlapping or adjacent intervals
+    intervals.erase(std::remove_if(intervals.begin(), intervals.end(),
+                                   [](const KeyInterval& interval) { return interval.min > interval.max; }),
+                    intervals.end());
+    std::sort(intervals.begin(), intervals.end(),
+              [](const KeyInterval& a, const KeyInterval& b) { return a.min < b.min; });
+
+    vector<KeyInterval> merged;
+    for (auto& interval : intervals) {
+        if (!merged.empty() && (merged.back().max == UINT64_MAX || interval.min <= merged.back().max + 1)) {
+            if (interval.max > merged.back().max)
+                merged.back().max = interval.max;
+        } else {
+            merged.push_back(interval);
+        }
+    }
+
+    // find first aligned key of each interval
+    uint64_t nextRank = 0;
+    for (auto& interval : merged) {
+        uint64_t offset = interval.min % modulus;
+        uint64_t distance = residue >= offset ? residue - offset : residue + (modulus - offset);
+        uint64_t start = interval.min + distance;
+        if (start < interval.min || start > interval.max)  // overflow or no aligned key
+            continue;
+
+        Segment segment;
+        segment.start = start;
+        segment.lastIndex = (interval.max - start) / modulus;
+        segment.startRank = nextRank;
+        segments.push_back(segment);
+        lastRank = nextRank + segment.lastIndex;
+        nextRank = lastRank + 1;
+    }
+
+    if (segments.empty())
+        throw invalid_argument("constraints admit no value");
+
+    // translate excluded keys into ranks
+    for (auto key : excluded) {
+        uint64_t rank = 0;
+        if (alignedRankOf(key, rank))
+            excludedRanks.push_back(rank);
+    }
+    std::sort(excludedRanks.begin(), excludedRanks.end());
+    excludedRanks.erase(std::unique(excludedRanks.begin(), excludedRanks.end()), excludedRanks.end());
+
+    if (excludedRanks.size() > lastRank)
+        throw invalid_argument("constraints admit no value");
+
+    lastRank -= excludedRanks.size();
+
+    // find the value closest to zero
+    uint64_t below = countBelow(zeroKey);
+    uint64_t excludedBelow = static_cast<uint64_t>(
+        std::lower_bound(excludedRanks.begin(), excludedRanks.end(), below) - excludedRanks.begin());
+    uint64_t upperRank = below - excludedBelow;  // rank of the smallest value >= zero, if any
+    if (upperRank > lastRank) {
+        pivotRank = lastRank;
+    } else if (upperRank == 0) {
+        pivotRank = 0;
+    } else {
+        uint64_t upperDistance = keyAt(upperRank) - zeroKey;
+        uint64_t lowerDistance = zeroKey - keyAt(upperRank - 1);
+        pivotRank = lowerDistance < upperDistance ? upperRank - 1 : upperRank;
+    }
+}
+
+uint64_t IntegralDomain::countBelow(uint64_t key) const
+{
+    uint64_t count = 0;
+    for (auto& segment : segments) {
+        if (segment.start >= key)
+            break;
+        uint64_t index = (key - 1 - segment.start) / modulus;
+        count = segment.startRank + (index < segment.lastIndex ? index : segment.lastIndex) + 1;
+    }
+    return count;
+}
+
+bool IntegralDomain::alignedRankOf(uint64_t key, uint64_t& rank) const
+{
+    for (auto& segment : segments) {
+        if (key < segment.start)
+            return false;
+        uint64_t distance = key - segment.start;
+        if (distance / modulus > segment.lastIndex)
+            continue;
+        if (distance % modulus != 0)
+            return false;
+        rank = segment.startRank + distance / modulus;
+        return true;
+    }
+    return false;
+}
+
+uint64_t IntegralDomain::keyAt(uint64_t rank) const
+{
+    // skip excluded ranks
+    for (auto excludedRank : excludedRanks) {
+        if (excludedRank <= rank)
+            rank++;
+        else
+            break;
+    }
+
+    auto itr = std::upper_bound(segments.begin(), segments.end(), rank,
+                                [](uint64_t r, const Segment& segment) { return r < segment.startRank; });
+    const Segment& segment = *(itr - 1);
+    return segment.start + (rank - segment.startRank) * modulus;
+}
+
+uint64_t IntegralDomain::drawRank(Random& rand) const
+{
+    return rand.getRandomUInt64(0, lastRank);
+}
+
+}  // namespace util
+
+}  // namespace proptest
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "../gen.hpp"
+#include "../api.hpp"
+#include "../Random.hpp"
+#include "../generator/util.hpp"
+#include "../util/std.hpp"
+
+/**
+ * @file constrained.hpp
+ * @brief Integral generators that generate directly within a constrained domain
+ */
+
+namespace proptest {
+
+namespace util {
+
+/**
+ * @brief Ordered set of 64-bit keys described by a union of intervals, an alignment (modulus/residue) and an exclusion
+ * set
+ *
+ * Values are addressed by their rank (index in ascending order), so that a uniform draw of a rank is a uniform draw
+ * from the domain. Signed types are mapped to keys by flipping the sign bit, which preserves ordering.
+ */
+struct PROPTEST_API IntegralDomain
+{
+    struct KeyInterval
+    {
+        KeyInterval(uint64_t _min, uint64_t _max) : min(_min), max(_max) {}
+
+        uint64_t min;
+        uint64_t max;
+    };
+
+    /**
+     * @param intervals union of allowed closed intervals in key space (may overlap)
+     * @param modulus only keys `k` with `k % modulus == residue` are allowed (modulus 1 disables alignment)
+     * @param excluded keys to be excluded from the domain
+     * @param zeroKey key of the value that shrinking should approach (the key of `0`)
+     * @throws invalid_argument if the constraints admit no value
+     */
+    IntegralDomain(vector<KeyInterval> intervals, uint64_t modulus, uint64_t residue, vector<uint64_t> excluded,
+                   uint64_t zeroKey);
+
+    /// key of the value at given rank in [0, lastRank]
+    uint64_t keyAt(uint64_t rank) const;
+
+    /// uniformly draws a rank in [0, lastRank]
+    uint64_t drawRank(Random& rand) const;
+
+    /// number of values in the domain minus one
+    uint64_t lastRank;
+    /// rank of the value closest to zero, which shrinking approaches
+    uint64_t pivotRank;
+
+private:
+    struct Segment
+    {
+        uint64_t start;      // first aligned key
+        uint64_t lastIndex;  // number of aligned keys in this segment minus one
+        uint64_t startRank;  // rank (before exclusion) of start
+    };
+
+    // number of aligned keys less than key
+    uint64_t countBelow(uint64_t key) const;
+    // rank (before exclusion) of key, if key is within domain
+    bool alignedRankOf(uint64_t key, uint64_t& rank) const;
+
+    uint64_t modulus;
+    vector<Segment> segments;
+    vector<uint64_t> excludedRanks;  // sorted ranks (before exclusion)
+};
+
+template <typename T>
+enable_if_t<std::is_signed<T>::value, uint64_t> integralToKey(T value)
+{
+    return static_cast<uint64_t>(static_cast<int64_t>(value)) ^ (1ULL << 63);
+}
+
+template <typename T>
+enable_if_t<!std::is_signed<T>::value, uint64_t> integralToKey(T value)
+{
+    return static_cast<uint64_t>(value);
+}
+
+template <typename T>
+enable_if_t<std::is_signed<T>::value, T> keyToIntegral(uint64_t key)
+{
+    return static_cast<T>(static_cast<int64_t>(key ^ (1ULL << 63)));
+}
+
+template <typename T>
+enable_if_t<!std::is_signed<T>::value, T> keyToIntegral(uint64_t key)
+{
+    return static_cast<T>(key);
+}
+
+// residue of value in [0, modulus), translated to key space
+template <typename T>
+enable_if_t<std::is_signed<T>::value, uint64_t> residueToKeyResidue(T remainder, uint64_t modulus)
+{
+    int64_t rem = static_cast<int64_t>(remainder) % static_cast<int64_t>(modulus);
+    uint64_t valueResidue = rem < 0 ? static_cast<uint64_t>(rem + static_cast<int64_t>(modulus))
+                                    : static_cast<uint64_t>(rem);
+    // key = value + 2^63
+    return (valueResidue + (1ULL << 63) % modulus) % modulus;
+}
+
+template <typename T>
+enable_if_t<!std::is_signed<T>::value, uint64_t> residueToKeyResidue(T remainder, uint64_t modulus)
+{
+    return static_cast<uint64_t>(remainder) % modulus;
+}
+
+/**
+ * @brief Generates a value from the domain, with shrinks approaching the value closest to zero.
+ * @details Shrinking is a binary search over ranks, so shrunk values never leave the domain
+ */
+template <typename T>
+Shrinkable<T> generateInDomain(const shared_ptr<IntegralDomain>& domain, Random& rand)
+{
+    const uint64_t rank = domain->drawRank(rand);
+    const uint64_t pivot = domain->pivotRank;
+    const uint64_t last = domain->lastRank;
+
+    if (pivot == 0) {  // [0, last] -> value
+        return binarySearchShrinkableU(rank).template map<T>(
+            [domain](const uint64_t& r) { return keyToIntegral<T>(domain->keyAt(r)); });
+    } else if (pivot == last) {  // [0, last] -> [last, 0] -> value
+        return binarySearchShrinkableU(last - rank).template map<T>(
+            [domain, last](const uint64_t& d) { return keyToIntegral<T>(domain->keyAt(last - d)); });
+    } else {  // [0, last] -> [-pivot, last - pivot] -> value
+        int64_t diff = rank >= pivot ? static_cast<int64_t>(rank - pivot)
+                                     : -static_cast<int64_t>(pivot - rank - 1) - 1;
+        return binarySearchShrinkable(diff).template map<T>([domain, pivot](const int64_t& d) {
+            uint64_t r = d >= 0 ? pivot + static_cast<uint64_t>(d) : pivot - static_cast<uint64_t>(-(d + 1)) - 1;
+            return keyToIntegral<T>(domain->keyAt(r));
+        });
+    }
+}
+
+}  // namespace util
+
+/**
+ * @brief Generator for an integral type `T` restricted by constraints
+ * @details Instead of rejecting values (as `filter` does), values are generated directly within the constrained
+ * domain. Shrinking stays within the domain as well, approaching the allowed value closest to zero.
+ *
+ * Usage:
+ * @code
+ *     // same as Arbi<int>().filter([](int& x) { return x % 8 == 0 && x > 100; }), but without rejection
+ *     auto gen = constrained<int>().atLeast(101).multipleOf(8);
+ *     // union of intervals, excluding some values
+ *     auto gen2 = constrained<int>().in(-10, -1).in(1, 10).exclude({3, 5});
+ * @endcode
+ */
+template <typename T>
+class Constrained : public GenBase<T> {
+public:
+    static_assert(std::is_integral<T>::value, "Constrained requires an integral type");
+
+    Constrained()
+        : lowerBound(numeric_limits<T>::min()), upperBound(numeric_limits<T>::max()), modulus(1), remainder(0)
+    {
+    }
+
+    /// adds [min, max] to the union of allowed intervals. If no interval is added, the whole range of `T` is allowed
+    Constrained& in(T min, T max)
+    {
+        if (min > max)
+            throw invalid_argument("invalid empty interval: [" + to_string(min) + ", " + to_string(max) + "]");
+        intervals.push_back(util::make_pair(min, max));
+        domainPtr.reset();
+        return *this;
+    }
+
+    /// restricts values to be greater than or equal to `min`
+    Constrained& atLeast(T min)
+    {
+        if (min > lowerBound)
+            lowerBound = min;
+        domainPtr.reset();
+        return *this;
+    }
+
+    /// restricts values to be less than or equal to `max`
+    Constrained& atMost(T max)
+    {
+        if (max < upperBound)
+            upperBound = max;
+        domainPtr.reset();
+        return *this;
+    }
+
+    /// restricts values to satisfy `value % mod == rem` (with `rem` normalized into `[0, mod)`)
+    Constrained& multipleOf(T mod, T rem = 0)
+    {
+        if (!(mod > 0))
+            throw invalid_argument("modulus must be positive: " + to_string(mod));
+        modulus = mod;
+        remainder = rem;
+        domainPtr.reset();
+        return *this;
+    }
+
+    /// excludes a value
+    Constrained& exclude(T value)
+    {
+        excluded.push_back(value);
+        domainPtr.reset();
+        return *this;
+    }
+
+    /// excludes a set of values
+    Constrained& exclude(initializer_list<T> values)
+    {
+        excluded.insert(excluded.end(), values.begin(), values.end());
+        domainPtr.reset();
+        return *this;
+    }
+
+    Shrinkable<T> operator()(Random& rand) override { return util::generateInDomain<T>(getDomain(), rand); }
+
+    template <typename U>
+    Generator<U> map(function<U(T&)> mapper)
+    {
+        auto thisPtr = clone();
+        return Generator<U>(
+            proptest::transform<T, U>([thisPtr](Random& rand) { return thisPtr->operator()(rand); }, mapper));
+    }
+
+    template <typename Criteria>
+    Generator<T> filter(Criteria&& criteria)
+    {
+        auto thisPtr = clone();
+        return Generator<T>(proptest::filter<T>([thisPtr](Random& rand) { return thisPtr->operator()(rand); },
+                                                util::forward<Criteria>(criteria)));
+    }
+
+    shared_ptr<Constrained<T>> clone() { return util::make_shared<Constrained<T>>(*this); }
+
+private:
+    const shared_ptr<util::IntegralDomain>& getDomain()
+    {
+        if (!domainPtr)
+            domainPtr = buildDomain();
+        return domainPtr;
+    }
+
+    shared_ptr<util::IntegralDomain> buildDomain() const
+    {
+        using KeyInterval = util::IntegralDomain::KeyInterval;
+        vector<KeyInterval> keyIntervals;
+        if (intervals.empty())
+            keyIntervals.push_back(KeyInterval(util::integralToKey<T>(lowerBound), util::integralToKey<T>(upperBound)));
+
+        for (auto& interval : intervals) {
+            T min = interval.first < lowerBound ? lowerBound : interval.first;
+            T max = interval.second > upperBound ? upperBound : interval.second;
+            if (min <= max)
+                keyIntervals.push_back(KeyInterval(util::integralToKey<T>(min), util::integralToKey<T>(max)));
+        }
+
+        vector<uint64_t> excludedKeys;
+        excludedKeys.reserve(excluded.size());
+        for (auto& value : excluded)
+            excludedKeys.push_back(util::integralToKey<T>(value));
+
+        uint64_t keyModulus = static_cast<uint64_t>(modulus);
+        return util::make_shared<util::IntegralDomain>(keyIntervals, keyModulus,
+                                                       util::residueToKeyResidue<T>(remainder, keyModulus),
+                                                       excludedKeys, util::integralToKey<T>(0));
+    }
+
+    vector<pair<T, T>> intervals;
+    T lowerBound;
+    T upperBound;
+    T modulus;
+    T remainder;
+    vector<T> excluded;
+    shared_ptr<util::IntegralDomain> domainPtr;
+};
+
+/**
+ * @brief Creates a `Constrained<T>` generator that initially allows the whole range of `T`
+ */
+template <typename T>
+Constrained<T> constrained()
+{
+    return Constrained<T>();
+}
+
+}  // namespace proptest
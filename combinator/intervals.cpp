@@ -1,52 +1,38 @@
 #include "intervals.hpp"
+#include "constrained.hpp"
 
 namespace proptest {
 
 Generator<int64_t> intervals(initializer_list<Interval> intervals)
 {
-    using WeightedVec = vector<util::Weighted<int64_t>>;
+    if (intervals.size() == 0)
+        throw invalid_argument("at least one interval is required");
 
-    uint64_t sum = 0;
+    auto gen = constrained<int64_t>();
     for (auto interval : intervals) {
-        if (interval.size() == 0)
+        if (interval.min > interval.max)
             throw runtime_error("invalid empty interval: [" + to_string(interval.min) + ", " +
                                      to_string(interval.max) + "]");
-        sum += interval.size();
+        gen.in(interval.min, interval.max);
     }
 
-    WeightedVec* genVec = new WeightedVec();
-    for (auto interval : intervals) {
-        genVec->push_back(weightedGen<int64_t>(proptest::interval<int64_t>(interval.min, interval.max),
-                                               static_cast<double>(interval.size()) / sum));
-    }
-
-    shared_ptr<WeightedVec> genVecPtr(genVec);
-
-    return util::oneOfHelper<int64_t>(genVecPtr);
+    return Generator<int64_t>(gen);
 }
 
 Generator<uint64_t> uintervals(initializer_list<UInterval> intervals)
 {
-    using WeightedVec = vector<util::Weighted<uint64_t>>;
-
-    uint64_t sum = 0;
+    if (intervals.size() == 0)
+        throw invalid_argument("at least one interval is required");
 
+    auto gen = constrained<uint64_t>();
     for (auto interval : intervals) {
-        if (interval.size() == 0)
+        if (interval.min > interval.max)
             throw runtime_error("invalid empty interval: [" + to_string(interval.min) + ", " +
                                      to_string(interval.max) + "]");
-        sum += interval.size();
+        gen.in(interval.min, interval.max);
     }
 
-    WeightedVec* genVec = new WeightedVec();
-    for (auto interval : intervals) {
-        genVec->push_back(weightedGen<uint64_t>(proptest::interval<uint64_t>(interval.min, interval.max),
-                                                static_cast<double>(interval.size()) / sum));
-    }
-
-    shared_ptr<WeightedVec> genVecPtr(genVec);
-
-    return util::oneOfHelper<uint64_t>(genVecPtr);
+    return Generator<uint64_t>(gen);
 }
 
 }  // namespace proptest
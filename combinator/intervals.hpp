@@ -25,7 +25,13 @@ struct UInterval
     uint64_t max;
 };
 
+/**
+ * @brief Generates a value within the union of given closed intervals, uniformly over all values in the union
+ * @details Overlapping intervals are merged. Shrinking approaches the value closest to zero, without leaving the union.
+ * See `constrained<T>()` for further constraints such as alignment and exclusions.
+ */
 PROPTEST_API Generator<int64_t> intervals(initializer_list<Interval> interval_list);
+/// unsigned version of `intervals`
 PROPTEST_API Generator<uint64_t> uintervals(initializer_list<UInterval> interval_list);
 
 }  // namespace proptest
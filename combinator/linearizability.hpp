@@ -0,0 +1,266 @@
+#pragma once
+
+#include "../api.hpp"
+#include "../util/std.hpp"
+#include "../util/action.hpp"
+#include "../util/printing.hpp"
+#include <unordered_map>
+
+namespace proptest {
+
+namespace util {
+
+template <typename T, typename = void>
+struct IsEqualityComparable : public false_type
+{
+};
+
+template <typename T>
+struct IsEqualityComparable<T, decltype(void(declval<const T&>() == declval<const T&>()))> : public true_type
+{
+};
+
+}  // namespace util
+
+namespace concurrent {
+
+using stateful::Action;
+
+/**
+ * @brief What an operation observed, as a step on the sequential model that tells if the model agrees
+ */
+template <typename ModelType>
+struct Observation
+{
+    // performs the operation on the model, and returns whether the model yields what was observed
+    function<bool(ModelType&)> step;
+    // prints what was observed
+    function<void(ostream&)> show;
+};
+
+// observation of the last operation performed on the calling thread, taken by the concurrency runner
+template <typename ModelType>
+Observation<ModelType>& lastObservation()
+{
+    static thread_local Observation<ModelType> observation;
+    return observation;
+}
+
+/**
+ * @brief Action of a concurrency test, whose results are checked for linearizability against a sequential model
+ * @details `run` performs the operation on the object under test and returns its result, and `model` performs it on
+ * the model and returns the result expected. After each run of a concurrency test with such actions, the results must
+ * be those of some sequential order of the actions on the model, in which an action that returned before another was
+ * called comes first. The model passed to the actions during the run is left untouched. `ModelType` must be
+ * comparable with `==`.
+ *
+ * e.g. operation<Counter, int, int>("Increment", [](Counter& c) { return c.increment(); },
+ *                                                  [](int& count) { return count++; })
+ */
+template <typename ObjectType, typename ModelType, typename ResultType>
+Action<ObjectType, ModelType> operation(const string& name, function<ResultType(ObjectType&)> run,
+                                        function<ResultType(ModelType&)> model)
+{
+    static_assert(util::IsEqualityComparable<ModelType>::value, "model of operations must be comparable with ==");
+    return Action<ObjectType, ModelType>(name, [run, model](ObjectType& obj, ModelType&) {
+        ResultType result = run(obj);
+        Observation<ModelType>& observation = lastObservation<ModelType>();
+        observation.step = [model, result](ModelType& m) { return model(m) == result; };
+        observation.show = [result](ostream& os) { show(os, result); };
+    });
+}
+
+/**
+ * @brief Checks whether a concurrent history of operations is linearizable against a sequential model
+ * @details Each operation has the times of its call and its return, and an observation to check against the model.
+ * The history is linearizable if the operations can be ordered so that every observation agrees with the model,
+ * where an operation returning before another is called comes first.
+ *
+ * The search is Wing and Gong's with Lowe's improvements: operations are linearized by lifting their calls and
+ * returns out of a list of events ordered by time, backtracking when a return is reached whose operation is not yet
+ * linearized, and a state of the search (the set of linearized operations and the model reached) is never visited
+ * twice. `ModelType` must be copyable and comparable with `==`.
+ */
+template <typename ModelType>
+class LinearizabilityChecker {
+public:
+    struct Operation
+    {
+        string name;
+        int thread;
+        uint64_t call;
+        uint64_t ret;
+        Observation<ModelType> observation;
+    };
+
+    /// adds an operation. times of all calls and returns must be distinct, with call < ret
+    void add(const string& name, int thread, uint64_t call, uint64_t ret, const Observation<ModelType>& observation)
+    {
+        operations.push_back(Operation{name, thread, call, ret, observation});
+    }
+
+    size_t size() const { return operations.size(); }
+
+    void clear() { operations.clear(); }
+
+    /// whether the history is linearizable, starting from given state of the model
+    bool check(const ModelType& initial);
+
+    /// explanation of the last failed check
+    const string& getFailure() const { return failure; }
+
+private:
+    struct Event
+    {
+        uint64_t time;
+        int op;
+        bool isCall;
+        // neighbors in the list of remaining events. index 0 is the head of the list and -1 is the end
+        int prev;
+        int next;
+        // return event of a call
+        int ret;
+    };
+
+    using Bits = vector<uint64_t>;
+
+    struct BitsHash
+    {
+        size_t operator()(const Bits& bits) const
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (uint64_t word : bits)
+                hash = (hash ^ word) * 1099511628211ULL;
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    void lift(int call)
+    {
+        for (int e : {call, events[call].ret}) {
+            events[events[e].prev].next = events[e].next;
+            if (events[e].next != -1)
+                events[events[e].next].prev = events[e].prev;
+        }
+    }
+
+    // reverses lift(call)
+    void unlift(int call)
+    {
+        for (int e : {events[call].ret, call}) {
+            events[events[e].prev].next = e;
+            if (events[e].next != -1)
+                events[events[e].next].prev = e;
+        }
+    }
+
+    void explain(size_t numLinearized, int blocker);
+
+    vector<Operation> operations;
+    vector<Event> events;
+    string failure;
+};
+
+template <typename ModelType>
+bool LinearizabilityChecker<ModelType>::check(const ModelType& initial)
+{
+    failure.clear();
+    size_t n = operations.size();
+    if (n == 0)
+        return true;
+
+    // events ordered by time, after the head
+    vector<int> order(2 * n);
+    for (size_t i = 0; i < 2 * n; i++)
+        order[i] = static_cast<int>(i);
+    auto timeOf = [this](int e) { return e % 2 == 0 ? operations[e / 2].call : operations[e / 2].ret; };
+    std::sort(order.begin(), order.end(), [&timeOf](int a, int b) { return timeOf(a) < timeOf(b); });
+    events.assign(2 * n + 1, Event{0, -1, false, -1, -1, -1});
+    vector<int> position(2 * n);
+    for (size_t i = 0; i < 2 * n; i++)
+        position[order[i]] = static_cast<int>(i + 1);
+    for (size_t i = 0; i <= 2 * n; i++) {
+        Event& event = events[i];
+        if (i > 0) {
+            int e = order[i - 1];
+            event.time = timeOf(e);
+            event.op = e / 2;
+            event.isCall = e % 2 == 0;
+            event.ret = event.isCall ? position[e + 1] : -1;
+            event.prev = static_cast<int>(i - 1);
+        }
+        event.next = i < 2 * n ? static_cast<int>(i + 1) : -1;
+    }
+
+    struct Frame
+    {
+        int call;
+        ModelType model;
+    };
+    vector<Frame> stack;
+    Bits linearized((n + 63) / 64, 0);
+    // model states reached for each set of linearized operations
+    std::unordered_map<Bits, vector<ModelType>, BitsHash> visited;
+    ModelType model = initial;
+    size_t deepest = 0;
+    int blocker = -1;
+    int entry = events[0].next;
+
+    while (events[0].next != -1) {
+        const Event& event = events[entry];
+        if (event.isCall) {
+            ModelType next = model;
+            const Observation<ModelType>& observation = operations[event.op].observation;
+            if (observation.step(next)) {
+                linearized[event.op / 64] |= uint64_t(1) << (event.op % 64);
+                vector<ModelType>& states = visited[linearized];
+                if (std::find(states.begin(), states.end(), next) == states.end()) {
+                    states.push_back(next);
+                    stack.push_back(Frame{entry, util::move(model)});
+                    model = util::move(next);
+                    lift(entry);
+                    entry = events[0].next;
+                    continue;
+                }
+                linearized[event.op / 64] &= ~(uint64_t(1) << (event.op % 64));
+            }
+            entry = event.next;
+        } else {
+            // the operation returning here cannot be placed after the ones linearized so far
+            if (stack.size() > deepest || blocker == -1) {
+                deepest = stack.size();
+                blocker = event.op;
+            }
+            if (stack.empty()) {
+                explain(deepest, blocker);
+                return false;
+            }
+            Frame& frame = stack.back();
+            int op = events[frame.call].op;
+            model = util::move(frame.model);
+            linearized[op / 64] &= ~(uint64_t(1) << (op % 64));
+            unlift(frame.call);
+            entry = events[frame.call].next;
+            stack.pop_back();
+        }
+    }
+    return true;
+}
+
+template <typename ModelType>
+void LinearizabilityChecker<ModelType>::explain(size_t numLinearized, int blocker)
+{
+    const Operation& op = operations[blocker];
+    stringstream str;
+    str << "history of " << operations.size() << " operations is not linearizable: at most " << numLinearized
+        << " can be ordered before thr" << op.thread << " " << op.name;
+    if (op.observation.show) {
+        str << " returning ";
+        op.observation.show(str);
+    }
+    str << " (called at " << op.call << ", returned at " << op.ret << ")";
+    failure = str.str();
+}
+
+}  // namespace concurrent
+}  // namespace proptest
@@ -8,12 +8,10 @@
 #include "../Shrinkable.hpp"
 #include "../Random.hpp"
 #include "../GenBase.hpp"
+#include "../PropertyBase.hpp"
 
 namespace proptest {
 
-template <typename... ARGS>
-class Property;
-
 namespace util {
 
 template <typename ActionType, typename GEN>
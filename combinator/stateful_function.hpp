@@ -9,12 +9,11 @@
 #include "../Shrinkable.hpp"
 #include "../Random.hpp"
 #include "../GenBase.hpp"
+#include "../PropertyBase.hpp"
 #include "just.hpp"
 
 namespace proptest {
 
-template <typename... ARGS>
-class Property;
 namespace stateful {
 
 // template <typename ObjectType, typename ModelType>
@@ -74,9 +73,9 @@ public:
     bool go() {
         // TODO add interface to adjust list min max sizes
         auto actionListGen = Arbi<list<Action<ObjectType,ModelType>>>(actionGen);
-        auto genTup = util::make_tuple(util::forward<InitialGen>(initialGen), actionListGen);
+        auto genTup = util::make_tuple(initialGen, actionListGen);
         shared_ptr<ModelFactoryFunction> modelFactoryPtr =
-            util::make_shared<ModelFactoryFunction>(util::forward<ModelFactoryFunction>(modelFactory));
+            util::make_shared<ModelFactoryFunction>(modelFactory);
 
         auto func = [modelFactoryPtr](ObjectType obj, list<Action<ObjectType,ModelType>> actions) {
             auto model = (*modelFactoryPtr)(obj);
@@ -1,6 +1,7 @@
 #pragma once
 #include "../gen.hpp"
 #include "../util/cesu8string.hpp"
+#include "unicode.hpp"
 #include "../util/std.hpp"
 
 namespace proptest {
@@ -13,13 +14,24 @@ public:
     static size_t defaultMinSize;
     static size_t defaultMaxSize;
 
+    /// draws code points of `UnicodeClass::Any`
     Arbi();
+    /// draws code points uniformly from given class, in bulk with a `CodePointSampler`, unless `elemGen` is assigned
+    /// afterwards
+    explicit Arbi(UnicodeClass unicodeClass);
     Arbi(Arbi<uint32_t>& _elemGen);
     Arbi(GenFunction<uint32_t> _elemGen);
 
     Shrinkable<CESU8String> operator()(Random& rand) override;
 
+    // generator of each code point. unset if constructed with a `UnicodeClass`, and takes precedence over the class if
+    // set
     GenFunction<uint32_t> elemGen;
+
+private:
+    shared_ptr<CodePointSampler> codePointSampler;
+    // flags of `util::SimplestChar` in the class, allowed as targets of shrinking
+    uint8_t simplestChars;
 };
 
 }  // namespace proptest
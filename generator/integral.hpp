@@ -25,20 +25,14 @@ Shrinkable<T> generateInteger(Random& rand, T min = numeric_limits<T>::min(),
     if (value < min || max < value)
         throw runtime_error("invalid range");
 
-    if (min >= 0)  // [3,5] -> [0,2] -> [3,5]
-    {
-        return util::binarySearchShrinkableU(static_cast<T>(value - min))
-            .template map<T>([min](const uint64_t& _value) { return static_cast<T>(_value + min); });
-    } else if (max <= 0)  // [-5,-3] -> [-2,0] -> [-5,-3]
-    {
-        return util::binarySearchShrinkable(static_cast<T>(value - max)).template map<T>([max](const int64_t& _value) {
-            return static_cast<T>(_value + max);
-        });
-    } else  // [-2, 2]
-    {
-        auto transformer = +[](const int64_t& _value) { return static_cast<T>(_value); };
-        return util::binarySearchShrinkable(value).template map<T>(transformer);
-    }
+    // shrink towards min for [3,5], towards max for [-5,-3], and towards 0 for [-2,2]
+    T target = 0;
+    if (min >= 0)
+        target = min;
+    else if (max <= 0)
+        target = max;
+
+    return util::integralShrinkable<T>(value, target);
 }
 
 template <>
@@ -18,15 +18,26 @@ public:
     static size_t defaultMinSize;
     static size_t defaultMaxSize;
 
-    Arbi() : ArbiContainer<List>(defaultMinSize, defaultMaxSize), elemGen(Arbi<T>()) {}
+    Arbi()
+        : ArbiContainer<List>(defaultMinSize, defaultMaxSize),
+          elemGen(Arbi<T>()),
+          membershipShrink(MembershipShrink::FrontAndMid)
+    {
+    }
 
     Arbi(const Arbi<T>& _elemGen)
         : ArbiContainer<List>(defaultMinSize, defaultMaxSize),
-          elemGen([_elemGen](Random& rand) -> Shrinkable<T> { return _elemGen(rand); })
+          elemGen([_elemGen](Random& rand) -> Shrinkable<T> { return _elemGen(rand); }),
+          membershipShrink(MembershipShrink::FrontAndMid)
     {
     }
 
-    Arbi(GenFunction<T> _elemGen) : ArbiContainer<List>(defaultMinSize, defaultMaxSize), elemGen(_elemGen) {}
+    Arbi(GenFunction<T> _elemGen)
+        : ArbiContainer<List>(defaultMinSize, defaultMaxSize),
+          elemGen(_elemGen),
+          membershipShrink(MembershipShrink::FrontAndMid)
+    {
+    }
 
     using vector_t = vector<Shrinkable<T>>;
     using shrinkable_t = Shrinkable<vector_t>;
@@ -35,16 +46,25 @@ public:
 
     Shrinkable<list<T>> operator()(Random& rand) override
     {
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getScaledSize(minSize, maxSize);
         shared_ptr<vector_t> shrinkVec = util::make_shared<vector_t>();
         shrinkVec->reserve(size);
         for (size_t i = 0; i < size; i++)
             shrinkVec->push_back(elemGen(rand));
 
-        return shrinkListLike<list, T>(shrinkVec, minSize);
+        return shrinkListLike<list, T>(shrinkVec, minSize, true, membershipShrink);
     }
+
+    // strategy of removing elements in shrinking
+    Arbi& setMembershipShrink(MembershipShrink strategy)
+    {
+        membershipShrink = strategy;
+        return *this;
+    }
+
     // FIXME: turn to shared_ptr
     GenFunction<T> elemGen;
+    MembershipShrink membershipShrink;
 };
 
 template <typename T>
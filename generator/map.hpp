@@ -22,7 +22,7 @@ public:
     Shrinkable<Map> operator()(Random& rand) override
     {
         // generate random Ts using elemGen
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getScaledSize(minSize, maxSize);
         shared_ptr<set<Shrinkable<Key>>> shrinkSet = util::make_shared<set<Shrinkable<Key>>>();
 
         while (shrinkSet->size() < size) {
@@ -31,30 +31,49 @@ public:
     static size_t defaultMinSize;
     static size_t defaultMaxSize;
 
-    Arbi() : ArbiContainer<Set>(defaultMinSize, defaultMaxSize), elemGen(Arbi<T>()) {}
+    Arbi()
+        : ArbiContainer<Set>(defaultMinSize, defaultMaxSize),
+          elemGen(Arbi<T>()),
+          membershipShrink(MembershipShrink::FrontAndMid)
+    {
+    }
 
     Arbi(const Arbi<T>& _elemGen)
         : ArbiContainer<Set>(defaultMinSize, defaultMaxSize),
-          elemGen([_elemGen](Random& rand) -> Shrinkable<T> { return _elemGen(rand); })
+          elemGen([_elemGen](Random& rand) -> Shrinkable<T> { return _elemGen(rand); }),
+          membershipShrink(MembershipShrink::FrontAndMid)
     {
     }
 
-    Arbi(GenFunction<T> _elemGen) : ArbiContainer<Set>(defaultMinSize, defaultMaxSize), elemGen(_elemGen) {}
+    Arbi(GenFunction<T> _elemGen)
+        : ArbiContainer<Set>(defaultMinSize, defaultMaxSize),
+          elemGen(_elemGen),
+          membershipShrink(MembershipShrink::FrontAndMid)
+    {
+    }
 
     Shrinkable<Set> operator()(Random& rand) override
     {
         // generate random Ts using elemGen
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getScaledSize(minSize, maxSize);
         shared_ptr<set<Shrinkable<T>>> shrinkableSet = util::make_shared<set<Shrinkable<T>>>();
 
         while (shrinkableSet->size() < size) {
             auto elem = elemGen(rand);
             shrinkableSet->insert(elem);
         }
-        return shrinkSet(shrinkableSet, minSize);
+        return shrinkSet(shrinkableSet, minSize, membershipShrink);
+    }
+
+    // strategy of removing elements in shrinking
+    Arbi& setMembershipShrink(MembershipShrink strategy)
+    {
+        membershipShrink = strategy;
+        return *this;
     }
 
     GenFunction<T> elemGen;
+    MembershipShrink membershipShrink;
 };
 
 template <typename T>
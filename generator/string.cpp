@@ -3,6 +3,7 @@
 #include "util.hpp"
 #include "integral.hpp"
 #include "../shrinker/string.hpp"
+#include "../shrinker/stringlike.hpp"
 #include "../util/std.hpp"
 
 namespace proptest {
@@ -11,8 +12,11 @@ size_t Arbi<string>::defaultMinSize = 0;
 size_t Arbi<string>::defaultMaxSize = 200;
 
 // defaults to ascii characters
-Arbi<string>::Arbi()
-    : ArbiContainer<string>(defaultMinSize, defaultMaxSize), elemGen(interval<char>(0x1, 0x7f))
+Arbi<string>::Arbi() : Arbi(CharClass::ASCII) {}
+
+// elemGen is left unset, so that the class is used unless elemGen is assigned later
+Arbi<string>::Arbi(CharClass charClass)
+    : ArbiContainer<string>(defaultMinSize, defaultMaxSize), charTable(getCharTable(charClass))
 {
 }
 
@@ -27,14 +31,72 @@ Arbi<string>::Arbi(GenFunction<char> _elemGen)
 {
 }
 
+shared_ptr<Arbi<string>::CharTable> Arbi<string>::getCharTable(CharClass charClass)
+{
+    static auto makeTable = [](const string& chars) {
+        auto table = util::make_shared<CharTable>();
+        // the largest multiple of the number of characters, so that each character is mapped from as many bytes
+        table->numAccepted = 256 / chars.size() * chars.size();
+        for (size_t i = 0; i < 256; i++)
+            table->chars[i] = chars[i % chars.size()];
+        table->simplestChars =
+            util::simplestCharsIn([&chars](char c) { return chars.find(c) != string::npos; });
+        return table;
+    };
+    static auto charsInRange = [](int from, int to) {
+        string chars;
+        for (int c = from; c <= to; c++)
+            chars += static_cast<char>(c);
+        return chars;
+    };
+
+    // tables are shared by all generators of the same class
+    static shared_ptr<CharTable> ascii = makeTable(charsInRange(0x1, 0x7f));
+    static shared_ptr<CharTable> printable = makeTable(charsInRange(0x20, 0x7e));
+    static shared_ptr<CharTable> alphanumeric =
+        makeTable(charsInRange('0', '9') + charsInRange('A', 'Z') + charsInRange('a', 'z'));
+    static shared_ptr<CharTable> bytes = makeTable(charsInRange(0x0, 0xff));
+
+    switch (charClass) {
+        case CharClass::Printable:
+            return printable;
+        case CharClass::Alphanumeric:
+            return alphanumeric;
+        case CharClass::Bytes:
+            return bytes;
+        default:
+            return ascii;
+    }
+}
+
 Shrinkable<string> Arbi<string>::operator()(Random& rand)
 {
-    size_t size = rand.getRandomSize(minSize, maxSize + 1);
+    size_t size = rand.getScaledSize(minSize, maxSize);
     string str(size, ' ' /*, allocator()*/);
-    for (size_t i = 0; i < size; i++)
-        str[i] = elemGen(rand).get();
+    if (!elemGen && !charTable)
+        throw runtime_error("elemGen is not set");
+    // an element generator takes precedence over the class
+    const bool useTable = !elemGen;
+    if (useTable) {
+        // fill with random bytes in place, keep the accepted ones mapped to characters, and redraw the rest
+        uint8_t* buffer = reinterpret_cast<uint8_t*>(&str[0]);
+        const CharTable& table = *charTable;
+        size_t filled = 0;
+        while (filled < size) {
+            rand.getRandomBytes(buffer + filled, size - filled);
+            for (size_t i = filled; i < size; i++) {
+                uint8_t byte = buffer[i];
+                if (byte < table.numAccepted)
+                    buffer[filled++] = static_cast<uint8_t>(table.chars[byte]);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < size; i++)
+            str[i] = elemGen(rand).get();
+    }
 
-    return shrinkString(str, minSize);
+    // simplified only to characters of the class, as the range of an element generator is unknown
+    return shrinkString(str, minSize, useTable ? charTable->simplestChars : static_cast<uint8_t>(util::SimplestNone));
 }
 
 }  // namespace proptest
@@ -7,6 +7,16 @@
 
 namespace proptest {
 
+/**
+ * @brief Classes of characters that `Arbi<string>` draws directly from random bytes, without an element generator
+ */
+enum class CharClass {
+    ASCII,         // 0x01..0x7f (default)
+    Printable,     // 0x20..0x7e
+    Alphanumeric,  // 0-9, A-Z and a-z
+    Bytes,         // 0x00..0xff
+};
+
 template <>
 class PROPTEST_API Arbi<string> final : public ArbiContainer<string> {
     using ArbiContainer<string>::minSize;
@@ -16,13 +26,32 @@ public:
     static size_t defaultMinSize;
     static size_t defaultMaxSize;
 
+    /// draws characters of `CharClass::ASCII`
     Arbi();
+    /// draws characters uniformly from given class, mapping random bytes through a lookup table, unless `elemGen` is
+    /// assigned afterwards
+    explicit Arbi(CharClass charClass);
     Arbi(Arbi<char>& _elemGen);
     Arbi(GenFunction<char> _elemGen);
 
     Shrinkable<string> operator()(Random& rand) override;
     // FIXME: turn to shared_ptr
+    // generator of each character. unset if constructed with a `CharClass`, and takes precedence over the class if set
     GenFunction<char> elemGen;
+
+private:
+    // characters by random byte, where bytes at or above `numAccepted` are redrawn for uniformity
+    struct CharTable
+    {
+        char chars[256];
+        size_t numAccepted;
+        // flags of `util::SimplestChar` in the class, allowed as targets of shrinking
+        uint8_t simplestChars;
+    };
+
+    static shared_ptr<CharTable> getCharTable(CharClass charClass);
+
+    shared_ptr<CharTable> charTable;
 };
 
 }  // namespace proptest
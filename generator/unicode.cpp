@@ -1,19 +1,119 @@
 #include "../Shrinkable.hpp"
-#include "../combinator/oneof.hpp"
-#include "../generator/integral.hpp"
+#include "util.hpp"
 #include "unicode.hpp"
 
 namespace proptest {
 
+namespace {
+
+constexpr CodePointRange anyRanges[] = {{0x1, 0xD7FF}, {0xE000, 0x10FFFF}};
+
+constexpr CodePointRange letterRanges[] = {
+    {0x41, 0x5A},      {0x61, 0x7A},      {0xC0, 0xD6},      {0xD8, 0xF6},     {0xF8, 0x24F},
+    {0x391, 0x3A1},    {0x3A3, 0x3C9},    {0x410, 0x44F},    {0x5D0, 0x5EA},   {0x620, 0x63F},
+    {0x641, 0x64A},    {0x905, 0x939},    {0x3041, 0x3096},  {0x30A1, 0x30FA}, {0x4E00, 0x9FFF},
+    {0xAC00, 0xD7A3}};
+
+constexpr CodePointRange digitRanges[] = {
+    {0x30, 0x39},     {0x660, 0x669},   {0x6F0, 0x6F9},   {0x7C0, 0x7C9},   {0x966, 0x96F},
+    {0x9E6, 0x9EF},   {0xA66, 0xA6F},   {0xAE6, 0xAEF},   {0xB66, 0xB6F},   {0xBE6, 0xBEF},
+    {0xC66, 0xC6F},   {0xCE6, 0xCEF},   {0xD66, 0xD6F},   {0xE50, 0xE59},   {0xED0, 0xED9},
+    {0xF20, 0xF29},   {0x1040, 0x1049}, {0xFF10, 0xFF19}, {0x1D7CE, 0x1D7FF}};
+
+constexpr CodePointRange combiningMarkRanges[] = {
+    {0x300, 0x36F},   {0x483, 0x487},   {0x591, 0x5BD},   {0x610, 0x61A},   {0x64B, 0x65F},
+    {0x1AB0, 0x1ABD}, {0x1DC0, 0x1DF9}, {0x20D0, 0x20DC}, {0xFE20, 0xFE2F}};
+
+constexpr CodePointRange emojiRanges[] = {
+    {0x2600, 0x26FF}, {0x1F300, 0x1F5FF}, {0x1F600, 0x1F64F}, {0x1F680, 0x1F6C5}, {0x1F910, 0x1F9FF}};
+
+template <size_t N>
+vector<CodePointRange> toVector(const CodePointRange (&ranges)[N])
+{
+    return vector<CodePointRange>(ranges, ranges + N);
+}
+
+}  // namespace
+
+CodePointSampler::CodePointSampler(UnicodeClass unicodeClass) : table(getTable(unicodeClass)) {}
+
+shared_ptr<CodePointSampler::Table> CodePointSampler::getTable(UnicodeClass unicodeClass)
+{
+    static auto makeTable = [](const vector<CodePointRange>& ranges) {
+        auto table = util::make_shared<Table>();
+        table->ranges = ranges;
+        table->size = 0;
+        for (auto& range : ranges) {
+            table->offsets.push_back(table->size);
+            table->size += range.last - range.first + 1;
+        }
+        return table;
+    };
+
+    // tables are shared by all samplers of the same class
+    static shared_ptr<Table> any = makeTable(toVector(anyRanges));
+    static shared_ptr<Table> letter = makeTable(toVector(letterRanges));
+    static shared_ptr<Table> digit = makeTable(toVector(digitRanges));
+    static shared_ptr<Table> combiningMark = makeTable(toVector(combiningMarkRanges));
+    static shared_ptr<Table> emoji = makeTable(toVector(emojiRanges));
+
+    switch (unicodeClass) {
+        case UnicodeClass::Letter:
+            return letter;
+        case UnicodeClass::Digit:
+            return digit;
+        case UnicodeClass::CombiningMark:
+            return combiningMark;
+        case UnicodeClass::Emoji:
+            return emoji;
+        default:
+            return any;
+    }
+}
+
+uint32_t CodePointSampler::codePointAt(uint32_t index) const
+{
+    // the last range starting at or before index
+    auto found = std::upper_bound(table->offsets.begin(), table->offsets.end(), index) - 1;
+    const CodePointRange& range = table->ranges[found - table->offsets.begin()];
+    return range.first + (index - *found);
+}
+
+bool CodePointSampler::contains(uint32_t code) const
+{
+    // the last range starting at or before code
+    auto found = std::upper_bound(table->ranges.begin(), table->ranges.end(), code,
+                                  [](uint32_t c, const CodePointRange& range) { return c < range.first; });
+    return found != table->ranges.begin() && code <= (found - 1)->last;
+}
+
+uint32_t CodePointSampler::operator()(Random& rand) const
+{
+    return codePointAt(rand.getRandomUInt32(0, table->size - 1));
+}
+
+void CodePointSampler::fill(Random& rand, uint32_t* out, size_t n) const
+{
+    // bytes are drawn into out itself, and each word is read before it is overwritten
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(out);
+    rand.getRandomBytes(reinterpret_cast<uint8_t*>(out), n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        // assembled in a fixed byte order, so that the code points of a seed do not depend on the platform
+        const uint8_t* b = bytes + i * sizeof(uint32_t);
+        uint32_t word = static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+                        (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+        // scaled by multiplication instead of division. a class has far fewer than 2^32 code points, so the bias is
+        // negligible (below 0.03% for `Any`)
+        out[i] = codePointAt(static_cast<uint32_t>((static_cast<uint64_t>(word) * table->size) >> 32));
+    }
+}
+
 Shrinkable<uint32_t> UnicodeGen::operator()(Random& rand)
 {
-    auto frontSize = 0xD7FF - 0x1 + 1;
-    auto rearSize = 0x10FFFF - 0xE000 + 1;
-    auto size = frontSize + rearSize;
-    auto frontGen = weightedGen<uint32_t>(interval<uint32_t>(0x1, 0xD7FF), static_cast<double>(frontSize) / size);
-    auto rearGen = weightedGen<uint32_t>(interval<uint32_t>(0xE000, 0x10FFFF), static_cast<double>(rearSize) / size);
-    static auto gen = oneOf<uint32_t>(frontGen, rearGen);
-    return gen(rand);
+    CodePointSampler sampler = this->sampler;
+    uint32_t index = rand.getRandomUInt32(0, sampler.size() - 1);
+    return util::binarySearchShrinkableU(index).map<uint32_t>(
+        [sampler](const uint64_t& i) { return sampler.codePointAt(static_cast<uint32_t>(i)); });
 }
 
 }  // namespace proptest
@@ -7,9 +7,68 @@
 
 namespace proptest {
 
-// PROPTEST_API Shrinkable<uint32_t> unicodeGen(Random& rand);
+/**
+ * @brief Classes of code points that `CodePointSampler` and `UnicodeGen` draw from
+ * @details Classes other than `Any` are representative subsets of Unicode general categories, listed as ranges of
+ * assigned code points
+ */
+enum class UnicodeClass {
+    Any,            // U+0001..U+10FFFF, excluding surrogates (default)
+    Letter,         // letters (L) of Latin, Greek, Cyrillic, Hebrew, Arabic, Devanagari, kana, CJK and Hangul
+    Digit,          // decimal digits (Nd) of 19 scripts
+    CombiningMark,  // nonspacing combining marks (Mn) of common scripts
+    Emoji,          // pictographs, emoticons and transport and map symbols
+};
+
+struct CodePointRange
+{
+    uint32_t first;
+    uint32_t last;
+};
+
+/**
+ * @brief Draws code points of a `UnicodeClass` uniformly, from a single random draw each
+ * @details A draw is scaled to an index over all code points of the class, which is mapped to a code point by searching
+ * the class's table of ranges
+ */
+class PROPTEST_API CodePointSampler {
+public:
+    explicit CodePointSampler(UnicodeClass unicodeClass = UnicodeClass::Any);
+
+    uint32_t operator()(Random& rand) const;
+    /// fills out[0..n) with code points, mapped from random bytes drawn at once
+    void fill(Random& rand, uint32_t* out, size_t n) const;
+
+    /// number of code points in the class
+    uint32_t size() const { return table->size; }
+    /// code point of given index in [0, size())
+    uint32_t codePointAt(uint32_t index) const;
+    /// whether the class has given code point
+    bool contains(uint32_t code) const;
+
+private:
+    // ranges with the index of their first code point
+    struct Table
+    {
+        vector<CodePointRange> ranges;
+        vector<uint32_t> offsets;
+        uint32_t size;
+    };
+
+    static shared_ptr<Table> getTable(UnicodeClass unicodeClass);
+
+    shared_ptr<Table> table;
+};
+
+/**
+ * @brief Generates code points of a `UnicodeClass`, shrinking towards the first code point of the class
+ */
 struct PROPTEST_API UnicodeGen {
+    explicit UnicodeGen(UnicodeClass unicodeClass = UnicodeClass::Any) : sampler(unicodeClass) {}
+
     Shrinkable<uint32_t> operator()(Random& rand);
+
+    CodePointSampler sampler;
 };
 
 }
@@ -12,16 +12,26 @@ namespace proptest {
 size_t Arbi<UTF16BEString>::defaultMinSize = 0;
 size_t Arbi<UTF16BEString>::defaultMaxSize = 200;
 
-Arbi<UTF16BEString>::Arbi() : ArbiContainer<UTF16BEString>(defaultMinSize, defaultMaxSize), elemGen(UnicodeGen()) {}
+Arbi<UTF16BEString>::Arbi() : Arbi(UnicodeClass::Any) {}
+
+// elemGen is left unset, so that the class is used unless elemGen is assigned later
+Arbi<UTF16BEString>::Arbi(UnicodeClass unicodeClass)
+    : ArbiContainer<UTF16BEString>(defaultMinSize, defaultMaxSize),
+      codePointSampler(util::make_shared<CodePointSampler>(unicodeClass)),
+      simplestChars(util::simplestCharsIn(
+          [this](char c) { return codePointSampler->contains(static_cast<uint32_t>(c)); }))
+{
+}
 
 Arbi<UTF16BEString>::Arbi(Arbi<uint32_t>& _elemGen)
     : ArbiContainer<UTF16BEString>(defaultMinSize, defaultMaxSize),
-      elemGen([_elemGen](Random& rand) mutable { return _elemGen(rand); })
+      elemGen([_elemGen](Random& rand) mutable { return _elemGen(rand); }),
+      simplestChars(util::SimplestNone)
 {
 }
 
 Arbi<UTF16BEString>::Arbi(GenFunction<uint32_t> _elemGen)
-    : ArbiContainer<UTF16BEString>(defaultMinSize, defaultMaxSize), elemGen(_elemGen)
+    : ArbiContainer<UTF16BEString>(defaultMinSize, defaultMaxSize), elemGen(_elemGen), simplestChars(util::SimplestNone)
 {
 }
 
@@ -37,59 +47,74 @@ Arbi<UTF16BEString>::Arbi(GenFunction<uint32_t> _elemGen)
  */
 Shrinkable<UTF16BEString> Arbi<UTF16BEString>::operator()(Random& rand)
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
-    vector<uint8_t> chars /*, allocator()*/;
-    vector<int> positions /*, allocator()*/;
-    vector<uint32_t> codes;
-
-    chars.reserve(len * 4 + 2);
-    codes.reserve(len);
-    positions.reserve(len);
-
-    // cout << "UTF16 BE gen, len = " << len << endl;
-
+    size_t len = rand.getScaledSize(minSize, maxSize);
+    // byte offsets of characters and the end, used by the shrinker
+    vector<int> positions;
+    positions.reserve(len + 1);
+
+    // encoded in place, in a buffer sized for the longest encoding of len characters
+    UTF16BEString str(len * 4, '\0');
+    uint8_t* out = reinterpret_cast<uint8_t*>(&str[0]);
+    size_t size = 0;
+    if (!elemGen && !codePointSampler)
+        throw runtime_error("elemGen is not set");
+    // an element generator takes precedence over the class
+    const bool useSampler = !elemGen;
+    // code points drawn in bulk from the sampler, if used
+    uint32_t codes[64];
     for (size_t i = 0; i < len; i++) {
+        if (useSampler && i % 64 == 0)
+            codePointSampler->fill(rand, codes, std::min<size_t>(64, len - i));
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.get();
-        positions.push_back(chars.size());
-        codes.push_back(code);
-        util::encodeUTF16BE(code, chars);
+        uint32_t code = useSampler ? codes[i % 64] : elemGen(rand).get();
+        size_t codeSize = util::UTF16EncodedSize(code);
+        positions.push_back(static_cast<int>(size));
+        util::encodeUTF16BE(code, out + size);
+        size += codeSize;
     }
-    positions.push_back(chars.size());
-    chars.push_back(0);
-    chars.push_back(0);
+    positions.push_back(static_cast<int>(size));
+    // without a terminator, so that shrinking counts only the generated characters
+    str.resize(size);
 
-    if (!util::isValidUTF16BE(chars)) {
+#ifndef NDEBUG
+    if (util::UTF16BECharSize(str) < 0) {
         stringstream os;
         os << "not a valid UTF-16 BE string: ";
-        for (size_t i = 0; i < chars.size(); i++) {
-            os << static_cast<int>(chars[i]) << " ";
+        for (size_t i = 0; i < str.size(); i++) {
+            os << static_cast<int>(static_cast<uint8_t>(str[i])) << " ";
         }
         throw runtime_error(os.str());
     }
+#endif
 
-    UTF16BEString str(chars.size(), ' ' /*, allocator()*/);
-    for (size_t i = 0; i < chars.size(); i++) {
-        str[i] = chars[i];
-    }
-
-    return shrinkStringLike<UTF16BEString>(str, minSize, len, positions);
+    // simplified only to characters of the class, as the range of an element generator is unknown
+    return shrinkStringLike<UTF16BEString>(str, minSize, len, positions,
+                                    useSampler ? simplestChars : static_cast<uint8_t>(util::SimplestNone));
 }
 
 size_t Arbi<UTF16LEString>::defaultMinSize = 0;
 size_t Arbi<UTF16LEString>::defaultMaxSize = 200;
 
-Arbi<UTF16LEString>::Arbi() : ArbiContainer<UTF16LEString>(defaultMinSize, defaultMaxSize), elemGen(UnicodeGen()) {}
+Arbi<UTF16LEString>::Arbi() : Arbi(UnicodeClass::Any) {}
+
+// elemGen is left unset, so that the class is used unless elemGen is assigned later
+Arbi<UTF16LEString>::Arbi(UnicodeClass unicodeClass)
+    : ArbiContainer<UTF16LEString>(defaultMinSize, defaultMaxSize),
+      codePointSampler(util::make_shared<CodePointSampler>(unicodeClass)),
+      simplestChars(util::simplestCharsIn(
+          [this](char c) { return codePointSampler->contains(static_cast<uint32_t>(c)); }))
+{
+}
 
 Arbi<UTF16LEString>::Arbi(Arbi<uint32_t>& _elemGen)
     : ArbiContainer<UTF16LEString>(defaultMinSize, defaultMaxSize),
-      elemGen([_elemGen](Random& rand) mutable { return _elemGen(rand); })
+      elemGen([_elemGen](Random& rand) mutable { return _elemGen(rand); }),
+      simplestChars(util::SimplestNone)
 {
 }
 
 Arbi<UTF16LEString>::Arbi(GenFunction<uint32_t> _elemGen)
-    : ArbiContainer<UTF16LEString>(defaultMinSize, defaultMaxSize), elemGen(_elemGen)
+    : ArbiContainer<UTF16LEString>(defaultMinSize, defaultMaxSize), elemGen(_elemGen), simplestChars(util::SimplestNone)
 {
 }
 
@@ -105,54 +130,49 @@ Arbi<UTF16LEString>::Arbi(GenFunction<uint32_t> _elemGen)
  */
 Shrinkable<UTF16LEString> Arbi<UTF16LEString>::operator()(Random& rand)
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
-    vector<uint8_t> chars /*, allocator()*/;
-    vector<int> positions /*, allocator()*/;
-    vector<uint32_t> codes;
-
-    chars.reserve(len * 4);
-    codes.reserve(len);
-    positions.reserve(len);
-
-    // cout << "UTF16 LE gen, len = " << len << endl;
-
+    size_t len = rand.getScaledSize(minSize, maxSize);
+    // byte offsets of characters and the end, used by the shrinker
+    vector<int> positions;
+    positions.reserve(len + 1);
+
+    // encoded in place, in a buffer sized for the longest encoding of len characters
+    UTF16LEString str(len * 4, '\0');
+    uint8_t* out = reinterpret_cast<uint8_t*>(&str[0]);
+    size_t size = 0;
+    if (!elemGen && !codePointSampler)
+        throw runtime_error("elemGen is not set");
+    // an element generator takes precedence over the class
+    const bool useSampler = !elemGen;
+    // code points drawn in bulk from the sampler, if used
+    uint32_t codes[64];
     for (size_t i = 0; i < len; i++) {
+        if (useSampler && i % 64 == 0)
+            codePointSampler->fill(rand, codes, std::min<size_t>(64, len - i));
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.get();
-        positions.push_back(chars.size());
-        codes.push_back(code);
-        util::encodeUTF16LE(code, chars);
+        uint32_t code = useSampler ? codes[i % 64] : elemGen(rand).get();
+        size_t codeSize = util::UTF16EncodedSize(code);
+        positions.push_back(static_cast<int>(size));
+        util::encodeUTF16LE(code, out + size);
+        size += codeSize;
     }
-    positions.push_back(chars.size());
-    chars.push_back(0);
-    chars.push_back(0);
+    positions.push_back(static_cast<int>(size));
+    // without a terminator, so that shrinking counts only the generated characters
+    str.resize(size);
 
-    if (!util::isValidUTF16LE(chars)) {
+#ifndef NDEBUG
+    if (util::UTF16LECharSize(str) < 0) {
         stringstream os;
         os << "not a valid UTF-16 LE string: ";
-        printf("not a valid UTF-16 LE string: ");
-        for (size_t i = 0; i < chars.size(); i++) {
-            os << static_cast<int>(chars[i]) << " ";
-            printf("%x ", chars[i]);
+        for (size_t i = 0; i < str.size(); i++) {
+            os << static_cast<int>(static_cast<uint8_t>(str[i])) << " ";
         }
-        printf("\n");
-
         throw runtime_error(os.str());
     }
+#endif
 
-    // cout << "hex = {";
-    // util::UTF16LEToHex(cout, chars);
-    // cout << "}, decoded = \"";
-    // util::decodeUTF16LE(cout, chars);
-    // cout << "\"" << endl;
-
-    UTF16LEString str(chars.size(), ' ' /*, allocator()*/);
-    for (size_t i = 0; i < chars.size(); i++) {
-        str[i] = chars[i];
-    }
-
-    return shrinkStringLike<UTF16LEString>(str, minSize, len, positions);
+    // simplified only to characters of the class, as the range of an element generator is unknown
+    return shrinkStringLike<UTF16LEString>(str, minSize, len, positions,
+                                    useSampler ? simplestChars : static_cast<uint8_t>(util::SimplestNone));
 }
 
 }  // namespace proptest
@@ -12,16 +12,26 @@ namespace proptest {
 size_t Arbi<UTF8String>::defaultMinSize = 0;
 size_t Arbi<UTF8String>::defaultMaxSize = 200;
 
-Arbi<UTF8String>::Arbi() : ArbiContainer<UTF8String>(defaultMinSize, defaultMaxSize), elemGen(UnicodeGen()) {}
+Arbi<UTF8String>::Arbi() : Arbi(UnicodeClass::Any) {}
+
+// elemGen is left unset, so that the class is used unless elemGen is assigned later
+Arbi<UTF8String>::Arbi(UnicodeClass unicodeClass)
+    : ArbiContainer<UTF8String>(defaultMinSize, defaultMaxSize),
+      codePointSampler(util::make_shared<CodePointSampler>(unicodeClass)),
+      simplestChars(util::simplestCharsIn(
+          [this](char c) { return codePointSampler->contains(static_cast<uint32_t>(c)); }))
+{
+}
 
 Arbi<UTF8String>::Arbi(Arbi<uint32_t>& _elemGen)
     : ArbiContainer<UTF8String>(defaultMinSize, defaultMaxSize),
-      elemGen([_elemGen](Random& rand) mutable { return _elemGen(rand); })
+      elemGen([_elemGen](Random& rand) mutable { return _elemGen(rand); }),
+      simplestChars(util::SimplestNone)
 {
 }
 
 Arbi<UTF8String>::Arbi(GenFunction<uint32_t> _elemGen)
-    : ArbiContainer<UTF8String>(defaultMinSize, defaultMaxSize), elemGen(_elemGen)
+    : ArbiContainer<UTF8String>(defaultMinSize, defaultMaxSize), elemGen(_elemGen), simplestChars(util::SimplestNone)
 {
 }
 
@@ -42,54 +52,48 @@ Arbi<UTF8String>::Arbi(GenFunction<uint32_t> _elemGen)
  */
 Shrinkable<UTF8String> Arbi<UTF8String>::operator()(Random& rand)
 {
-    size_t len = rand.getRandomSize(minSize, maxSize + 1);
-    vector<uint8_t> chars /*, allocator()*/;
-    vector<int> positions /*, allocator()*/;
-    vector<uint32_t> codes;
-
-    chars.reserve(len * 4);
-    codes.reserve(len);
-    positions.reserve(len);
-
-    // cout << "utf8 gen, len = " << len << endl;
-
+    size_t len = rand.getScaledSize(minSize, maxSize);
+    // byte offsets of characters and the end, used by the shrinker
+    vector<int> positions;
+    positions.reserve(len + 1);
+
+    // encoded in place, in a buffer sized for the longest encoding of len characters
+    UTF8String str(len * 4, '\0');
+    uint8_t* out = reinterpret_cast<uint8_t*>(&str[0]);
+    size_t size = 0;
+    if (!elemGen && !codePointSampler)
+        throw runtime_error("elemGen is not set");
+    // an element generator takes precedence over the class
+    const bool useSampler = !elemGen;
+    // code points drawn in bulk from the sampler, if used
+    uint32_t codes[64];
     for (size_t i = 0; i < len; i++) {
+        if (useSampler && i % 64 == 0)
+            codePointSampler->fill(rand, codes, std::min<size_t>(64, len - i));
         // U+D800..U+DFFF is forbidden for surrogate use
-        Shrinkable<uint32_t> codeShr = elemGen(rand);
-        uint32_t code = codeShr.get();
-
-        positions.push_back(chars.size());
-        codes.push_back(code);
-
-        util::encodeUTF8(code, chars);
+        uint32_t code = useSampler ? codes[i % 64] : elemGen(rand).get();
+        size_t codeSize = util::UTF8EncodedSize(code);
+        positions.push_back(static_cast<int>(size));
+        util::encodeUTF8(code, out + size);
+        size += codeSize;
     }
-    positions.push_back(chars.size());
+    positions.push_back(static_cast<int>(size));
+    str.resize(size);
 
-    if (!util::isValidUTF8(chars)) {
+#ifndef NDEBUG
+    if (util::UTF8CharSize(str) < 0) {
         stringstream os;
         os << "not a valid UTF-8 string: ";
-        printf("not a valid UTF-8 string: ");
-        for (size_t i = 0; i < chars.size(); i++) {
-            os << static_cast<int>(chars[i]) << " ";
-            printf("%x ", chars[i]);
+        for (size_t i = 0; i < str.size(); i++) {
+            os << static_cast<int>(static_cast<uint8_t>(str[i])) << " ";
         }
-        printf("\n");
-
         throw runtime_error(os.str());
     }
+#endif
 
-    // cout << "hex = {";
-    // util::UTF8ToHex(cout, chars);
-    // cout << "}, decoded = \"";
-    // util::decodeUTF8(cout, chars);
-    // cout << "\"" << endl;
-
-    UTF8String str(chars.size(), ' ' /*, allocator()*/);
-    for (size_t i = 0; i < chars.size(); i++) {
-        str[i] = chars[i];
-    }
-
-    return shrinkStringLike<UTF8String>(str, minSize, len, positions);
+    // simplified only to characters of the class, as the range of an element generator is unknown
+    return shrinkStringLike<UTF8String>(str, minSize, len, positions,
+                                    useSampler ? simplestChars : static_cast<uint8_t>(util::SimplestNone));
 }
 
 }  // namespace proptest
@@ -12,6 +12,54 @@ namespace util {
 PROPTEST_API Shrinkable<int64_t> binarySearchShrinkable(int64_t value);
 PROPTEST_API Shrinkable<uint64_t> binarySearchShrinkableU(uint64_t value);
 
+/// * private
+template <typename T>
+T integralOffset(T target, bool below, uint64_t distance)
+{
+    uint64_t base = static_cast<uint64_t>(target);
+    return static_cast<T>(below ? base - distance : base + distance);
+}
+
+/// * private
+template <typename T>
+Stream<Shrinkable<T>> integralShrinksBetween(T target, bool below, uint64_t min, uint64_t max)
+{
+    using stream_t = Stream<Shrinkable<T>>;
+    if (min + 1 >= max)
+        return stream_t::empty();
+
+    uint64_t mid = min / 2 + max / 2 + ((min % 2 != 0 && max % 2 != 0) ? 1 : 0);
+    auto shrinkable = make_shrinkable<T>(integralOffset(target, below, mid));
+    if (min + 2 >= max)
+        return stream_t(shrinkable);
+
+    return stream_t(shrinkable.with([=]() { return integralShrinksBetween(target, below, min, mid); }),
+                    [=]() { return integralShrinksBetween(target, below, mid, max); });
+}
+
+/**
+ * @brief Shrinkable for an integral value that shrinks towards `target` by binary search
+ * @details Yields the same candidates in the same order as `binarySearchShrinkable(value - target)` mapped back by
+ * adding `target`, but each node is built directly in `T` from its distance bounds to `target`, instead of mapping a
+ * tree of `int64_t` nodes.
+ */
+template <typename T>
+Shrinkable<T> integralShrinkable(T value, T target)
+{
+    using stream_t = Stream<Shrinkable<T>>;
+    const bool below = value < target;
+    const uint64_t distance = below ? static_cast<uint64_t>(target) - static_cast<uint64_t>(value)
+                                    : static_cast<uint64_t>(value) - static_cast<uint64_t>(target);
+    auto shrinkable = make_shrinkable<T>(value);
+    if (distance == 0)
+        return shrinkable;
+
+    return shrinkable.with([target, below, distance]() {
+        return stream_t(make_shrinkable<T>(target),
+                        [=]() { return integralShrinksBetween(target, below, 0, distance); });
+    });
+}
+
 template <typename T>
 decltype(auto) GetShrinksHelper(const Shrinkable<T>& shr)
 {
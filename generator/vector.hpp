@@ -18,32 +18,51 @@ public:
     static size_t defaultMinSize;
     static size_t defaultMaxSize;
 
-    Arbi() : ArbiContainer<vector<T>>(defaultMinSize, defaultMaxSize), elemGen(Arbi<T>()) {}
+    Arbi()
+        : ArbiContainer<vector<T>>(defaultMinSize, defaultMaxSize),
+          elemGen(Arbi<T>()),
+          membershipShrink(MembershipShrink::FrontAndMid)
+    {
+    }
 
     Arbi(const Arbi<T>& _elemGen)
         : ArbiContainer<vector<T>>(defaultMinSize, defaultMaxSize),
-          elemGen([_elemGen](Random& rand) -> Shrinkable<T> { return _elemGen(rand); })
+          elemGen([_elemGen](Random& rand) -> Shrinkable<T> { return _elemGen(rand); }),
+          membershipShrink(MembershipShrink::FrontAndMid)
     {
     }
 
-    Arbi(GenFunction<T> _elemGen) : ArbiContainer<vector<T>>(defaultMinSize, defaultMaxSize), elemGen(_elemGen) {}
+    Arbi(GenFunction<T> _elemGen)
+        : ArbiContainer<vector<T>>(defaultMinSize, defaultMaxSize),
+          elemGen(_elemGen),
+          membershipShrink(MembershipShrink::FrontAndMid)
+    {
+    }
 
     Shrinkable<vector<T>> operator()(Random& rand) override
     {
         using vector_t = vector<Shrinkable<T>>;
-        size_t size = rand.getRandomSize(minSize, maxSize + 1);
+        size_t size = rand.getScaledSize(minSize, maxSize);
         shared_ptr<vector_t> shrinkVec = util::make_shared<vector_t>();
         shrinkVec->reserve(size);
         for (size_t i = 0; i < size; i++)
             shrinkVec->push_back(elemGen(rand));
 
-        auto result = shrinkListLike<vector, T>(shrinkVec, minSize);
+        auto result = shrinkListLike<vector, T>(shrinkVec, minSize, true, membershipShrink);
         return result;
     }
 
+    // strategy of removing elements in shrinking
+    Arbi& setMembershipShrink(MembershipShrink strategy)
+    {
+        membershipShrink = strategy;
+        return *this;
+    }
+
     // FIXME: turn to shared_ptr
 private:
     GenFunction<T> elemGen;
+    MembershipShrink membershipShrink;
 };
 
 template <typename T>
@@ -23,6 +23,7 @@
 #include "combinator/elementof.hpp"
 #include "combinator/oneof.hpp"
 #include "combinator/intervals.hpp"
+#include "combinator/constrained.hpp"
 #include "combinator/dependency.hpp"
 #include "combinator/chain.hpp"
 #include "combinator/derive.hpp"
@@ -44,11 +44,11 @@ Stream<Shrinkable<FLOATTYPE>> shrinkFloat(FLOATTYPE value)
     int exp = 0;
     if (value == 0.0f) {
         return Stream<Shrinkable<FLOATTYPE>>::empty();
-    } else if (isnan(value)) {
+    } else if (std::isnan(value)) {
         return Stream<Shrinkable<FLOATTYPE>>::one(make_shrinkable<FLOATTYPE>(0.0f));
     } else {
         FLOATTYPE fraction = 0.0f;
-        if (isinf(value)) {
+        if (std::isinf(value)) {
             if (value > 0) {
                 auto max = numeric_limits<FLOATTYPE>::max();
                 fraction = util::decomposeFloat(max, &exp);
@@ -5,6 +5,16 @@
 
 namespace proptest {
 
+/**
+ * @brief Strategy of membership-wise shrinking, i.e. removing elements from a container
+ */
+enum class MembershipShrink {
+    // removes as many front elements as possible, and then middle ranges (default)
+    FrontAndMid,
+    // delta debugging (ddmin): removes chunks of halving size
+    DeltaDebugging,
+};
+
 namespace util {
 
 template <typename T>
@@ -65,7 +75,7 @@ struct VectorShrinker
         };
 
         size_t parentSize = ancestor.getRef().size();
-        size_t numSplits = static_cast<size_t>(pow(2, power));
+        size_t numSplits = static_cast<size_t>(1) << power;
         if (parentSize / numSplits < 1)
             return stream_t::empty();
 
@@ -75,9 +85,6 @@ struct VectorShrinker
         size_t frompos = parentSize * offset / numSplits;
         size_t topos = parentSize * (offset + 1) / numSplits;
 
-        if (topos < parentSize)
-            throw runtime_error("topos error: " + to_string(topos) + " != " + to_string(parentSize));
-
         const size_t size = topos - frompos;
         shrinkable_vector_t& parentVec = ancestor.getRef();
         shared_ptr<vector<e_stream_t>> elemStreams = util::make_shared<vector<e_stream_t>>();
@@ -97,129 +104,190 @@ struct VectorShrinker
         return genStream(ancestor, power, offset, ancestor, frompos, topos, elemStreams);
     }
 
+    /**
+     * @brief Element-wise shrinks of partitions at increasing granularity
+     * @details Elements of partition `offset` of 2^`power` partitions are shrunk together, and then the following
+     * partitions at the same granularity, and then the partitions of half the size, down to single elements. A
+     * shrink found in a partition continues within the same partition only, so that the shrink tree grows with the
+     * number of partitions instead of the product of the element trees.
+     */
     static stream_t shrinkElementwise(const shrinkable_t& shrinkable, size_t power, size_t offset)
     {
-        if (shrinkable.getRef().empty())
-            return stream_t::empty();
-
-        size_t vecSize = shrinkable.getRef().size();
-        size_t numSplits = static_cast<size_t>(pow(2, power));
-        if (vecSize / numSplits < 1 || offset >= numSplits)
-            return stream_t::empty();
-        // entirety
-        shrinkable_t newShrinkable = shrinkable.concat([power, offset](const shrinkable_t& shr) -> stream_t {
-            size_t _vecSize = shr.getRef().size();
-            size_t _numSplits = static_cast<size_t>(pow(2, power));
-            if (_vecSize / _numSplits < 1 || offset >= _numSplits)
-                return stream_t::empty();
-            // cout << "entire: " << power << ", " << offset << endl;
-            return shrinkBulk(shr, power, offset);
-        });
+        const size_t vecSize = shrinkable.getRef().size();
+        // skip partitions with nothing to shrink
+        while (power < 64 && vecSize >> power >= 1) {
+            const size_t numSplits = static_cast<size_t>(1) << power;
+            const size_t nextPower = offset + 1 < numSplits ? power : power + 1;
+            const size_t nextOffset = offset + 1 < numSplits ? offset + 1 : 0;
+            stream_t bulk = shrinkBulk(shrinkable, power, offset);
+            if (!bulk.isEmpty()) {
+                return concatLazily(bulk, [shrinkable, nextPower, nextOffset]() {
+                    return shrinkElementwise(shrinkable, nextPower, nextOffset);
+                });
+            }
+            power = nextPower;
+            offset = nextOffset;
+        }
+        return stream_t::empty();
+    }
 
-        return newShrinkable.shrinks();
+    /// `stream` followed by the stream returned by `then`, which is called only when `stream` is exhausted
+    static stream_t concatLazily(const stream_t& stream, function<stream_t()> then)
+    {
+        if (stream.isEmpty())
+            return then();
+        return stream_t(stream.head(), [stream, then]() { return concatLazily(stream.tail(), then); });
     }
+};
 
-    static shrinkable_t shrinkMid(shared_ptr<vector<Shrinkable<T>>> shrinkableCont, size_t minSize, size_t frontSize, size_t rearSize) {
-        // remove mid as much as possible
-        size_t minRearSize = minSize >= frontSize ? minSize - frontSize : 0;
-        size_t maxRearSize = shrinkableCont->size() - frontSize;
-        // rear size within [minRearSize, minRearSize]
-        auto rangeShrinkable = util::binarySearchShrinkable(maxRearSize - minRearSize).template map<size_t>([minRearSize](const size_t& s) { return s + minRearSize; });
-        return rangeShrinkable.template flatMap<vector<Shrinkable<T>>>([shrinkableCont, frontSize](const size_t& rearSize) {
-            // concat front and rear
-            auto cont = util::make_shared<vector<Shrinkable<T>>>(shrinkableCont->begin(), shrinkableCont->begin() + frontSize);
-            cont->insert(cont->end(), shrinkableCont->begin() + (cont->size()-rearSize), shrinkableCont->end());
-            return Shrinkable<vector<Shrinkable<T>>>(cont);
-        }).concat([minSize, frontSize, rearSize](const shrinkable_t& parent) {
-            size_t parentSize = parent.getRef().size();
-            // no further shrinking possible
-            if(parentSize <= minSize || parentSize <= frontSize)
-                return Stream<Shrinkable<vector<Shrinkable<T>>>>::empty();
-            return shrinkMid(parent.getSharedPtr(), minSize, frontSize + 1, rearSize).shrinks();
-        });
+/**
+ * @brief Elements of a membership-wise shrunk container, as index ranges into the elements of the original container
+ * @details A candidate of membership-wise shrinking is derived from its parent by removing a range of elements. Keeping
+ * the remaining ranges instead of copying the elements makes building a candidate cost O(number of ranges) instead of
+ * O(size). The concrete container is built from the view only when its shrinkable is created, i.e. when the candidate is
+ * about to be tested.
+ */
+template <typename T>
+class ShrinkableElementsView {
+public:
+    using elements_t = vector<Shrinkable<T>>;
+    using range_t = pair<size_t, size_t>;  // [from, to) of the original elements
+
+    explicit ShrinkableElementsView(const shared_ptr<elements_t>& _elements)
+        : elements(_elements), ranges(util::make_shared<vector<range_t>>()), numElements(_elements->size())
+    {
+        if (numElements > 0)
+            ranges->push_back(range_t(0, numElements));
     }
 
-    static shrinkable_t shrinkFrontAndThenMid(shared_ptr<vector<Shrinkable<T>>> shrinkableCont, size_t minSize, size_t rearSize) {
-        // remove front as much as possible
-        size_t minFrontSize = minSize >= rearSize ? minSize - rearSize : 0;
-        size_t maxFrontSize = shrinkableCont->size() - rearSize;
-        // front size within [min,max]
-        auto rangeShrinkable = util::binarySearchShrinkable(maxFrontSize - minFrontSize).template map<size_t>([minFrontSize](const size_t& s) { return s + minFrontSize; });
-        return rangeShrinkable.template flatMap<vector<Shrinkable<T>>>([shrinkableCont, maxFrontSize](const size_t& frontSize) {
-            // concat front and rear
-            auto cont = util::make_shared<vector<Shrinkable<T>>>(shrinkableCont->begin(), shrinkableCont->begin() + frontSize);
-            cont->insert(cont->end(), shrinkableCont->begin() + maxFrontSize, shrinkableCont->end());
-            return Shrinkable<vector<Shrinkable<T>>>(cont);
-        }).concat([minSize, rearSize](const shrinkable_t& parent) {
-            // reduce front [0,size-rearSize-1] as much possible
-            size_t parentSize = parent.getRef().size();
-            // no further shrinking possible
-            if(parentSize <= minSize || parentSize <= rearSize) {
-                // try shrinking mid
-                if(minSize < parentSize && rearSize + 1 < parentSize)
-                    return shrinkMid(parent.getSharedPtr(), minSize, 1, rearSize + 1).shrinks();
-                else
-                    return Stream<Shrinkable<vector<Shrinkable<T>>>>::empty();
+    size_t size() const { return numElements; }
+
+    /// view without the elements in [frompos, topos) of this view
+    ShrinkableElementsView withoutRange(size_t frompos, size_t topos) const
+    {
+        auto newRanges = util::make_shared<vector<range_t>>();
+        newRanges->reserve(ranges->size() + 1);
+        size_t pos = 0;
+        for (auto& range : *ranges) {
+            const size_t rangeSize = range.second - range.first;
+            // part before frompos
+            if (pos < frompos) {
+                size_t keep = frompos - pos < rangeSize ? frompos - pos : rangeSize;
+                newRanges->push_back(range_t(range.first, range.first + keep));
             }
-            // shrink front further by fixing last element in front to rear
-            // [1,[2,3,4]]
-            // [[1,2,3],4]
-            // [[1,2],3,4]
-            return shrinkFrontAndThenMid(parent.getSharedPtr(), minSize, rearSize + 1).shrinks();
-        });
+            // part from topos
+            if (pos + rangeSize > topos) {
+                size_t skip = topos > pos ? topos - pos : 0;
+                addRange(*newRanges, range_t(range.first + skip, range.second));
+            }
+            pos += rangeSize;
+        }
+        return ShrinkableElementsView(elements, newRanges, numElements - (topos - frompos));
+    }
+
+    template <typename F>
+    void forEach(F&& f) const
+    {
+        for (auto& range : *ranges) {
+            for (size_t i = range.first; i < range.second; i++)
+                f((*elements)[i]);
+        }
+    }
+
+    shared_ptr<elements_t> toVector() const
+    {
+        if (ranges->size() == 1 && numElements == elements->size())
+            return elements;
+        auto vec = util::make_shared<elements_t>();
+        vec->reserve(numElements);
+        forEach([&vec](const Shrinkable<T>& elem) { vec->push_back(elem); });
+        return vec;
     }
 
+private:
+    ShrinkableElementsView(const shared_ptr<elements_t>& _elements, const shared_ptr<vector<range_t>>& _ranges,
+                           size_t _numElements)
+        : elements(_elements), ranges(_ranges), numElements(_numElements)
+    {
+    }
+
+    // appends a range, merging it with the last one if adjacent
+    static void addRange(vector<range_t>& ranges, const range_t& range)
+    {
+        if (range.first == range.second)
+            return;
+        if (!ranges.empty() && ranges.back().second == range.first)
+            ranges.back().second = range.second;
+        else
+            ranges.push_back(range);
+    }
+
+    shared_ptr<elements_t> elements;
+    shared_ptr<vector<range_t>> ranges;
+    size_t numElements;
 };
 
-template <template <typename...> class Container, typename T>
-struct ContainerShrinker
+/// * private: reserves capacity for containers that support it
+template <typename T>
+void reserveElements(vector<T>& cont, size_t size)
 {
-    using shrinkable_cont_t = Container<Shrinkable<T>>;
-    using shrinkable_t = Shrinkable<shrinkable_cont_t>;
+    cont.reserve(size);
+}
 
-    static shrinkable_t shrinkMid(shared_ptr<Container<Shrinkable<T>>> shrinkableCont, size_t minSize, size_t frontSize, size_t rearSize) {
+/// * private
+template <typename Container>
+void reserveElements(Container&, size_t)
+{
+}
+
+/// * private: builds a container of the values of the elements in a view
+template <typename Container, typename T>
+Shrinkable<Container> materializeElements(const ShrinkableElementsView<T>& view)
+{
+    auto value = make_shrinkable<Container>();
+    Container& cont = value.getRef();
+    reserveElements(cont, view.size());
+    view.forEach([&cont](const Shrinkable<T>& elem) { cont.insert(cont.end(), elem.getRef()); });
+    return value;
+}
+
+/**
+ * @brief Membership-wise shrinking that removes as many front elements as possible, and then middle ranges
+ */
+template <typename T>
+struct FrontAndMidShrinker
+{
+    using view_t = ShrinkableElementsView<T>;
+    using shrinkable_t = Shrinkable<view_t>;
+    using stream_t = Stream<shrinkable_t>;
+
+    static shrinkable_t shrinkMid(const view_t& view, size_t minSize, size_t frontSize, size_t rearSize) {
         // remove mid as much as possible
         size_t minRearSize = minSize >= frontSize ? minSize - frontSize : 0;
-        size_t maxRearSize = shrinkableCont->size() - frontSize;
-        // rear size within [minRearSize, minRearSize]
+        size_t maxRearSize = view.size() - frontSize;
+        // rear size within [minRearSize, maxRearSize]
         auto rangeShrinkable = util::binarySearchShrinkable(maxRearSize - minRearSize).template map<size_t>([minRearSize](const size_t& s) { return s + minRearSize; });
-        return rangeShrinkable.template flatMap<Container<Shrinkable<T>>>([shrinkableCont, frontSize](const size_t& rearSize) {
+        return rangeShrinkable.template flatMap<view_t>([view, frontSize](const size_t& _rearSize) {
             // concat front and rear
-            // auto cont = util::make_shared<Container<Shrinkable<T>>>(shrinkableCont->begin(), shrinkableCont->begin() + frontSize);
-            // cont->insert(cont->end(), shrinkableCont->begin() + (cont->size()-rearSize), shrinkableCont->end());
-            auto cont = util::make_shared<Container<Shrinkable<T>>>();
-            size_t i = 0;
-            for(auto itr = shrinkableCont->begin(); itr != shrinkableCont->end(); ++itr, ++i) {
-                if(i < frontSize || i >= cont->size() - rearSize)
-                    cont->insert(*itr);
-            }
-            return Shrinkable<Container<Shrinkable<T>>>(cont);
+            return make_shrinkable<view_t>(view.withoutRange(frontSize, view.size() - _rearSize));
         }).concat([minSize, frontSize, rearSize](const shrinkable_t& parent) {
             size_t parentSize = parent.getRef().size();
             // no further shrinking possible
             if(parentSize <= minSize || parentSize <= frontSize)
-                return Stream<Shrinkable<Container<Shrinkable<T>>>>::empty();
-            return shrinkMid(parent.getSharedPtr(), minSize, frontSize + 1, rearSize).shrinks();
+                return stream_t::empty();
+            return shrinkMid(parent.getRef(), minSize, frontSize + 1, rearSize).shrinks();
         });
     }
 
-    static shrinkable_t shrinkFrontAndThenMid(shared_ptr<Container<Shrinkable<T>>> shrinkableCont, size_t minSize, size_t rearSize) {
+    static shrinkable_t shrinkFrontAndThenMid(const view_t& view, size_t minSize, size_t rearSize) {
         // remove front as much as possible
         size_t minFrontSize = minSize >= rearSize ? minSize - rearSize : 0;
-        size_t maxFrontSize = shrinkableCont->size() - rearSize;
+        size_t maxFrontSize = view.size() - rearSize;
         // front size within [min,max]
         auto rangeShrinkable = util::binarySearchShrinkable(maxFrontSize - minFrontSize).template map<size_t>([minFrontSize](const size_t& s) { return s + minFrontSize; });
-        return rangeShrinkable.template flatMap<Container<Shrinkable<T>>>([shrinkableCont, maxFrontSize](const size_t& frontSize) {
+        return rangeShrinkable.template flatMap<view_t>([view, maxFrontSize](const size_t& frontSize) {
             // concat front and rear
-            // auto cont = util::make_shared<Container<Shrinkable<T>>>(shrinkableCont->begin(), shrinkableCont->begin() + frontSize);
-            // cont->insert(cont->end(), shrinkableCont->begin() + maxFrontSize, shrinkableCont->end());
-            auto cont = util::make_shared<Container<Shrinkable<T>>>();
-            size_t i = 0;
-            for(auto itr = shrinkableCont->begin(); itr != shrinkableCont->end(); ++itr, ++i) {
-                if(i < frontSize || i >= maxFrontSize)
-                    cont->insert(*itr);
-            }
-            return Shrinkable<Container<Shrinkable<T>>>(cont);
+            return make_shrinkable<view_t>(view.withoutRange(frontSize, maxFrontSize));
         }).concat([minSize, rearSize](const shrinkable_t& parent) {
             // reduce front [0,size-rearSize-1] as much possible
             size_t parentSize = parent.getRef().size();
@@ -227,30 +295,113 @@ struct ContainerShrinker
             if(parentSize <= minSize || parentSize <= rearSize) {
                 // try shrinking mid
                 if(minSize < parentSize && rearSize + 1 < parentSize)
-                    return shrinkMid(parent.getSharedPtr(), minSize, 1, rearSize + 1).shrinks();
+                    return shrinkMid(parent.getRef(), minSize, 1, rearSize + 1).shrinks();
                 else
-                    return Stream<Shrinkable<Container<Shrinkable<T>>>>::empty();
+                    return stream_t::empty();
             }
             // shrink front further by fixing last element in front to rear
             // [1,[2,3,4]]
             // [[1,2,3],4]
             // [[1,2],3,4]
-            return shrinkFrontAndThenMid(parent.getSharedPtr(), minSize, rearSize + 1).shrinks();
+            return shrinkFrontAndThenMid(parent.getRef(), minSize, rearSize + 1).shrinks();
         });
     }
 };
 
+/**
+ * @brief Delta debugging (ddmin) membership-wise shrinking
+ * @details A container split into n chunks is shrunk by removing each chunk in turn. A smaller container found this way
+ * is shrunk further from n-1 chunks, starting from the chunk following the removed one, since the chunks before it are
+ * likely needed. If no chunk can be removed, the same container is split into 2n chunks, until each chunk is a single
+ * element. Failures caused by a few scattered elements of a large container are isolated with a number of candidates
+ * logarithmic in the container size, instead of building the candidates of all contiguous ranges.
+ */
+template <typename T>
+struct DeltaDebuggingShrinker
+{
+    using view_t = ShrinkableElementsView<T>;
+    using shrinkable_t = Shrinkable<view_t>;
+    using stream_t = Stream<shrinkable_t>;
+
+    static shrinkable_t shrink(const view_t& view, size_t minSize)
+    {
+        return make_shrinkable<view_t>(view).with([view, minSize]() { return shrinks(view, minSize, 2, 0); });
+    }
+
+    static stream_t shrinks(const view_t& view, size_t minSize, size_t numChunks, size_t startChunk)
+    {
+        const size_t size = view.size();
+        if (size == 0 || size <= minSize)
+            return stream_t::empty();
+        numChunks = numChunks < size ? numChunks : size;
+        return candidates(view, minSize, numChunks, startChunk % numChunks, 0);
+    }
+
+private:
+    // removes the `index`-th chunk counted cyclically from `startChunk`, or later ones if below minimum size
+    static stream_t candidates(const view_t& view, size_t minSize, size_t numChunks, size_t startChunk, size_t index)
+    {
+        const size_t size = view.size();
+        for (; index < numChunks; index++) {
+            const size_t chunk = (startChunk + index) % numChunks;
+            const size_t frompos = size * chunk / numChunks;
+            const size_t topos = size * (chunk + 1) / numChunks;
+            if (size - (topos - frompos) < minSize)
+                continue;
+
+            auto newView = view.withoutRange(frompos, topos);
+            const size_t nextNumChunks = numChunks > 2 ? numChunks - 1 : 2;
+            auto newShrinkable = make_shrinkable<view_t>(newView).with([newView, minSize, nextNumChunks, chunk]() {
+                return shrinks(newView, minSize, nextNumChunks, chunk);
+            });
+            return stream_t(newShrinkable, [view, minSize, numChunks, startChunk, index]() {
+                return candidates(view, minSize, numChunks, startChunk, index + 1);
+            });
+        }
+        // increase granularity
+        if (numChunks < size) {
+            const size_t nextNumChunks = numChunks * 2 < size ? numChunks * 2 : size;
+            return candidates(view, minSize, nextNumChunks, 0, 0);
+        }
+        return stream_t::empty();
+    }
+};
+
 }  // namespace util
 
+/**
+ * @brief Membership-wise shrinking of elements, as views to the given elements
+ */
+template <typename T>
+Shrinkable<util::ShrinkableElementsView<T>> shrinkMembershipwiseView(const shared_ptr<vector<Shrinkable<T>>>& shrinkableElems,
+                                                                     size_t minSize,
+                                                                     MembershipShrink strategy = MembershipShrink::FrontAndMid)
+{
+    util::ShrinkableElementsView<T> view(shrinkableElems);
+    if (strategy == MembershipShrink::DeltaDebugging)
+        return util::DeltaDebuggingShrinker<T>::shrink(view, minSize);
+    return util::FrontAndMidShrinker<T>::shrinkFrontAndThenMid(view, minSize, 0);
+}
 
 template <template <typename...> class Container, typename T>
-Shrinkable<Container<Shrinkable<T>>> shrinkMembershipwise(const shared_ptr<Container<Shrinkable<T>>>& shrinkableCont, size_t minSize) {
-    return util::ContainerShrinker<Container, T>::shrinkFrontAndThenMid(shrinkableCont, minSize, 0);
+Shrinkable<Container<Shrinkable<T>>> shrinkMembershipwise(const shared_ptr<Container<Shrinkable<T>>>& shrinkableCont, size_t minSize,
+                                                          MembershipShrink strategy = MembershipShrink::FrontAndMid) {
+    auto elems = util::make_shared<vector<Shrinkable<T>>>(shrinkableCont->begin(), shrinkableCont->end());
+    return shrinkMembershipwiseView<T>(elems, minSize, strategy)
+        .template flatMap<Container<Shrinkable<T>>>(+[](const util::ShrinkableElementsView<T>& view) {
+            auto value = make_shrinkable<Container<Shrinkable<T>>>();
+            auto& cont = value.getRef();
+            view.forEach([&cont](const Shrinkable<T>& elem) { cont.insert(cont.end(), elem); });
+            return value;
+        });
 }
 
 template <typename T>
-Shrinkable<vector<Shrinkable<T>>> shrinkMembershipwise(const shared_ptr<vector<Shrinkable<T>>>& shrinkableCont, size_t minSize) {
-    return util::VectorShrinker<T>::shrinkFrontAndThenMid(shrinkableCont, minSize, 0);
+Shrinkable<vector<Shrinkable<T>>> shrinkMembershipwise(const shared_ptr<vector<Shrinkable<T>>>& shrinkableCont, size_t minSize,
+                                                       MembershipShrink strategy = MembershipShrink::FrontAndMid) {
+    return shrinkMembershipwiseView<T>(shrinkableCont, minSize, strategy)
+        .template map<vector<Shrinkable<T>>>(
+            +[](const util::ShrinkableElementsView<T>& view) { return *view.toVector(); });
 }
 
 /**
@@ -261,25 +412,20 @@ Shrinkable<vector<Shrinkable<T>>> shrinkMembershipwise(const shared_ptr<vector<S
  * @tparam T Contained type
  * @param shrinkableCont container of Shrinkable<T>
  * @param minSize minimum size a shrunk list can be
- * @param elementwise whether to enable element-wise shrinking. If false, only membership-wise shrinking is performed
+ * @param strategy strategy of membership-wise shrinking
  * @return Shrinkable<ListLike<T>>
  */
 template <template <typename...> class Container, typename T>
-Shrinkable<Container<T>> shrinkContainer(const shared_ptr<Container<Shrinkable<T>>>& shrinkableCont, size_t minSize)
+Shrinkable<Container<T>> shrinkContainer(const shared_ptr<Container<Shrinkable<T>>>& shrinkableCont, size_t minSize,
+                                         MembershipShrink strategy = MembershipShrink::FrontAndMid)
 {
-    // membershipwise shrinking
-    Shrinkable<Container<Shrinkable<T>>> shrinkableElemsShr = shrinkMembershipwise<Container, T>(shrinkableCont, minSize);
+    // membershipwise shrinking over the elements in order
+    auto elems = util::make_shared<vector<Shrinkable<T>>>(shrinkableCont->begin(), shrinkableCont->end());
+    auto shrinkableElemsShr = shrinkMembershipwiseView<T>(elems, minSize, strategy);
 
     // transform to proper output type
     return shrinkableElemsShr.template flatMap<Container<T>>(
-        +[](const Container<Shrinkable<T>>& _shrinkableCont) -> Shrinkable<Container<T>> {
-            auto value = make_shrinkable<Container<T>>();
-            Container<T>& valueCont = value.getRef();
-            for(auto itr = _shrinkableCont.begin(); itr != _shrinkableCont.end(); ++itr) {
-                valueCont.insert(itr->getRef());
-            }
-            return value;
-        });
+        +[](const util::ShrinkableElementsView<T>& view) { return util::materializeElements<Container<T>>(view); });
 }
 
 
@@ -293,30 +439,33 @@ Shrinkable<Container<T>> shrinkContainer(const shared_ptr<Container<Shrinkable<T
  * @param shrinkableVector vector of Shrinkable<T>
  * @param minSize minimum size a shrunk list can be
  * @param elementwise whether to enable element-wise shrinking. If false, only membership-wise shrinking is performed
+ * @param strategy strategy of membership-wise shrinking
  * @return Shrinkable<ListLike<T>>
  */
 template <template <typename...> class ListLike, typename T>
-Shrinkable<ListLike<T>> shrinkListLike(const shared_ptr<vector<Shrinkable<T>>>& shrinkableVector, size_t minSize, bool elementwise = true)
+Shrinkable<ListLike<T>> shrinkListLike(const shared_ptr<vector<Shrinkable<T>>>& shrinkableVector, size_t minSize, bool elementwise = true,
+                                       MembershipShrink strategy = MembershipShrink::FrontAndMid)
 {
+    using view_t = util::ShrinkableElementsView<T>;
     // membershipwise shrinking
-    Shrinkable<vector<Shrinkable<T>>> shrinkableElemsShr = shrinkMembershipwise<T>(shrinkableVector, minSize);
+    Shrinkable<view_t> shrinkableElemsShr = shrinkMembershipwiseView<T>(shrinkableVector, minSize, strategy);
 
     // elementwise shrinking
     if(elementwise)
-        shrinkableElemsShr = shrinkableElemsShr.andThen(+[](const Shrinkable<vector<Shrinkable<T>>>& parent) {
-            return util::VectorShrinker<T>::shrinkElementwise(parent, 0, 0);
+        shrinkableElemsShr = shrinkableElemsShr.andThen(+[](const Shrinkable<view_t>& parent) {
+            auto elems = make_shrinkable<vector<Shrinkable<T>>>(*parent.getRef().toVector());
+            return util::VectorShrinker<T>::shrinkElementwise(elems, 0, 0).template transform<Shrinkable<view_t>>(
+                +[](const Shrinkable<vector<Shrinkable<T>>>& shr) {
+                    // views over the shrunk elements, without copying them
+                    return shr.template mapShrinkable<view_t>(+[](const Shrinkable<vector<Shrinkable<T>>>& vecShr) {
+                        return make_shrinkable<view_t>(vecShr.getSharedPtr());
+                    });
+                });
         });
 
     // transform to proper output type
     return shrinkableElemsShr.template flatMap<ListLike<T>>(
-        +[](const vector<Shrinkable<T>>& _shrinkableVector) -> Shrinkable<ListLike<T>> {
-            auto value = make_shrinkable<ListLike<T>>();
-            ListLike<T>& valueVec = value.getRef();
-            transform(
-                _shrinkableVector.begin(), _shrinkableVector.end(), back_inserter(valueVec),
-                +[](const Shrinkable<T>& shr) -> T { return shr.getRef(); });
-            return value;
-        });
+        +[](const view_t& view) { return util::materializeElements<ListLike<T>>(view); });
 }
 
 /**
@@ -6,8 +6,9 @@
 namespace proptest {
 
 template <typename T>
-Shrinkable<set<T>> shrinkSet(const shared_ptr<set<Shrinkable<T>>>& shrinkableSet, size_t minSize) {
-    return shrinkContainer<set, T>(shrinkableSet, minSize);
+Shrinkable<set<T>> shrinkSet(const shared_ptr<set<Shrinkable<T>>>& shrinkableSet, size_t minSize,
+                             MembershipShrink strategy = MembershipShrink::FrontAndMid) {
+    return shrinkContainer<set, T>(shrinkableSet, minSize, strategy);
 }
 
 }
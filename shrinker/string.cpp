@@ -1,9 +1,10 @@
 #include "string.hpp"
+#include "stringlike.hpp"
 #include "../generator/util.hpp"
 
 namespace proptest {
 
-Shrinkable<string> shrinkString(const string& str, size_t minSize) {
+Shrinkable<string> shrinkString(const string& str, size_t minSize, uint8_t simplestChars) {
     size_t size = str.size();
     auto shrinkRear =
         util::binarySearchShrinkableU(size - minSize).map<string>([str, minSize](const uint64_t& size) {
@@ -11,7 +12,7 @@ Shrinkable<string> shrinkString(const string& str, size_t minSize) {
         });
 
     // shrink front
-    return shrinkRear.concat([minSize](const Shrinkable<string>& shr) {
+    auto shrinkFront = shrinkRear.concat([minSize](const Shrinkable<string>& shr) {
         auto& str = shr.getRef();
         size_t maxSizeCopy = str.size();
         if (maxSizeCopy == minSize)
@@ -22,6 +23,11 @@ Shrinkable<string> shrinkString(const string& str, size_t minSize) {
                                  });
         return newShrinkable.shrinks();
     });
+
+    // interior deletion and byte simplification, after truncation
+    return shrinkFront.andThen([minSize, simplestChars](const Shrinkable<string>& shr) {
+        return util::StringLikeShrinker<string>::shrinkInterior(shr, minSize, simplestChars);
+    });
 }
 
 }
@@ -3,6 +3,7 @@
 
 namespace proptest {
 
-Shrinkable<string> shrinkString(const string& str, size_t minSize);
+/// characters are simplified only to the targets allowed by `simplestChars` (flags of `util::SimplestChar`)
+Shrinkable<string> shrinkString(const string& str, size_t minSize, uint8_t simplestChars = 0);
 
 }
@@ -1,11 +1,258 @@
 #pragma once
 #include "../Shrinkable.hpp"
 #include "../generator/util.hpp"
+#include "../util/utf8string.hpp"
+#include "../util/utf16string.hpp"
+#include "../util/cesu8string.hpp"
 
 namespace proptest {
 
+namespace util {
+
+/**
+ * @brief Character boundaries and ASCII characters in the encoding of StringLike (single bytes for `string`)
+ */
+template <typename StringLike>
+struct StringLikeEncoding
+{
+    static size_t charLength(const string&, size_t) { return 1; }
+    // ASCII character of the character at pos, or -1 if it is not one
+    static int asciiAt(const string& str, size_t pos, size_t)
+    {
+        uint8_t c = static_cast<uint8_t>(str[pos]);
+        return c < 0x80 ? c : -1;
+    }
+    static void appendASCII(string& str, char c) { str += c; }
+};
+
+template <>
+struct StringLikeEncoding<UTF8String> : public StringLikeEncoding<string>
+{
+    static size_t charLength(const string& str, size_t pos)
+    {
+        uint8_t c = static_cast<uint8_t>(str[pos]);
+        return c < 0x80 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+    }
+};
+
+template <>
+struct StringLikeEncoding<CESU8String> : public StringLikeEncoding<string>
+{
+    static size_t charLength(const string& str, size_t pos)
+    {
+        uint8_t c = static_cast<uint8_t>(str[pos]);
+        if (c < 0xe0)
+            return c < 0x80 ? 1 : 2;
+        // a supplementary character is a pair of 3-byte surrogates, starting with a high surrogate (ED A0..AF)
+        uint8_t c1 = pos + 1 < str.size() ? static_cast<uint8_t>(str[pos + 1]) : 0;
+        return c == 0xed && c1 >= 0xa0 && c1 < 0xb0 ? 6 : 3;
+    }
+};
+
+template <>
+struct StringLikeEncoding<UTF16BEString>
+{
+    static size_t charLength(const string& str, size_t pos)
+    {
+        uint8_t hi = static_cast<uint8_t>(str[pos]);
+        return hi >= 0xd8 && hi < 0xdc ? 4 : 2;
+    }
+    static int asciiAt(const string& str, size_t pos, size_t len)
+    {
+        uint8_t hi = static_cast<uint8_t>(str[pos]), lo = static_cast<uint8_t>(str[pos + 1]);
+        return len == 2 && hi == 0 && lo < 0x80 ? lo : -1;
+    }
+    static void appendASCII(string& str, char c)
+    {
+        str += '\0';
+        str += c;
+    }
+};
+
+template <>
+struct StringLikeEncoding<UTF16LEString>
+{
+    static size_t charLength(const string& str, size_t pos)
+    {
+        uint8_t hi = static_cast<uint8_t>(str[pos + 1]);
+        return hi >= 0xd8 && hi < 0xdc ? 4 : 2;
+    }
+    static int asciiAt(const string& str, size_t pos, size_t len)
+    {
+        uint8_t lo = static_cast<uint8_t>(str[pos]), hi = static_cast<uint8_t>(str[pos + 1]);
+        return len == 2 && hi == 0 && lo < 0x80 ? lo : -1;
+    }
+    static void appendASCII(string& str, char c)
+    {
+        str += c;
+        str += '\0';
+    }
+};
+
+/**
+ * @brief Characters that `StringLikeShrinker` may simplify characters to, as bit flags
+ */
+enum SimplestChar : uint8_t {
+    SimplestLower = 1 << 0,  // lowercase letters to `a`
+    SimplestUpper = 1 << 1,  // uppercase letters to `A`
+    SimplestDigit = 1 << 2,  // digits to `0`
+    SimplestSpace = 1 << 3,  // other characters to a space
+    SimplestNone = 0,
+    SimplestAll = SimplestLower | SimplestUpper | SimplestDigit | SimplestSpace,
+};
+
+/// flags of the simplification targets for which `contains` holds, e.g. those in the range of an element generator
+template <typename Contains>
+uint8_t simplestCharsIn(Contains&& contains)
+{
+    uint8_t flags = SimplestNone;
+    if (contains('a'))
+        flags |= SimplestLower;
+    if (contains('A'))
+        flags |= SimplestUpper;
+    if (contains('0'))
+        flags |= SimplestDigit;
+    if (contains(' '))
+        flags |= SimplestSpace;
+    return flags;
+}
+
+/**
+ * @brief Shrinks strings by deleting interior ranges of characters and by simplifying characters
+ * @details Both walk chunks of halving sizes, down to single characters. A shrink found continues from the chunk after
+ * the one deleted or simplified. Letters are simplified to `a` (or `A`), digits to `0`, and other characters to a
+ * space, each only if allowed by given `SimplestChar` flags, so that a candidate stays within the range of the
+ * generator. Candidates are built with a single copy of the kept bytes, and character boundaries of a string are found
+ * only when its shrinks are requested. Strings are expected without a terminator (e.g. `\0\0` of UTF-16).
+ */
+template <typename StringLike>
+struct StringLikeShrinker
+{
+    using encoding_t = StringLikeEncoding<StringLike>;
+    using shrinkable_t = Shrinkable<StringLike>;
+    using stream_t = Stream<shrinkable_t>;
+    using bounds_t = shared_ptr<vector<size_t>>;
+
+    static stream_t shrinkInterior(const shrinkable_t& shrinkable, size_t minSize, uint8_t simplestChars)
+    {
+        bounds_t bounds = charBounds(shrinkable.getRef());
+        return deleteRanges(shrinkable, bounds, minSize, simplestChars, (bounds->size() - 1) / 2, 0);
+    }
+
+    // simplest form of an ASCII character (or -1 for a non-ASCII one), or c itself if its target is not allowed
+    static int simplestOf(int c, uint8_t simplestChars)
+    {
+        if (c >= 'a' && c <= 'z')
+            return simplestChars & SimplestLower ? 'a' : c;
+        else if (c >= 'A' && c <= 'Z')
+            return simplestChars & SimplestUpper ? 'A' : c;
+        else if (c >= '0' && c <= '9')
+            return simplestChars & SimplestDigit ? '0' : c;
+        else
+            return simplestChars & SimplestSpace ? ' ' : c;
+    }
+
+private:
+    static bounds_t charBounds(const StringLike& str)
+    {
+        bounds_t bounds = util::make_shared<vector<size_t>>();
+        bounds->reserve(str.size() + 1);
+        size_t pos = 0;
+        while (pos < str.size()) {
+            bounds->push_back(pos);
+            pos += encoding_t::charLength(str, pos);
+        }
+        bounds->push_back(str.size());
+        return bounds;
+    }
+
+    static stream_t deleteRanges(const shrinkable_t& shrinkable, const bounds_t& bounds, size_t minSize,
+                                 uint8_t simplestChars, size_t chunkSize, size_t from)
+    {
+        const StringLike& str = shrinkable.getRef();
+        const size_t numChars = bounds->size() - 1;
+        for (; chunkSize > 0 && numChars > minSize; chunkSize /= 2, from = 0) {
+            for (; from < numChars; from += chunkSize) {
+                size_t to = std::min(from + chunkSize, numChars);
+                if (numChars - (to - from) < minSize)
+                    continue;
+
+                StringLike deleted;
+                deleted.reserve(str.size() - ((*bounds)[to] - (*bounds)[from]));
+                deleted.append(str, 0, (*bounds)[from]);
+                deleted.append(str, (*bounds)[to], string::npos);
+                auto candidate = make_shrinkable<StringLike>(util::move(deleted));
+                candidate = candidate.with([candidate, minSize, simplestChars, chunkSize, from]() {
+                    return deleteRanges(candidate, charBounds(candidate.getRef()), minSize, simplestChars, chunkSize,
+                                        from);
+                });
+                return stream_t(candidate, [shrinkable, bounds, minSize, simplestChars, chunkSize, from]() {
+                    return deleteRanges(shrinkable, bounds, minSize, simplestChars, chunkSize, from + chunkSize);
+                });
+            }
+        }
+        if (simplestChars == SimplestNone)
+            return stream_t::empty();
+        return simplifyRanges(shrinkable, bounds, simplestChars, numChars, 0);
+    }
+
+    static stream_t simplifyRanges(const shrinkable_t& shrinkable, const bounds_t& bounds, uint8_t simplestChars,
+                                   size_t chunkSize, size_t from)
+    {
+        const StringLike& str = shrinkable.getRef();
+        const size_t numChars = bounds->size() - 1;
+        for (; chunkSize > 0; chunkSize /= 2, from = 0) {
+            for (; from < numChars; from += chunkSize) {
+                size_t to = std::min(from + chunkSize, numChars);
+                if (!isSimplifiable(str, *bounds, simplestChars, from, to))
+                    continue;
+
+                StringLike simplified;
+                simplified.reserve(str.size());
+                simplified.append(str, 0, (*bounds)[from]);
+                for (size_t i = from; i < to; i++) {
+                    size_t pos = (*bounds)[i], len = (*bounds)[i + 1] - pos;
+                    int c = encoding_t::asciiAt(str, pos, len), simplest = simplestOf(c, simplestChars);
+                    // characters without an allowed target are kept as they are
+                    if (simplest == c)
+                        simplified.append(str, pos, len);
+                    else
+                        encoding_t::appendASCII(simplified, static_cast<char>(simplest));
+                }
+                simplified.append(str, (*bounds)[to], string::npos);
+                auto candidate = make_shrinkable<StringLike>(util::move(simplified));
+                candidate = candidate.with([candidate, simplestChars, chunkSize, to]() {
+                    return simplifyRanges(candidate, charBounds(candidate.getRef()), simplestChars, chunkSize, to);
+                });
+                return stream_t(candidate, [shrinkable, bounds, simplestChars, chunkSize, from]() {
+                    return simplifyRanges(shrinkable, bounds, simplestChars, chunkSize, from + chunkSize);
+                });
+            }
+        }
+        return stream_t::empty();
+    }
+
+    static bool isSimplifiable(const StringLike& str, const vector<size_t>& bounds, uint8_t simplestChars, size_t from,
+                               size_t to)
+    {
+        for (size_t i = from; i < to; i++) {
+            int c = encoding_t::asciiAt(str, bounds[i], bounds[i + 1] - bounds[i]);
+            if (c != simplestOf(c, simplestChars))
+                return true;
+        }
+        return false;
+    }
+};
+
+}  // namespace util
+
+/**
+ * @brief Shrinks a string of `size` characters starting at `bytePositions`, with characters simplified only to the
+ * targets allowed by `simplestChars` (see `util::SimplestChar`)
+ */
 template <typename StringLike>
-Shrinkable<StringLike> shrinkStringLike(const StringLike& str, size_t minSize, size_t size, const vector<int>& bytePositions) {
+Shrinkable<StringLike> shrinkStringLike(const StringLike& str, size_t minSize, size_t size, const vector<int>& bytePositions,
+                                        uint8_t simplestChars = util::SimplestNone) {
     auto shrinkRear =
         util::binarySearchShrinkable(size - minSize)
             .template map<StringLike>([str, minSize, bytePositions](const uint64_t& _size) -> StringLike {
@@ -15,7 +262,7 @@ Shrinkable<StringLike> shrinkStringLike(const StringLike& str, size_t minSize, s
                     return StringLike(str.substr(0, bytePositions[_size + minSize]));
             });
 
-    return shrinkRear.concat([minSize, bytePositions](const Shrinkable<StringLike>& shr) {
+    auto shrinkFront = shrinkRear.concat([minSize, bytePositions](const Shrinkable<StringLike>& shr) {
         auto& str = shr.getRef();
         size_t maxSizeCopy = str.charsize();
         if (maxSizeCopy == minSize)
@@ -31,6 +278,11 @@ Shrinkable<StringLike> shrinkStringLike(const StringLike& str, size_t minSize, s
                 });
         return newShrinkable.shrinks();
     });
+
+    // interior deletion and character simplification, after truncation
+    return shrinkFront.andThen([minSize, simplestChars](const Shrinkable<StringLike>& shr) {
+        return util::StringLikeShrinker<StringLike>::shrinkInterior(shr, minSize, simplestChars);
+    });
 }
 
 }
@@ -0,0 +1,64 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+
+namespace {
+
+template <typename T>
+void measureArbi(State& state, Arbi<T> arbi = Arbi<T>())
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(arbi(rand)); });
+}
+
+}  // namespace
+
+PROPTEST_BENCHMARK(Arbi, Bool) { measureArbi<bool>(state); }
+PROPTEST_BENCHMARK(Arbi, Char) { measureArbi<char>(state); }
+PROPTEST_BENCHMARK(Arbi, Int8) { measureArbi<int8_t>(state); }
+PROPTEST_BENCHMARK(Arbi, Int16) { measureArbi<int16_t>(state); }
+PROPTEST_BENCHMARK(Arbi, Int32) { measureArbi<int32_t>(state); }
+PROPTEST_BENCHMARK(Arbi, Int64) { measureArbi<int64_t>(state); }
+PROPTEST_BENCHMARK(Arbi, UInt8) { measureArbi<uint8_t>(state); }
+PROPTEST_BENCHMARK(Arbi, UInt16) { measureArbi<uint16_t>(state); }
+PROPTEST_BENCHMARK(Arbi, UInt32) { measureArbi<uint32_t>(state); }
+PROPTEST_BENCHMARK(Arbi, UInt64) { measureArbi<uint64_t>(state); }
+PROPTEST_BENCHMARK(Arbi, Float) { measureArbi<float>(state); }
+PROPTEST_BENCHMARK(Arbi, Double) { measureArbi<double>(state); }
+PROPTEST_BENCHMARK(Arbi, String) { measureArbi<string>(state); }
+PROPTEST_BENCHMARK(Arbi, StringPrintable) { measureArbi<string>(state, Arbi<string>(CharClass::Printable)); }
+PROPTEST_BENCHMARK(Arbi, StringElemGen) { measureArbi<string>(state, Arbi<string>(interval<char>(0x1, 0x7f))); }
+PROPTEST_BENCHMARK(Arbi, UTF8String) { measureArbi<UTF8String>(state); }
+PROPTEST_BENCHMARK(Arbi, UTF8StringElemGen) { measureArbi<UTF8String>(state, Arbi<UTF8String>(UnicodeGen())); }
+PROPTEST_BENCHMARK(Arbi, UTF16BEString) { measureArbi<UTF16BEString>(state); }
+PROPTEST_BENCHMARK(Arbi, UTF16LEString) { measureArbi<UTF16LEString>(state); }
+PROPTEST_BENCHMARK(Arbi, CESU8String) { measureArbi<CESU8String>(state); }
+PROPTEST_BENCHMARK(Arbi, VectorInt) { measureArbi<vector<int>>(state); }
+PROPTEST_BENCHMARK(Arbi, ListInt) { measureArbi<list<int>>(state); }
+PROPTEST_BENCHMARK(Arbi, SetInt) { measureArbi<set<int>>(state); }
+PROPTEST_BENCHMARK(Arbi, MapIntInt) { measureArbi<map<int, int>>(state); }
+PROPTEST_BENCHMARK(Arbi, PairIntInt) { measureArbi<pair<int, int>>(state); }
+PROPTEST_BENCHMARK(Arbi, TupleIntIntInt) { measureArbi<tuple<int, int, int>>(state); }
+PROPTEST_BENCHMARK(Arbi, SharedPtrInt) { measureArbi<shared_ptr<int>>(state); }
+PROPTEST_BENCHMARK(Arbi, NullableInt) { measureArbi<Nullable<int>>(state); }
+
+PROPTEST_BENCHMARK(Arbi, UnicodeGen)
+{
+    UnicodeGen gen;
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
+
+// 64 code points per operation
+PROPTEST_BENCHMARK(Arbi, CodePointSamplerFill)
+{
+    CodePointSampler sampler;
+    uint32_t codes[64];
+    Random rand(1);
+    state.measure([&]() {
+        sampler.fill(rand, codes, 64);
+        doNotOptimize(codes[63]);
+    });
+}
@@ -0,0 +1,92 @@
+#include "benchmark.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct Benchmark
+{
+    std::string group;
+    std::string name;
+    proptest::bench::BenchmarkFunction func;
+};
+
+std::vector<Benchmark>& getBenchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+// discards everything written to cout/cerr (e.g. "random seed: ..." from property runs) while measuring
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+}  // namespace
+
+namespace proptest {
+namespace bench {
+
+AllocCounters getAllocCounters()
+{
+    InstrumentationCounters counters = util::Instrumentation::snapshot().total();
+    return AllocCounters{counters.allocations, counters.allocatedBytes};
+}
+
+Registrar::Registrar(const char* group, const char* name, BenchmarkFunction func)
+{
+    getBenchmarks().push_back(Benchmark{group, name, func});
+}
+
+}  // namespace bench
+}  // namespace proptest
+
+/**
+ * usage: bench_proptest [--min-time=SECONDS] [FILTER...]
+ *
+ * Runs benchmarks whose "Group.Name" contains any of the FILTERs (all benchmarks if none is given)
+ */
+int main(int argc, char* argv[])
+{
+    double minSeconds = 0.5;
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const std::string minTimeOption = "--min-time=";
+        if (arg.compare(0, minTimeOption.size(), minTimeOption) == 0)
+            minSeconds = std::atof(arg.c_str() + minTimeOption.size());
+        else
+            filters.push_back(arg);
+    }
+
+    std::printf("%-44s %14s %12s %12s %12s\n", "benchmark", "ns/op", "allocs/op", "bytes/op", "iterations");
+    NullBuffer nullBuffer;
+    for (auto& benchmark : getBenchmarks()) {
+        std::string fullName = benchmark.group + "." + benchmark.name;
+        bool selected = filters.empty();
+        for (auto& filter : filters)
+            selected = selected || fullName.find(filter) != std::string::npos;
+        if (!selected)
+            continue;
+
+        proptest::bench::State state(minSeconds);
+        auto coutBuffer = std::cout.rdbuf(&nullBuffer);
+        auto cerrBuffer = std::cerr.rdbuf(&nullBuffer);
+        benchmark.func(state);
+        std::cout.rdbuf(coutBuffer);
+        std::cerr.rdbuf(cerrBuffer);
+
+        if (!state.isMeasured()) {
+            std::printf("%-44s %14s\n", fullName.c_str(), "(not measured)");
+            continue;
+        }
+        auto& result = state.getResult();
+        std::printf("%-44s %14.1f %12.2f %12.1f %12llu\n", fullName.c_str(), result.nsPerOp, result.allocsPerOp,
+                    result.bytesPerOp, static_cast<unsigned long long>(result.iterations));
+        for (auto& counter : state.getCounters())
+            std::printf("    %s: %.0f\n", counter.first.c_str(), counter.second);
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "../../util/std.hpp"
+#include "../../util/instrumentation.hpp"
+#include <chrono>
+
+/**
+ * @file benchmark.hpp
+ * @brief Minimal micro-benchmark harness for the library's hot paths
+ *
+ * Each benchmark is defined with `PROPTEST_BENCHMARK(Group, Name)` and measures its operation by calling
+ * `state.measure(op)`. The harness repeats the operation until the minimum measuring time is reached and reports
+ * nanoseconds, heap allocations and allocated bytes per operation. Allocations are counted by the `operator new` of
+ * util/instrumentation_new.cpp, on the measuring thread only.
+ */
+
+namespace proptest {
+namespace bench {
+
+/// heap allocation counters of the calling thread, in all instrumentation phases
+struct AllocCounters
+{
+    uint64_t count;
+    uint64_t bytes;
+};
+
+AllocCounters getAllocCounters();
+
+/// result of a benchmark
+struct Result
+{
+    uint64_t iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+};
+
+class State {
+public:
+    explicit State(double minSeconds) : minSeconds(minSeconds), measured(false), result{0, 0, 0, 0} {}
+
+    /// repeats `op` until the minimum measuring time is reached, and records the per-operation cost
+    template <typename Op>
+    void measure(Op&& op)
+    {
+        using clock = std::chrono::steady_clock;
+        uint64_t iterations = 1;
+        // allocations are counted only in a phase. phases set by the operation (e.g. by a property run) are nested
+        util::InstrumentationPhaseScope phase(InstrumentationReport::Execution);
+        while (true) {
+            AllocCounters before = getAllocCounters();
+            auto start = clock::now();
+            for (uint64_t i = 0; i < iterations; i++)
+                op();
+            auto end = clock::now();
+            AllocCounters after = getAllocCounters();
+
+            double elapsed = std::chrono::duration<double>(end - start).count();
+            if (elapsed >= minSeconds || iterations >= maxIterations) {
+                result.iterations = iterations;
+                result.nsPerOp = elapsed * 1e9 / static_cast<double>(iterations);
+                result.allocsPerOp = static_cast<double>(after.count - before.count) / static_cast<double>(iterations);
+                result.bytesPerOp = static_cast<double>(after.bytes - before.bytes) / static_cast<double>(iterations);
+                measured = true;
+                return;
+            }
+            iterations = nextIterations(iterations, elapsed);
+        }
+    }
+
+    /// reports an additional value of the benchmark (e.g. number of property invocations), printed with the result
+    void setCounter(const std::string& name, double value) { counters.emplace_back(name, value); }
+
+    bool isMeasured() const { return measured; }
+    const Result& getResult() const { return result; }
+    const std::vector<std::pair<std::string, double>>& getCounters() const { return counters; }
+
+private:
+    uint64_t nextIterations(uint64_t iterations, double elapsed) const
+    {
+        // aim slightly above the minimum time, growing by at least 2x and at most 10x per round
+        double estimate = elapsed > 0 ? static_cast<double>(iterations) * minSeconds * 1.2 / elapsed
+                                      : static_cast<double>(iterations) * 10;
+        double minNext = static_cast<double>(iterations) * 2;
+        double maxNext = static_cast<double>(iterations) * 10;
+        double next = estimate < minNext ? minNext : (estimate > maxNext ? maxNext : estimate);
+        return next > static_cast<double>(maxIterations) ? maxIterations : static_cast<uint64_t>(next);
+    }
+
+    static constexpr uint64_t maxIterations = 1000000000ULL;
+
+    double minSeconds;
+    bool measured;
+    Result result;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+using BenchmarkFunction = void (*)(State&);
+
+struct Registrar
+{
+    Registrar(const char* group, const char* name, BenchmarkFunction func);
+};
+
+/// prevents the compiler from optimizing away the computation of `value`
+template <typename T>
+void doNotOptimize(T&& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+}  // namespace bench
+}  // namespace proptest
+
+#define PROPTEST_BENCHMARK(GROUP, NAME)                                                                     \
+    static void proptest_bench_##GROUP##_##NAME(::proptest::bench::State& state);                          \
+    static ::proptest::bench::Registrar proptest_bench_registrar_##GROUP##_##NAME(#GROUP, #NAME,            \
+                                                                                  &proptest_bench_##GROUP##_##NAME); \
+    static void proptest_bench_##GROUP##_##NAME(::proptest::bench::State& state)
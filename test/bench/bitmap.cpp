@@ -0,0 +1,52 @@
+#include "benchmark.hpp"
+#include "../../util/bitmap.hpp"
+#include <thread>
+
+using namespace proptest;
+using namespace proptest::bench;
+
+namespace {
+
+// each operation is 1000 acquisitions and releases by each of the threads, sharing a bitmap
+void measureContention(State& state, int numThreads)
+{
+    util::Bitmap bitmap;
+    state.measure([&]() {
+        vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&bitmap]() {
+                for (int i = 0; i < 1000; i++)
+                    bitmap.unacquire(bitmap.acquire());
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    });
+}
+
+}  // namespace
+
+PROPTEST_BENCHMARK(Bitmap, Threads1) { measureContention(state, 1); }
+PROPTEST_BENCHMARK(Bitmap, Threads4) { measureContention(state, 4); }
+PROPTEST_BENCHMARK(Bitmap, Threads16) { measureContention(state, 16); }
+PROPTEST_BENCHMARK(Bitmap, Threads64) { measureContention(state, 64); }
+
+// acquiring all slots one by one
+PROPTEST_BENCHMARK(Bitmap, Fill)
+{
+    util::Bitmap bitmap;
+    state.measure([&]() {
+        bitmap.reset();
+        for (int i = 0; i < 1000; i++)
+            doNotOptimize(bitmap.acquire());
+    });
+}
+
+PROPTEST_BENCHMARK(Bitmap, Copy)
+{
+    util::Bitmap bitmap;
+    state.measure([&]() {
+        util::Bitmap copy(bitmap);
+        doNotOptimize(copy);
+    });
+}
@@ -0,0 +1,48 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+
+PROPTEST_BENCHMARK(Combinator, OneOf)
+{
+    Random rand(1);
+    auto gen = oneOf<int>(interval(0, 10), interval(100, 110), just(1000));
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
+
+PROPTEST_BENCHMARK(Combinator, OneOfWeighted)
+{
+    Random rand(1);
+    auto gen = oneOf<int>(weightedGen<int>(interval(0, 10), 0.8), weightedGen<int>(interval(100, 110), 0.1),
+                          just(1000));
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
+
+PROPTEST_BENCHMARK(Combinator, ElementOf)
+{
+    Random rand(1);
+    auto gen = elementOf<int>(2, 3, 5, 7, 11, 13);
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
+
+PROPTEST_BENCHMARK(Combinator, Interval)
+{
+    Random rand(1);
+    auto gen = interval(-1000, 1000);
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
+
+PROPTEST_BENCHMARK(Combinator, Filter)
+{
+    Random rand(1);
+    auto gen = Arbi<int>().filter([](int& v) { return v % 2 == 0; });
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
+
+PROPTEST_BENCHMARK(Combinator, Map)
+{
+    Random rand(1);
+    auto gen = Arbi<int>().map<string>([](int& v) { return to_string(v); });
+    state.measure([&]() { doNotOptimize(gen(rand)); });
+}
@@ -0,0 +1,56 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+
+// each operation is a single macro call inside a property context
+PROPTEST_BENCHMARK(Context, TagString)
+{
+    PropertyContext context;
+    int i = 0;
+    state.measure([&]() { PROP_TAG("parity", (i++ % 2 == 0) ? "even" : "odd"); });
+}
+
+PROPTEST_BENCHMARK(Context, TagInt)
+{
+    PropertyContext context;
+    int i = 0;
+    state.measure([&]() { PROP_TAG("mod 8", i++ % 8); });
+}
+
+PROPTEST_BENCHMARK(Context, Stat)
+{
+    PropertyContext context;
+    int i = 0;
+    state.measure([&]() { PROP_STAT(i++ % 3 == 0); });
+}
+
+PROPTEST_BENCHMARK(Context, Classify)
+{
+    PropertyContext context;
+    int i = 0;
+    state.measure([&]() { PROP_CLASSIFY(i++ % 2 == 0, "parity", "even"); });
+}
+
+PROPTEST_BENCHMARK(Context, ExpectEqSuccess)
+{
+    PropertyContext context;
+    int i = 0;
+    state.measure([&]() {
+        i++;
+        PROP_EXPECT_EQ(i, i);
+    });
+}
+
+// each operation is a property test of 100 runs with a tag and an expectation in each run
+PROPTEST_BENCHMARK(Context, TaggedProperty100Runs)
+{
+    auto prop = property([](int a, int b) {
+        PROP_TAG("sign", a < 0 ? "negative" : "non-negative");
+        PROP_STAT(b % 2 == 0);
+        PROP_EXPECT_EQ(a + b, b + a);
+    });
+    prop.setSeed(1).setNumRuns(100);
+    state.measure([&]() { doNotOptimize(prop.forAll()); });
+}
@@ -0,0 +1,48 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+using namespace proptest::util;
+
+namespace {
+
+// 4 KiB of mixed 1 to 4 byte characters, including control characters to escape
+template <typename String>
+String sampleString(void (*encode)(uint32_t, vector<uint8_t>&))
+{
+    const uint32_t codes[] = {'a', '\n', 0xe9, 0x3b1, 0x4e2d, '\\', 0x1f600, '7'};
+    vector<uint8_t> chars;
+    for (size_t i = 0; chars.size() < 4096; i++)
+        encode(codes[i % 8], chars);
+    return String(chars.begin(), chars.end());
+}
+
+template <typename String>
+void measureShow(State& state, void (*encode)(uint32_t, vector<uint8_t>&))
+{
+    String str = sampleString<String>(encode);
+    stringstream os;
+    state.measure([&]() {
+        os.str("");
+        show(os, str);
+        doNotOptimize(os.tellp());
+    });
+}
+
+}  // namespace
+
+PROPTEST_BENCHMARK(Printing, UTF8String) { measureShow<UTF8String>(state, encodeUTF8); }
+PROPTEST_BENCHMARK(Printing, CESU8String) { measureShow<CESU8String>(state, encodeCESU8); }
+PROPTEST_BENCHMARK(Printing, UTF16BEString) { measureShow<UTF16BEString>(state, encodeUTF16BE); }
+PROPTEST_BENCHMARK(Printing, UTF16LEString) { measureShow<UTF16LEString>(state, encodeUTF16LE); }
+PROPTEST_BENCHMARK(Printing, Bytes)
+{
+    string str = sampleString<string>(encodeUTF8);
+    stringstream os;
+    state.measure([&]() {
+        os.str("");
+        show(os, str.data(), str.size());
+        doNotOptimize(os.tellp());
+    });
+}
@@ -0,0 +1,57 @@
+#include "benchmark.hpp"
+#include "../../Random.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+
+PROPTEST_BENCHMARK(Random, Bool)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomBool()); });
+}
+
+PROPTEST_BENCHMARK(Random, Int32)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomInt32()); });
+}
+
+PROPTEST_BENCHMARK(Random, Int32InRange)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomInt32(-100, 100)); });
+}
+
+PROPTEST_BENCHMARK(Random, UInt64)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomUInt64()); });
+}
+
+PROPTEST_BENCHMARK(Random, UInt64InRange)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomUInt64(0, 1000)); });
+}
+
+PROPTEST_BENCHMARK(Random, Double)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomDouble()); });
+}
+
+PROPTEST_BENCHMARK(Random, Size)
+{
+    Random rand(1);
+    state.measure([&]() { doNotOptimize(rand.getRandomSize(0, 200)); });
+}
+
+PROPTEST_BENCHMARK(Random, Copy)
+{
+    Random rand(1);
+    Random saved(2);
+    state.measure([&]() {
+        saved = rand;
+        doNotOptimize(saved);
+    });
+}
@@ -0,0 +1,84 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+#include "../../statefultest.hpp"
+#include "../../concurrencytest.hpp"
+#include <mutex>
+
+using namespace proptest;
+using namespace proptest::bench;
+
+namespace {
+
+Generator<stateful::SimpleAction<vector<int>>> vectorActionGen()
+{
+    using Action = stateful::SimpleAction<vector<int>>;
+    auto pushBackGen = Arbi<int>().map<Action>([](int& value) {
+        return Action([value](vector<int>& obj) { obj.push_back(value); });
+    });
+    auto popBackGen = just(Action([](vector<int>& obj) {
+        if (!obj.empty())
+            obj.pop_back();
+    }));
+    return oneOf<Action>(pushBackGen, popBackGen);
+}
+
+concurrent::Concurrency<vector<int>, stateful::EmptyModel> concurrencyProperty()
+{
+    using Action = concurrent::SimpleAction<vector<int>>;
+    auto mutexPtr = util::make_shared<std::mutex>();
+    auto pushBackGen = Arbi<int>().map<Action>([mutexPtr](int& value) {
+        return Action([mutexPtr, value](vector<int>& obj) {
+            std::lock_guard<std::mutex> guard(*mutexPtr);
+            obj.push_back(value);
+        });
+    });
+    auto actionGen = oneOf<Action>(pushBackGen);
+    return concurrent::concurrency<vector<int>>(Arbi<vector<int>>().setMaxSize(10), actionGen);
+}
+
+}  // namespace
+
+// each operation is a property test of 100 runs
+PROPTEST_BENCHMARK(Runner, Property100Runs)
+{
+    auto prop = property([](int a, int b) { return a + b == b + a; });
+    prop.setSeed(1).setNumRuns(100);
+    state.measure([&]() { doNotOptimize(prop.forAll()); });
+}
+
+PROPTEST_BENCHMARK(Runner, Stateful100Runs)
+{
+    auto actionGen = vectorActionGen();
+    auto prop = stateful::statefulProperty<vector<int>>(Arbi<vector<int>>().setMaxSize(10), actionGen);
+    prop.setSeed(1).setNumRuns(100);
+    state.measure([&]() { doNotOptimize(prop.go()); });
+}
+
+// each operation is a concurrency test of 10 runs
+PROPTEST_BENCHMARK(Runner, Concurrency10Runs)
+{
+    auto prop = concurrencyProperty();
+    prop.setSeed(1).setNumRuns(10);
+    state.measure([&]() { doNotOptimize(prop.go()); });
+}
+
+PROPTEST_BENCHMARK(Runner, Concurrency10Runs8Threads)
+{
+    auto prop = concurrencyProperty();
+    prop.setSeed(1).setNumRuns(10).setMaxConcurrency(8);
+    state.measure([&]() { doNotOptimize(prop.go()); });
+}
+
+PROPTEST_BENCHMARK(Runner, Concurrency200Runs)
+{
+    auto prop = concurrencyProperty();
+    prop.setSeed(1).setNumRuns(200);
+    state.measure([&]() { doNotOptimize(prop.go()); });
+}
+
+PROPTEST_BENCHMARK(Runner, Concurrency200RunsScheduled)
+{
+    auto prop = concurrencyProperty();
+    prop.setSeed(1).setNumRuns(200).setScheduling(util::Scheduler::Policy::PCT);
+    state.measure([&]() { doNotOptimize(prop.go()); });
+}
@@ -0,0 +1,120 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+
+namespace {
+
+// greedily walks the shrink tree as Property does, keeping the first shrink that still fails
+template <typename T, typename Fails>
+T shrinkFully(Shrinkable<T> shrinkable, Fails&& fails)
+{
+    auto shrinks = shrinkable.shrinks();
+    while (!shrinks.isEmpty()) {
+        auto itr = shrinks.iterator();
+        bool found = false;
+        while (itr.hasNext()) {
+            auto next = itr.next();
+            if (fails(next.getRef())) {
+                shrinkable = next;
+                shrinks = next.shrinks();
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            break;
+    }
+    return shrinkable.get();
+}
+
+// measures generation and full shrinking of the first failing value drawn from gen
+template <typename T, typename Fails>
+void measureShrink(State& state, Arbi<T> gen, Fails&& fails)
+{
+    Random rand(1);
+    Random saved = rand;
+    while (true) {
+        saved = rand;
+        if (fails(gen(rand).getRef()))
+            break;
+    }
+    state.measure([&]() {
+        Random replay = saved;
+        doNotOptimize(shrinkFully(gen(replay), fails));
+    });
+}
+
+}  // namespace
+
+PROPTEST_BENCHMARK(Shrink, Int)
+{
+    measureShrink(state, Arbi<int>(), [](const int& v) { return v >= 1000; });
+}
+
+PROPTEST_BENCHMARK(Shrink, VectorInt)
+{
+    measureShrink(state, Arbi<vector<int>>(), [](const vector<int>& v) {
+        int64_t sum = 0;
+        for (auto e : v)
+            sum += e > 0 ? e : 0;
+        return v.size() >= 5 && sum > 100;
+    });
+}
+
+PROPTEST_BENCHMARK(Shrink, String)
+{
+    measureShrink(state, Arbi<string>(), [](const string& s) { return s.size() >= 10; });
+}
+
+PROPTEST_BENCHMARK(Shrink, MapIntInt)
+{
+    measureShrink(state, Arbi<map<int, int>>(), [](const map<int, int>& m) { return m.size() >= 3; });
+}
+
+PROPTEST_BENCHMARK(Shrink, UTF8String)
+{
+    measureShrink(state, Arbi<UTF8String>(), [](const UTF8String& s) { return s.size() >= 10; });
+}
+
+namespace {
+
+// shrinks distinct elements where a few scattered elements cause the failure, counting property invocations
+void measureScatteredShrink(State& state, MembershipShrink strategy, int size, int numCulprits)
+{
+    auto shrinkableVec = util::make_shared<vector<Shrinkable<int>>>();
+    for (int i = 0; i < size; i++)
+        shrinkableVec->push_back(make_shrinkable<int>(i));
+    auto shrinkable = shrinkListLike<vector, int>(shrinkableVec, 0, true, strategy);
+    uint64_t numCalls = 0;
+    auto fails = [&numCalls, size, numCulprits](const vector<int>& v) {
+        numCalls++;
+        for (int i = 1; i <= numCulprits; i++) {
+            if (find(v.begin(), v.end(), size * i / (numCulprits + 1)) == v.end())
+                return false;
+        }
+        return true;
+    };
+    state.measure([&]() { doNotOptimize(shrinkFully(shrinkable, fails)); });
+    numCalls = 0;
+    shrinkFully(shrinkable, fails);
+    state.setCounter("invocations/op", static_cast<double>(numCalls));
+}
+
+}  // namespace
+
+PROPTEST_BENCHMARK(Shrink, Scattered2Of2000FrontAndMid)
+{
+    measureScatteredShrink(state, MembershipShrink::FrontAndMid, 2000, 2);
+}
+
+PROPTEST_BENCHMARK(Shrink, Scattered2Of2000DeltaDebugging)
+{
+    measureScatteredShrink(state, MembershipShrink::DeltaDebugging, 2000, 2);
+}
+
+PROPTEST_BENCHMARK(Shrink, Scattered10Of10000DeltaDebugging)
+{
+    measureScatteredShrink(state, MembershipShrink::DeltaDebugging, 10000, 10);
+}
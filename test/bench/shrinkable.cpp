@@ -0,0 +1,59 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+
+PROPTEST_BENCHMARK(Shrinkable, Make)
+{
+    int value = 0;
+    state.measure([&]() { doNotOptimize(make_shrinkable<int>(value++)); });
+}
+
+PROPTEST_BENCHMARK(Shrinkable, MapChain)
+{
+    auto shr = util::binarySearchShrinkable(1000);
+    state.measure([&]() {
+        auto mapped = shr.map<int64_t>([](const int64_t& v) { return v + 1; })
+                          .map<int64_t>([](const int64_t& v) { return v * 2; })
+                          .map<string>([](const int64_t& v) { return to_string(v); });
+        doNotOptimize(mapped);
+    });
+}
+
+PROPTEST_BENCHMARK(Shrinkable, FlatMapChain)
+{
+    auto shr = util::binarySearchShrinkable(1000);
+    state.measure([&]() {
+        auto flatMapped = shr.flatMap<int64_t>([](const int64_t& v) { return util::binarySearchShrinkable(v / 2); })
+                              .flatMap<int64_t>([](const int64_t& v) { return make_shrinkable<int64_t>(v + 1); });
+        doNotOptimize(flatMapped);
+    });
+}
+
+PROPTEST_BENCHMARK(Shrinkable, FilterChain)
+{
+    auto shr = util::binarySearchShrinkable(1000);
+    state.measure([&]() {
+        auto filtered = shr.filter([](const int64_t& v) { return v % 2 == 0; })
+                            .filter([](const int64_t& v) { return v >= 0; });
+        doNotOptimize(filtered);
+    });
+}
+
+PROPTEST_BENCHMARK(Shrinkable, TraverseMapped)
+{
+    // construction and full traversal of the shrink tree of a mapped value
+    auto shr = util::binarySearchShrinkable(1000).map<int64_t>([](const int64_t& v) { return v * 2; });
+    state.measure([&]() {
+        int64_t sum = 0;
+        auto itr = shr.shrinks().iterator();
+        while (itr.hasNext()) {
+            auto next = itr.next();
+            auto innerItr = next.shrinks().iterator();
+            while (innerItr.hasNext())
+                sum += innerItr.next().get();
+        }
+        doNotOptimize(sum);
+    });
+}
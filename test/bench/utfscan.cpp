@@ -0,0 +1,38 @@
+#include "benchmark.hpp"
+#include "../../proptest.hpp"
+#include "../../util/utfscan.hpp"
+
+using namespace proptest;
+using namespace proptest::bench;
+using namespace proptest::util;
+
+namespace {
+
+// 4 KiB of mixed 1 to 4 byte characters
+vector<uint8_t> sampleText(void (*encode)(uint32_t, vector<uint8_t>&))
+{
+    const uint32_t codes[] = {'a', 'Z', 0xe9, 0x3b1, 0x4e2d, 0xac00, 0x1f600, '7'};
+    vector<uint8_t> chars;
+    for (size_t i = 0; chars.size() < 4096; i++)
+        encode(codes[i % 8], chars);
+    return chars;
+}
+
+void measureScan(State& state, void (*encode)(uint32_t, vector<uint8_t>&),
+                 int (*count)(const uint8_t*, size_t, SimdLevel), SimdLevel level)
+{
+    vector<uint8_t> chars = sampleText(encode);
+    state.measure([&]() { doNotOptimize(count(chars.data(), chars.size(), level)); });
+}
+
+}  // namespace
+
+PROPTEST_BENCHMARK(UTFScan, UTF8Scalar) { measureScan(state, encodeUTF8, countUTF8, SimdLevel::Scalar); }
+PROPTEST_BENCHMARK(UTFScan, UTF8SSE4) { measureScan(state, encodeUTF8, countUTF8, SimdLevel::SSE4); }
+PROPTEST_BENCHMARK(UTFScan, UTF8AVX2) { measureScan(state, encodeUTF8, countUTF8, SimdLevel::AVX2); }
+PROPTEST_BENCHMARK(UTFScan, CESU8Scalar) { measureScan(state, encodeCESU8, countCESU8, SimdLevel::Scalar); }
+PROPTEST_BENCHMARK(UTFScan, CESU8SSE4) { measureScan(state, encodeCESU8, countCESU8, SimdLevel::SSE4); }
+PROPTEST_BENCHMARK(UTFScan, CESU8AVX2) { measureScan(state, encodeCESU8, countCESU8, SimdLevel::AVX2); }
+PROPTEST_BENCHMARK(UTFScan, UTF16BEScalar) { measureScan(state, encodeUTF16BE, countUTF16BE, SimdLevel::Scalar); }
+PROPTEST_BENCHMARK(UTFScan, UTF16BESSE4) { measureScan(state, encodeUTF16BE, countUTF16BE, SimdLevel::SSE4); }
+PROPTEST_BENCHMARK(UTFScan, UTF16BEAVX2) { measureScan(state, encodeUTF16BE, countUTF16BE, SimdLevel::AVX2); }
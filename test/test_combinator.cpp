@@ -234,3 +234,77 @@ TEST(PropTest, TestRanges)
     for (int i = 0; i < 10; i++)
         cout << uintGen(rand).get() << endl;
 }
+
+TEST(PropTest, TestConstrained)
+{
+    int64_t seed = getCurrentTime();
+    Random rand(seed);
+
+    auto gen = constrained<int>().atLeast(101).multipleOf(8);
+    for (int i = 0; i < 100; i++) {
+        auto shr = gen(rand);
+        // walk down the shrink tree, checking every candidate on the way
+        while (true) {
+            EXPECT_GT(shr.get(), 100);
+            EXPECT_EQ(shr.get() % 8, 0);
+            auto shrinks = shr.shrinks();
+            if (shrinks.isEmpty())
+                break;
+            for (auto itr = shrinks.iterator(); itr.hasNext();) {
+                int value = itr.next().get();
+                EXPECT_GT(value, 100);
+                EXPECT_EQ(value % 8, 0);
+            }
+            shr = shrinks.head();
+        }
+        EXPECT_EQ(shr.get(), 104);
+    }
+
+    auto gen2 = constrained<int8_t>().in(-10, -3).in(5, 10).exclude({-4, 5, 6}).multipleOf(2, -1);
+    for (int i = 0; i < 100; i++) {
+        auto shr = gen2(rand);
+        int8_t value = shr.get();
+        EXPECT_TRUE((value >= -10 && value <= -3) || (value >= 5 && value <= 10));
+        EXPECT_NE(value % 2, 0);
+        EXPECT_NE(value, 5);
+        // shrinks approach the value closest to zero: -3
+        auto shrinks = shr.shrinks();
+        if (value != -3) {
+            ASSERT_FALSE(shrinks.isEmpty());
+            EXPECT_EQ(shrinks.head().get(), -3);
+        }
+    }
+
+    auto gen3 = constrained<uint64_t>().atLeast(UINT64_MAX - 10).exclude(UINT64_MAX);
+    for (int i = 0; i < 100; i++) {
+        uint64_t value = gen3(rand).get();
+        EXPECT_GE(value, UINT64_MAX - 10);
+        EXPECT_NE(value, UINT64_MAX);
+    }
+
+    EXPECT_THROW(constrained<int>().atLeast(10).atMost(9)(rand), std::invalid_argument);
+    EXPECT_THROW(constrained<int>().in(1, 3).exclude({1, 2, 3})(rand), std::invalid_argument);
+}
+
+TEST(PropTest, TestConstrainedProperty)
+{
+    forAll(
+        [](int a) {
+            PROP_ASSERT(a > 100 && a % 8 == 0);
+            PROP_STAT(a < 1000000);
+        },
+        constrained<int>().atLeast(101).multipleOf(8));
+
+    auto gen = intervals({Interval(INT64_MIN, -10), Interval(10, INT64_MAX)});
+    int64_t seed = getCurrentTime();
+    Random rand(seed);
+    for (int i = 0; i < 100; i++) {
+        auto shr = gen(rand);
+        auto value = shr.get();
+        EXPECT_TRUE(value <= -10 || value >= 10);
+        auto shrinks = shr.shrinks();
+        if (value != 10 && value != -10) {
+            EXPECT_EQ(shrinks.head().get(), 10);
+        }
+    }
+}
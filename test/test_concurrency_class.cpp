@@ -76,3 +76,57 @@ TEST(ConcurrencyAltTest, States)
     auto prop = concurrency<VectorAction3>(Arbi<vector<int>>(), actionListGen);
     prop.go();
 }
+
+namespace {
+
+struct ShrinkRecorder : public Reporter
+{
+    void onEnd(const PropertyReport& report) override { last = report; }
+    PropertyReport last;
+};
+
+}  // namespace
+
+TEST(ConcurrencyAltTest, Shrinking)
+{
+    auto pushBackActionGen =
+        Arbi<int>().map<shared_ptr<VectorAction3>>([](int& value) { return util::make_shared<PushBack3>(value); });
+    auto actionListGen = actionListGenOf<VectorAction3>(pushBackActionGen);
+
+    auto recorder = util::make_shared<ShrinkRecorder>();
+    auto prop = concurrency<VectorAction3>(Arbi<vector<int>>().setMaxSize(0), actionListGen);
+    prop.setSeed(1).setReporter(recorder);
+    EXPECT_FALSE(prop.go([](vector<int>& obj) { PROP_ASSERT(obj.size() < 10); }));
+
+    // the action lists shrink to ten actions in total
+    const PropertyReport& report = recorder->last;
+    EXPECT_FALSE(report.shrinkSteps.empty());
+    int front = -1, rear1 = -1, rear2 = -1;
+    EXPECT_EQ(sscanf(report.counterexample.c_str(), "front: size %d, thr0: size %d, thr1: size %d", &front, &rear1,
+                     &rear2),
+              3);
+    EXPECT_EQ(front + rear1 + rear2, 10);
+    // the rear threads of the interleaving are numbered as in the lists
+    EXPECT_NE(report.counterexample.find("order: thr"), string::npos) << report.counterexample;
+    EXPECT_EQ(report.counterexample.find("thr2"), string::npos) << report.counterexample;
+}
+
+TEST(ConcurrencyAltTest, ShrinkingSharedObject)
+{
+    auto pushBackActionGen =
+        Arbi<int>().map<shared_ptr<VectorAction3>>([](int& value) { return util::make_shared<PushBack3>(value); });
+    auto actionListGen = actionListGenOf<VectorAction3>(pushBackActionGen);
+
+    // every run modifies the same object, so that the failed run starts from what the previous runs left
+    auto recorder = util::make_shared<ShrinkRecorder>();
+    auto prop = concurrency<VectorAction3>(just(vector<int>()), actionListGen);
+    prop.setSeed(1).setReporter(recorder);
+    EXPECT_FALSE(prop.go([](vector<int>& obj) { PROP_ASSERT(obj.size() < 50); }));
+
+    // candidates rerun from the state at the start of the failed run, not from the state it left
+    const string& counterexample = recorder->last.counterexample;
+    int front = -1, rear1 = -1, rear2 = -1;
+    EXPECT_EQ(sscanf(counterexample.c_str(), "front: size %d, thr0: size %d, thr1: size %d", &front, &rear1, &rear2),
+              3);
+    EXPECT_GT(front + rear1 + rear2, 0) << counterexample;
+}
@@ -17,32 +17,40 @@ class ConcurrencyTestAlt2 : public ::testing::Test {
 
 TEST_F(ConcurrencyTestAlt2, bitmap_internal)
 {
-    util::Bitmap bitmap;
-    for (int i = 0; i < util::Bitmap::size; i++) {
-        EXPECT_NE(bitmap.occupyAvailable(0), -1);
+    // the last word is only partially used
+    util::Bitmap bitmap(100);
+    EXPECT_EQ(bitmap.capacity(), 100);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_NE(bitmap.tryAcquire(), -1);
     }
-    bitmap.reset();
-    util::Bitmap copy = bitmap;
-    for (int i = 0; i < util::Bitmap::size; i++) {
-        EXPECT_NE(copy.occupyAvailable(0), -1);
+    EXPECT_EQ(bitmap.tryAcquire(), -1);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(bitmap.isAcquired(i));
     }
-    cout << bitmap.occupyAvailable(0) << endl;
-    cout << bitmap.states[0] << ", " << bitmap.states[1] << endl;
-    cout << bitmap.occupyAvailable(0) << endl;
-    cout << bitmap.states[0] << ", " << bitmap.states[1] << ", " << bitmap.states[2] << endl;
-    cout << bitmap.occupyUnavailable(2) << endl;
+    util::Bitmap copy = bitmap;
+    bitmap.reset();
+    EXPECT_FALSE(bitmap.isAcquired(99));
+    EXPECT_TRUE(copy.isAcquired(99));
+    EXPECT_EQ(copy.tryAcquire(), -1);
+    copy.unacquire(70);
+    EXPECT_FALSE(copy.isAcquired(70));
+    EXPECT_THROW(copy.unacquire(70), runtime_error);
+    EXPECT_EQ(copy.tryAcquire(), 70);
+    // waits only as long as given
+    EXPECT_EQ(copy.acquire(std::chrono::milliseconds(1)), -1);
+    EXPECT_THROW(util::Bitmap(util::Bitmap::maxCapacity + 1), invalid_argument);
 }
 
 TEST_F(ConcurrencyTestAlt2, bitmap)
 {
     util::Bitmap bitmap;
-    for (int i = 0; i < util::Bitmap::size; i++) {
+    for (int i = 0; i < util::Bitmap::maxCapacity; i++) {
         EXPECT_NE(bitmap.acquire(), -1);
     }
     bitmap.reset();
     util::Bitmap copy = bitmap;
     int n = -1;
-    for (int i = 0; i < util::Bitmap::size; i++) {
+    for (int i = 0; i < util::Bitmap::maxCapacity; i++) {
         EXPECT_NE((n = copy.acquire()), -1);
     }
     EXPECT_EQ(copy.tryAcquire(), -1);
@@ -51,6 +59,42 @@ TEST_F(ConcurrencyTestAlt2, bitmap)
     EXPECT_EQ(copy.tryAcquire(), -1);
 }
 
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+TEST_F(ConcurrencyTestAlt2, bitmap_deprecated)
+{
+    EXPECT_EQ(util::Bitmap::size, util::Bitmap::maxCapacity);
+}
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+TEST_F(ConcurrencyTestAlt2, bitmap_threads)
+{
+    util::Bitmap bitmap(64);
+    vector<std::atomic<int>> owners(64);
+    std::atomic<int> conflicts(0);
+    vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10000; i++) {
+                int pos = bitmap.acquire();
+                if (owners[pos].fetch_add(1) != 0)
+                    conflicts++;
+                owners[pos].fetch_sub(1);
+                bitmap.unacquire(pos);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(conflicts.load(), 0);
+    for (int i = 0; i < 64; i++)
+        EXPECT_FALSE(bitmap.isAcquired(i));
+}
+
 TEST_F(ConcurrencyTestAlt2, Container) {}
 
 struct VectorAction4 : public Action<vector<int>, util::Bitmap>
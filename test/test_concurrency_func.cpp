@@ -1,3 +1,4 @@
+#include "testbase.hpp"
 #include "statefultest.hpp"
 #include "googletest/googletest/include/gtest/gtest.h"
 #include "googletest/googlemock/include/gmock/gmock.h"
@@ -81,6 +82,208 @@ TEST(ConcurrencyTest, WithModel)
     prop.go();
 }
 
+namespace {
+
+struct LogRecorder : public Reporter
+{
+    void onLog(const PropertyReport&, const string& log) override { logs.push_back(log); }
+    void onEnd(const PropertyReport& report) override { last = report; }
+
+    vector<string> logs;
+    PropertyReport last;
+};
+
+}  // namespace
+
+TEST(ConcurrencyTest, RunLog)
+{
+    auto pushBackGen = Arbi<int>().map<SimpleAction<vector<int>>>([](int& value) {
+        return SimpleAction<vector<int>>("PushBack", [value](vector<int>& obj) {
+            lock_guard<mutex> guard(getMutex());
+            obj.push_back(value);
+        });
+    });
+
+    auto recorder = util::make_shared<LogRecorder>();
+    auto prop = concurrency<vector<int>>(Arbi<vector<int>>(), pushBackGen);
+    prop.setSeed(1).setNumRuns(20).setReporter(recorder);
+
+    // interleavings of passed runs are rendered only if verbose
+    EXPECT_TRUE(prop.go());
+    EXPECT_TRUE(recorder->logs.empty());
+    EXPECT_TRUE(recorder->last.log.empty());
+
+    {
+        VerbosityGuard verbose(Verbosity::Verbose);
+        EXPECT_TRUE(prop.go());
+    }
+    EXPECT_EQ(recorder->logs.size(), 20U);
+    EXPECT_EQ(recorder->logs[0].find("count: "), 0U);
+
+    // interleaving of the failed run is kept in the report
+    recorder->logs.clear();
+    prop.setPostCheck([](vector<int>& obj) { PROP_ASSERT(obj.size() < 3); });
+    EXPECT_FALSE(prop.go());
+    EXPECT_TRUE(recorder->logs.empty());
+    EXPECT_FALSE(recorder->last.passed);
+    EXPECT_EQ(recorder->last.log.find("count: "), 0U);
+    EXPECT_NE(recorder->last.log.find("PushBack"), string::npos);
+}
+
+TEST(ConcurrencyTest, ManyThreads)
+{
+    auto pushBackGen = Arbi<int>().map<SimpleAction<vector<int>>>([](int& value) {
+        return SimpleAction<vector<int>>("PushBack", [value](vector<int>& obj) {
+            lock_guard<mutex> guard(getMutex());
+            obj.push_back(value);
+        });
+    });
+
+    // every action of the 16 rear threads is in the interleaving
+    auto recorder = util::make_shared<LogRecorder>();
+    auto prop = concurrency<vector<int>>(Arbi<vector<int>>().setMaxSize(0), pushBackGen);
+    prop.setSeed(1).setNumRuns(20).setMaxConcurrency(16).setReporter(recorder);
+    prop.setPostCheck([](vector<int>& obj) { PROP_ASSERT(obj.size() < 100); });
+    EXPECT_FALSE(prop.go());
+    const string& log = recorder->last.log;
+    size_t count = std::stoul(log.substr(string("count: ").size()));
+    auto occurrences = [&log](const string& str) {
+        size_t num = 0;
+        for (size_t pos = log.find(str); pos != string::npos; pos = log.find(str, pos + 1))
+            num++;
+        return num;
+    };
+    EXPECT_EQ(occurrences(" -> "), count);
+    EXPECT_EQ(occurrences(" start -> "), occurrences(" end -> "));
+    EXPECT_NE(log.find("thr15 PushBack"), string::npos);
+}
+
+TEST(ConcurrencyTest, Scheduling)
+{
+    struct Counter
+    {
+        Counter() : value(0) {}
+        Counter(const Counter& other) : value(other.value.load()) {}
+        atomic_int value;
+    };
+
+    for (auto policy : {util::Scheduler::Policy::Random, util::Scheduler::Policy::PCT}) {
+        // an increment that is not atomic, with a scheduling point between the load and the store
+        auto incrementGen = just(operation<Counter, int, int>(
+            "Increment",
+            [](Counter& counter) {
+                int value = counter.value.load();
+                proptest::yield();
+                counter.value.store(value + 1);
+                return value;
+            },
+            [](int& count) { return count++; }));
+        auto recorder = util::make_shared<LogRecorder>();
+        auto prop = concurrency<Counter, int>(
+            lazy<Counter>([]() { return Counter(); }), [](Counter& counter) { return counter.value.load(); },
+            incrementGen);
+        prop.setSeed(1).setScheduling(policy).setReporter(recorder);
+        EXPECT_FALSE(prop.go());
+        EXPECT_NE(recorder->last.failure.find("not linearizable"), string::npos);
+
+        // the failed run is replayed with the seed
+        PropertyReport first = recorder->last;
+        EXPECT_FALSE(prop.go());
+        EXPECT_EQ(recorder->last.runs, first.runs);
+        EXPECT_EQ(recorder->last.failure, first.failure);
+        EXPECT_EQ(recorder->last.log, first.log);
+    }
+}
+
+TEST(ConcurrencyTest, Shrinking)
+{
+    auto pushBackGen = Arbi<int>().map<SimpleAction<vector<int>>>([](int& value) {
+        return SimpleAction<vector<int>>("PushBack", [value](vector<int>& obj) {
+            lock_guard<mutex> guard(getMutex());
+            obj.push_back(value);
+        });
+    });
+
+    // shrinks to two rear threads and ten actions in total
+    auto recorder = util::make_shared<LogRecorder>();
+    auto prop = concurrency<vector<int>>(Arbi<vector<int>>().setMaxSize(0), pushBackGen);
+    prop.setSeed(1).setMaxConcurrency(4).setReporter(recorder);
+    prop.setPostCheck([](vector<int>& obj) { PROP_ASSERT(obj.size() < 10); });
+    EXPECT_FALSE(prop.go());
+    const PropertyReport& report = recorder->last;
+    EXPECT_FALSE(report.shrinkSteps.empty());
+    EXPECT_EQ(report.counterexample.find("front: ["), 0U);
+    EXPECT_NE(report.counterexample.find("thr1: ["), string::npos);
+    EXPECT_EQ(report.counterexample.find("thr2: ["), string::npos);
+    size_t numActions = 0;
+    for (size_t pos = report.counterexample.find("PushBack"); pos != string::npos;
+         pos = report.counterexample.find("PushBack", pos + 1))
+        numActions++;
+    // each action appears in the lists and in the interleaving, where a rear action starts and ends
+    size_t numFront = 0;
+    string front = report.counterexample.substr(0, report.counterexample.find(", thr0"));
+    for (size_t pos = front.find("PushBack"); pos != string::npos; pos = front.find("PushBack", pos + 1))
+        numFront++;
+    EXPECT_EQ(numActions, 10 + numFront + (10 - numFront) * 2);
+
+    // no shrinking without budget
+    prop.setShrinkBudget(0);
+    EXPECT_FALSE(prop.go());
+    EXPECT_TRUE(recorder->last.shrinkSteps.empty());
+    EXPECT_TRUE(recorder->last.counterexample.empty());
+}
+
+TEST(ConcurrencyTest, ShrinkingSharedObject)
+{
+    auto pushBackGen = Arbi<int>().map<SimpleAction<vector<int>>>([](int& value) {
+        return SimpleAction<vector<int>>("PushBack", [value](vector<int>& obj) {
+            lock_guard<mutex> guard(getMutex());
+            obj.push_back(value);
+        });
+    });
+
+    // every run modifies the same object, so that the failed run starts from what the previous runs left
+    auto recorder = util::make_shared<LogRecorder>();
+    auto prop = concurrency<vector<int>>(just(vector<int>()), pushBackGen);
+    prop.setSeed(1).setReporter(recorder);
+    prop.setPostCheck([](vector<int>& obj) { PROP_ASSERT(obj.size() < 50); });
+    EXPECT_FALSE(prop.go());
+
+    // candidates rerun from the state at the start of the failed run, not from the state it left
+    const string& counterexample = recorder->last.counterexample;
+    EXPECT_NE(counterexample.find("PushBack"), string::npos) << counterexample;
+}
+
+TEST(ConcurrencyTest, ExpectationsInActions)
+{
+    auto pushBackGen = Arbi<int>().map<SimpleAction<vector<int>>>([](int& value) {
+        return SimpleAction<vector<int>>("PushBack", [value](vector<int>& obj) {
+            PROP_TAG("negative", value < 0);
+            PROP_EXPECT(value < 1000000) << "pushing " << value;
+            lock_guard<mutex> guard(getMutex());
+            obj.push_back(value);
+        });
+    });
+
+    auto recorder = util::make_shared<LogRecorder>();
+    auto prop = concurrency<vector<int>>(Arbi<vector<int>>(), pushBackGen);
+    EXPECT_FALSE(prop.setSeed(1).setReporter(recorder).go());
+    auto& report = recorder->last;
+    EXPECT_FALSE(report.passed);
+    EXPECT_NE(report.failure.find("value < 1000000"), string::npos);
+    EXPECT_NE(report.failure.find("with pushing "), string::npos);
+    EXPECT_EQ(report.log.find("count: "), 0U);
+    EXPECT_FALSE(report.tags["negative"].empty());
+
+    // an assertion failed in a rear thread fails the test instead of terminating
+    auto assertingGen = Arbi<int>().map<SimpleAction<vector<int>>>([](int& value) {
+        return SimpleAction<vector<int>>("Check", [value](vector<int>&) { PROP_ASSERT(value < 1000000); });
+    });
+    auto prop2 = concurrency<vector<int>>(Arbi<vector<int>>(), assertingGen);
+    EXPECT_FALSE(prop2.setSeed(1).setReporter(recorder).go());
+    EXPECT_NE(recorder->last.failure.find("value < 1000000"), string::npos);
+}
+
 TEST(ConcurrencyTest, bitmap)
 {
     using Bitmap = util::Bitmap;
@@ -90,7 +293,7 @@ TEST(ConcurrencyTest, bitmap)
         bitmap.unacquire(pos);
     }));
 
-    [[maybe_unused]] auto unacquireGen = integers<int>(0, Bitmap::size).map<SimpleAction<Bitmap>>(+[](int& pos) {
+    [[maybe_unused]] auto unacquireGen = integers<int>(0, Bitmap::maxCapacity).map<SimpleAction<Bitmap>>(+[](int& pos) {
         return SimpleAction<Bitmap>("Unacquire", [pos](Bitmap& bitmap) {
             try {
                 bitmap.unacquire(pos);
@@ -1,5 +1,8 @@
 #include "testbase.hpp"
 #include "../util/std.hpp"
+#include "../shrinker/string.hpp"
+#include "../shrinker/stringlike.hpp"
+#include <bitset>
 
 using namespace proptest;
 
@@ -291,6 +294,185 @@ TEST(PropTest, ShrinkSetExhaustive)
 
 }
 
+namespace {
+
+// walks the shrink tree as Property does, keeping the first shrink that still fails
+template <typename T, typename Fails>
+T shrinkGreedily(Shrinkable<T> shrinkable, Fails&& fails)
+{
+    auto shrinks = shrinkable.shrinks();
+    while (!shrinks.isEmpty()) {
+        auto itr = shrinks.iterator();
+        bool found = false;
+        while (itr.hasNext()) {
+            auto next = itr.next();
+            if (fails(next.getRef())) {
+                shrinks = next.shrinks();
+                shrinkable = next;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            break;
+    }
+    return shrinkable.get();
+}
+
+}  // namespace
+
+TEST(PropTest, ShrinkVectorMembershipExhaustive)
+{
+    // every sublist of at least minSize elements appears exactly once in the shrink tree
+    for (int size = 0; size <= 7; size++) {
+        for (int minSize = 0; minSize <= size; minSize++) {
+            auto shrinkableVec = util::make_shared<vector<Shrinkable<int>>>();
+            for (int i = 0; i < size; i++)
+                shrinkableVec->push_back(make_shrinkable<int>(i));
+            auto root = shrinkListLike<vector, int>(shrinkableVec, minSize, false);
+            set<vector<int>> found;
+            int numTotal = 0;
+            exhaustive<vector<int>>(root, 0, [&found, &numTotal, minSize](const Shrinkable<vector<int>>& shr, int) {
+                auto& vec = shr.getRef();
+                EXPECT_GE(vec.size(), static_cast<size_t>(minSize));
+                EXPECT_TRUE(is_sorted(vec.begin(), vec.end()));
+                found.insert(vec);
+                numTotal++;
+            });
+            size_t numSublists = 0;
+            for (int mask = 0; mask < (1 << size); mask++) {
+                if (static_cast<int>(std::bitset<32>(mask).count()) >= minSize)
+                    numSublists++;
+            }
+            EXPECT_EQ(found.size(), numSublists);
+            EXPECT_EQ(static_cast<size_t>(numTotal), numSublists);
+        }
+    }
+}
+
+TEST(PropTest, ShrinkVectorDeltaDebugging)
+{
+    auto shrinkableVec = util::make_shared<vector<Shrinkable<int>>>();
+    for (int i = 0; i < 1000; i++)
+        shrinkableVec->push_back(make_shrinkable<int>(i));
+
+    int numCalls = 0;
+    auto fails = [&numCalls](const vector<int>& vec) {
+        numCalls++;
+        return find(vec.begin(), vec.end(), 137) != vec.end() && find(vec.begin(), vec.end(), 862) != vec.end();
+    };
+
+    auto ddmin = shrinkListLike<vector, int>(shrinkableVec, 0, true, MembershipShrink::DeltaDebugging);
+    EXPECT_EQ(shrinkGreedily(ddmin, fails), (vector<int>{137, 862}));
+    // two culprits among n elements are isolated with O(log n) candidates
+    EXPECT_LT(numCalls, 100);
+
+
+    // candidates never go below minimum size
+    numCalls = 0;
+    auto ddminMinSize = shrinkListLike<vector, int>(shrinkableVec, 5, false, MembershipShrink::DeltaDebugging);
+    auto shrunk = shrinkGreedily(ddminMinSize, [&fails](const vector<int>& vec) {
+        EXPECT_GE(vec.size(), 5U);
+        return fails(vec);
+    });
+    EXPECT_EQ(shrunk.size(), 5U);
+    EXPECT_TRUE(fails(shrunk));
+}
+
+TEST(PropTest, ShrinkVectorElementwisePartitions)
+{
+    // elements shrink towards 0, and only the first is relevant to the failure
+    auto shrinkableVec = util::make_shared<vector<Shrinkable<int>>>();
+    for (int value : {90, 70, 80, 60, 40})
+        shrinkableVec->push_back(util::binarySearchShrinkable(value).map<int>([](const int64_t& v) {
+            return static_cast<int>(v);
+        }));
+
+    auto fails = [](const vector<int>& vec) { return vec.size() == 5 && vec[0] >= 90; };
+    // shrinking all elements in lockstep always shrinks the first one, but the second half is shrunk on its own
+    auto shrinkable = shrinkListLike<vector, int>(shrinkableVec, 5);
+    EXPECT_EQ(shrinkGreedily(shrinkable, fails), (vector<int>{90, 70, 0, 0, 0}));
+}
+
+TEST(PropTest, ShrinkSetDeltaDebugging)
+{
+    auto gen = Arbi<set<int>>(interval(0, 10000)).setSize(2, 300).setMembershipShrink(MembershipShrink::DeltaDebugging);
+    Random rand(1);
+    auto shrinkable = gen(rand);
+    int smallest = *shrinkable.getRef().begin();
+    int largest = *shrinkable.getRef().rbegin();
+    auto shrunk = shrinkGreedily(shrinkable, [smallest, largest](const set<int>& s) {
+        return s.find(smallest) != s.end() && s.find(largest) != s.end();
+    });
+    EXPECT_EQ(shrunk, (set<int>{smallest, largest}));
+}
+
+
+TEST(PropTest, ShrinkStringInterior)
+{
+    auto fails = [](const string& str) { return str.find('!') != string::npos && str.find('4') != string::npos; };
+    // truncation leaves "! 4", and the space in between is deleted
+    EXPECT_EQ(shrinkGreedily(shrinkString("hello, World! 42 times", 0), fails), "!4");
+
+    // characters are simplified by their classes
+    auto longEnough = [](const string& str) { return str.size() >= 4; };
+    EXPECT_EQ(shrinkGreedily(shrinkString("Zq9&x\x7f", 0, util::SimplestAll), longEnough), "Aa0 ");
+    // only to allowed targets
+    EXPECT_EQ(shrinkGreedily(shrinkString("Zq9&x\x7f", 0, util::SimplestLower | util::SimplestDigit), longEnough),
+              "Za0&");
+    EXPECT_EQ(shrinkGreedily(shrinkString("Zq9&x\x7f", 0), longEnough), "Zq9&");
+
+    // generated characters stay in their class
+    Random rand(getCurrentTime());
+    auto gen = Arbi<string>(CharClass::Alphanumeric).setSize(3, 50);
+    auto shrunk = shrinkGreedily(gen(rand), [](const string& str) { return str.size() >= 3; });
+    EXPECT_EQ(shrunk.size(), 3U);
+    for (char c : shrunk)
+        EXPECT_TRUE(isalnum(static_cast<unsigned char>(c))) << shrunk;
+}
+
+namespace {
+
+template <typename StringLike>
+void testShrinkStringLikeInterior(void (*encode)(uint32_t, vector<uint8_t>&))
+{
+    vector<uint8_t> chars;
+    vector<int> positions;
+    for (uint32_t code : {0x4E2Du, 0x78u, 0x1F600u, 0x35u, 0x10FFFFu}) {
+        positions.push_back(static_cast<int>(chars.size()));
+        encode(code, chars);
+    }
+    positions.push_back(static_cast<int>(chars.size()));
+    StringLike str(chars.begin(), chars.end());
+
+    auto fails = [](const StringLike& s) { return s.charsize() >= 4; };
+    auto shrunk = shrinkGreedily(shrinkStringLike<StringLike>(str, 0, 5, positions, util::SimplestAll), fails);
+    chars.clear();
+    for (uint32_t code : {0x20u, 0x61u, 0x20u, 0x30u})
+        encode(code, chars);
+    EXPECT_EQ(shrunk, StringLike(chars.begin(), chars.end()));
+
+    // candidates from generated strings stay valid, as `charsize` would throw otherwise
+    Random rand(getCurrentTime());
+    auto gen = Arbi<StringLike>().setSize(0, 50);
+    auto longEnough = [](const StringLike& s) { return s.charsize() >= 2; };
+    for (int i = 0; i < 10; i++) {
+        auto shrinkable = gen(rand);
+        if (longEnough(shrinkable.getRef())) {
+            EXPECT_EQ(shrinkGreedily(shrinkable, longEnough).charsize(), 2U);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(PropTest, ShrinkStringLikeInterior)
+{
+    testShrinkStringLikeInterior<UTF8String>(util::encodeUTF8);
+    testShrinkStringLikeInterior<UTF16BEString>(util::encodeUTF16BE);
+    testShrinkStringLikeInterior<UTF16LEString>(util::encodeUTF16LE);
+    testShrinkStringLikeInterior<CESU8String>(util::encodeCESU8);
+}
 
 TEST(PropTest, TuplePair1)
 {
@@ -0,0 +1,130 @@
+#include "testbase.hpp"
+#include "../combinator/concurrency_function.hpp"
+#include "../combinator/linearizability.hpp"
+#include "../util/std.hpp"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace proptest;
+using namespace proptest::concurrent;
+
+using std::mutex;
+using std::lock_guard;
+
+namespace {
+
+// increment of a counter model that observed given value
+Observation<int> increment(int result)
+{
+    Observation<int> observation;
+    observation.step = [result](int& count) { return count++ == result; };
+    observation.show = [result](ostream& os) { os << result; };
+    return observation;
+}
+
+struct Counter
+{
+    Counter() : value(0) {}
+    Counter(const Counter& other) : value(other.value.load()) {}
+
+    mutex mtx;
+    atomic_int value;
+};
+
+}  // namespace
+
+TEST(LinearizabilityTest, Sequential)
+{
+    LinearizabilityChecker<int> checker;
+    checker.add("Increment", 0, 1, 2, increment(0));
+    checker.add("Increment", 1, 3, 4, increment(1));
+    checker.add("Increment", 0, 5, 6, increment(2));
+    EXPECT_TRUE(checker.check(0));
+    EXPECT_FALSE(checker.check(1));
+}
+
+TEST(LinearizabilityTest, Overlapping)
+{
+    // overlapping operations may take effect in any order
+    LinearizabilityChecker<int> checker;
+    checker.add("Increment", 0, 1, 4, increment(1));
+    checker.add("Increment", 1, 2, 3, increment(0));
+    checker.add("Increment", 2, 5, 6, increment(2));
+    EXPECT_TRUE(checker.check(0));
+
+    // an operation returning before another is called takes effect first
+    checker.clear();
+    checker.add("Increment", 0, 1, 2, increment(1));
+    checker.add("Increment", 1, 3, 4, increment(0));
+    EXPECT_FALSE(checker.check(0));
+    EXPECT_EQ(checker.getFailure(),
+              "history of 2 operations is not linearizable: at most 0 can be ordered before thr0 Increment returning 1 "
+              "(called at 1, returned at 2)");
+
+    // lost update
+    checker.clear();
+    checker.add("Increment", 0, 1, 3, increment(0));
+    checker.add("Increment", 1, 2, 4, increment(0));
+    checker.add("Increment", 0, 5, 6, increment(1));
+    EXPECT_FALSE(checker.check(0));
+    EXPECT_NE(checker.getFailure().find("at most 1 can be ordered before"), string::npos);
+}
+
+TEST(LinearizabilityTest, LargeHistory)
+{
+    // 2000 increments over 4 threads, each overlapping with the next three
+    const int numOps = 2000;
+    vector<int> order(numOps);
+    for (int i = 0; i < numOps; i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(1));
+
+    LinearizabilityChecker<int> checker;
+    for (int i : order)
+        checker.add("Increment", i % 4, 4 * i, 4 * i + 13, increment(i));
+    EXPECT_EQ(checker.size(), static_cast<size_t>(numOps));
+    auto startTime = std::chrono::steady_clock::now();
+    EXPECT_TRUE(checker.check(0));
+    EXPECT_LT(std::chrono::steady_clock::now() - startTime, std::chrono::seconds(5));
+
+    // one stale result among them
+    checker.add("Increment", 0, 4 * numOps, 4 * numOps + 1, increment(numOps - 1));
+    EXPECT_FALSE(checker.check(0));
+}
+
+TEST(LinearizabilityTest, Concurrency)
+{
+    using ActionType = Action<Counter, int>;
+    auto incrementGen = just(operation<Counter, int, int>(
+        "Increment",
+        [](Counter& counter) {
+            lock_guard<mutex> guard(counter.mtx);
+            return counter.value++;
+        },
+        [](int& count) { return count++; }));
+    auto getGen = just(operation<Counter, int, int>(
+        "Get", [](Counter& counter) { return counter.value.load(); }, [](int& count) { return count; }));
+    auto actionGen = oneOf<ActionType>(incrementGen, getGen);
+
+    auto prop = concurrency<Counter, int>(
+        just(Counter()), [](Counter& counter) { return counter.value.load(); }, actionGen);
+    EXPECT_TRUE(prop.setSeed(1).setNumRuns(50).go());
+
+    // an increment that is not atomic loses updates
+    auto racyIncrementGen = just(operation<Counter, int, int>(
+        "Increment",
+        [](Counter& counter) {
+            int value = counter.value.load();
+            std::this_thread::yield();
+            counter.value.store(value + 1);
+            return value;
+        },
+        [](int& count) { return count++; }));
+    auto racyActionGen = oneOf<ActionType>(racyIncrementGen, getGen);
+    auto racyProp = concurrency<Counter, int>(
+        just(Counter()), [](Counter& counter) { return counter.value.load(); }, racyActionGen);
+    EXPECT_FALSE(racyProp.setSeed(1).setMaxConcurrency(4).go());
+}
@@ -63,6 +63,58 @@ TYPED_TEST(IntegralTest, GenInRange)
     }
 }
 
+template <typename T>
+void expectSameShrinks(const Shrinkable<T>& shr, const Shrinkable<T>& expected, int depth)
+{
+    ASSERT_EQ(shr.get(), expected.get());
+    if (depth == 0)
+        return;
+    auto itr = shr.shrinks().iterator();
+    auto expectedItr = expected.shrinks().iterator();
+    // compare the first few candidates of each level, in order
+    for (int i = 0; i < 4 && expectedItr.hasNext(); i++) {
+        ASSERT_TRUE(itr.hasNext());
+        expectSameShrinks(itr.next(), expectedItr.next(), depth - 1);
+    }
+}
+
+TYPED_TEST(IntegralTest, IntegralShrinkableOrder)
+{
+    int64_t seed = getCurrentTime();
+    Random rand(seed);
+    Arbi<TypeParam> gen;
+
+    for (int i = 0; i < 20; i++) {
+        TypeParam value = gen(rand).get();
+        TypeParam target = i % 2 == 0 ? static_cast<TypeParam>(0) : gen(rand).get();
+        if (value < target)
+            std::swap(value, target);
+        // shrinking towards target from above and from below, as with binarySearchShrinkable
+        uint64_t distance = static_cast<uint64_t>(value) - static_cast<uint64_t>(target);
+        auto fromAbove = util::binarySearchShrinkableU(distance).template map<TypeParam>(
+            [target](const uint64_t& d) { return static_cast<TypeParam>(static_cast<uint64_t>(target) + d); });
+        expectSameShrinks(util::integralShrinkable<TypeParam>(value, target), fromAbove, 4);
+
+        if (distance <= static_cast<uint64_t>(INT64_MAX)) {
+            auto fromBelow = util::binarySearchShrinkable(-static_cast<int64_t>(distance))
+                                 .template map<TypeParam>([value](const int64_t& d) {
+                                     return static_cast<TypeParam>(static_cast<uint64_t>(value) + d);
+                                 });
+            expectSameShrinks(util::integralShrinkable<TypeParam>(target, value), fromBelow, 4);
+        }
+    }
+
+    // exhaustive comparison for small distances
+    for (int64_t v = -20; v <= 20; v++) {
+        TypeParam value = static_cast<TypeParam>(v);
+        if (static_cast<int64_t>(value) != v || (v < 0 && !std::is_signed<TypeParam>::value))
+            continue;
+        auto expected = util::binarySearchShrinkable(v).template map<TypeParam>(
+            [](const int64_t& d) { return static_cast<TypeParam>(d); });
+        expectSameShrinks(util::integralShrinkable<TypeParam>(value, 0), expected, 10);
+    }
+}
+
 TEST(PropTest, GenerateBool)
 {
     int64_t seed = getCurrentTime();
@@ -75,6 +127,37 @@ TEST(PropTest, GenerateBool)
     }
 }
 
+TEST(PropTest, GenerateChar)
+{
+    int64_t seed = getCurrentTime();
+    Random rand(seed);
+    Arbi<char> gen;
+
+    // covers [CHAR_MIN, CHAR_MAX], i.e. [-128, 127] where char is signed and [0, 255] where it is unsigned
+    const int minChar = static_cast<int>(numeric_limits<char>::min());
+    const int maxChar = static_cast<int>(numeric_limits<char>::max());
+    const int midChar = minChar + (maxChar - minChar) / 2;
+    bool lowerHalf = false, upperHalf = false;
+    auto check = [&](char c) {
+        int val = static_cast<int>(c);
+        EXPECT_TRUE(val >= minChar && val <= maxChar) << val;
+        lowerHalf = lowerHalf || val <= midChar;
+        upperHalf = upperHalf || val > midChar;
+    };
+    for (int i = 0; i < 1000; i++)
+        check(gen(rand).get());
+    EXPECT_TRUE(lowerHalf && upperHalf);
+
+    lowerHalf = upperHalf = false;
+    for (int i = 0; i < 1000; i++)
+        check(rand.getRandom<char>(numeric_limits<char>::min(), numeric_limits<char>::max()));
+    EXPECT_TRUE(lowerHalf && upperHalf);
+    for (int i = 0; i < 100; i++) {
+        char val = rand.getRandom<char>(10, 100);
+        EXPECT_TRUE(val >= 10 && val <= 100);
+    }
+}
+
 TEST(PropTest, GenString)
 {
     int64_t seed = getCurrentTime();
@@ -103,6 +186,44 @@ TEST(PropTest, GenString2)
     }
 }
 
+TEST(PropTest, GenStringCharClass)
+{
+    auto check = [](CharClass charClass, function<bool(char)> inClass, size_t numChars) {
+        Random rand(getCurrentTime());
+        Arbi<string> gen(charClass);
+        gen.setSize(0, 300);
+        set<char> found;
+        for (int i = 0; i < 100; i++) {
+            auto str = gen(rand).get();
+            for (char c : str) {
+                EXPECT_TRUE(inClass(c)) << static_cast<int>(c);
+                found.insert(c);
+            }
+        }
+        // every character of the class appears among about 15000 draws
+        EXPECT_EQ(found.size(), numChars);
+    };
+
+    check(CharClass::ASCII, [](char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return u >= 0x1 && u <= 0x7f;
+    }, 127);
+    check(CharClass::Printable, [](char c) { return c >= 0x20 && c <= 0x7e; }, 95);
+    check(CharClass::Alphanumeric, [](char c) { return isalnum(static_cast<unsigned char>(c)) != 0; }, 62);
+    check(CharClass::Bytes, [](char) { return true; }, 256);
+
+    // same seed, same strings
+    Random rand1(1), rand2(1);
+    EXPECT_EQ(Arbi<string>()(rand1).get(), Arbi<string>()(rand2).get());
+
+    // an element generator assigned later replaces the class
+    Arbi<string> gen(CharClass::Alphanumeric);
+    gen.elemGen = interval<char>('!', '#');
+    gen.setSize(1, 50);
+    for (char c : gen(rand1).get())
+        EXPECT_TRUE(c >= '!' && c <= '#') << static_cast<int>(c);
+}
+
 void testUTF8(PropertyContext& context, Random rand)
 {
     Arbi<UTF8String> gen;
@@ -332,6 +453,93 @@ TEST(PropTest, GenUnicodeString)
     context.printSummary();
 }
 
+TEST(PropTest, GenUnicodeClass)
+{
+    // code points of a sampler are exactly those at its indices, in increasing order
+    auto contains = [](const CodePointSampler& sampler, uint32_t code) {
+        uint32_t lo = 0, hi = sampler.size();
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (sampler.codePointAt(mid) < code)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo < sampler.size() && sampler.codePointAt(lo) == code;
+    };
+
+    Random rand(getCurrentTime());
+    for (auto unicodeClass : {UnicodeClass::Any, UnicodeClass::Letter, UnicodeClass::Digit,
+                              UnicodeClass::CombiningMark, UnicodeClass::Emoji}) {
+        CodePointSampler sampler(unicodeClass);
+        for (uint32_t i = 1; i < sampler.size(); i += 97)
+            EXPECT_LT(sampler.codePointAt(i - 1), sampler.codePointAt(i));
+
+        uint32_t codes[100];
+        sampler.fill(rand, codes, 100);
+        for (uint32_t code : codes) {
+            EXPECT_TRUE(contains(sampler, code)) << code;
+            EXPECT_TRUE(sampler.contains(code)) << code;
+            EXPECT_TRUE(contains(sampler, sampler(rand)));
+        }
+        EXPECT_FALSE(sampler.contains(0));
+        EXPECT_FALSE(sampler.contains(0xD800));
+
+        // decoded back from generated UTF-16 strings
+        Arbi<UTF16BEString> gen(unicodeClass);
+        gen.setSize(0, 100);
+        for (int i = 0; i < 10; i++) {
+            UTF16BEString str = gen(rand).get();
+            for (size_t pos = 0; pos + 1 < str.size(); pos += 2) {
+                uint32_t unit = (static_cast<uint8_t>(str[pos]) << 8) | static_cast<uint8_t>(str[pos + 1]);
+                if (0xD800 <= unit && unit <= 0xDBFF) {
+                    uint32_t low = (static_cast<uint8_t>(str[pos + 2]) << 8) | static_cast<uint8_t>(str[pos + 3]);
+                    unit = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                    pos += 2;
+                }
+                EXPECT_TRUE(contains(sampler, unit)) << unit;
+            }
+        }
+    }
+
+    CodePointSampler any;
+    EXPECT_EQ(any.size(), 0x10FFFFU - 0x800U);
+    EXPECT_EQ(any.codePointAt(0), 0x1U);
+    EXPECT_EQ(any.codePointAt(0xD7FE), 0xD7FFU);
+    EXPECT_EQ(any.codePointAt(0xD7FF), 0xE000U);
+    EXPECT_EQ(any.codePointAt(any.size() - 1), 0x10FFFFU);
+
+    CodePointSampler digit(UnicodeClass::Digit);
+    for (char c = '0'; c <= '9'; c++)
+        EXPECT_TRUE(contains(digit, static_cast<uint32_t>(c)));
+    EXPECT_FALSE(contains(digit, 'a'));
+
+    // words are assembled from random bytes in little-endian order, whatever the byte order of the platform
+    Random rand1(7), rand2(7);
+    uint32_t filled[4];
+    any.fill(rand1, filled, 4);
+    uint8_t bytes[16];
+    rand2.getRandomBytes(bytes, 16);
+    for (size_t i = 0; i < 4; i++) {
+        uint64_t word = bytes[i * 4] | (bytes[i * 4 + 1] << 8) | (bytes[i * 4 + 2] << 16) |
+                        (static_cast<uint64_t>(bytes[i * 4 + 3]) << 24);
+        EXPECT_EQ(filled[i], any.codePointAt(static_cast<uint32_t>((word * any.size()) >> 32)));
+    }
+
+    // an element generator assigned later replaces the class
+    Arbi<UTF8String> utf8Gen(UnicodeClass::Emoji);
+    utf8Gen.elemGen = interval<uint32_t>('x', 'z');
+    utf8Gen.setSize(1, 50);
+    for (char c : static_cast<string>(utf8Gen(rand).get()))
+        EXPECT_TRUE(c >= 'x' && c <= 'z') << static_cast<int>(c);
+
+    // shrinks towards the first code point of the class
+    auto shr = UnicodeGen(UnicodeClass::Letter)(rand);
+    if (shr.get() != 'A') {
+        EXPECT_EQ(shr.shrinks().head().get(), static_cast<uint32_t>('A'));
+    }
+}
+
 TEST(PropTest, GenUTF8String)
 {
     int64_t seed = getCurrentTime();
@@ -1,4 +1,5 @@
 #include "testbase.hpp"
+#include <thread>
 
 using namespace proptest;
 
@@ -360,3 +361,512 @@ TEST(PropTest, DISABLED_TestExpectDeath)
         // EXPECT_DEATH(, ".*") << "vector: " << vec.size() << ", n: " << n;
     });
 }
+
+TEST(PropTest, TestPropertyGrowingSize)
+{
+    // sizes grow over the runs: run i (0-based) of 100 draws sizes up to ceil(200 * (i+1) / 100)
+    int run = 0;
+    auto prop = property([&run](vector<int> a, string s) {
+        size_t maxSize = static_cast<size_t>(2 * (run + 1));
+        PROP_ASSERT(a.size() <= maxSize);
+        PROP_ASSERT(s.size() <= maxSize);
+        run++;
+    });
+    EXPECT_TRUE(prop.setNumRuns(100).forAll());
+
+    // full size range in every run if disabled
+    bool largeFound = false;
+    EXPECT_TRUE(property([&largeFound](vector<int> a) {
+                    if (a.size() > 10)
+                        largeFound = true;
+                })
+                    .setNumRuns(10)
+                    .setGrowingSize(false)
+                    .forAll());
+    EXPECT_TRUE(largeFound);
+}
+
+TEST(PropTest, TestRandomScaledSize)
+{
+    Random rand(getCurrentTime());
+    rand.setSizeFactor(0, 10);
+    for (int i = 0; i < 10; i++)
+        EXPECT_EQ(rand.getScaledSize(3, 200), 3U);
+    rand.setSizeFactor(1, 10);
+    for (int i = 0; i < 100; i++) {
+        size_t size = rand.getScaledSize(10, 20);
+        EXPECT_TRUE(size >= 10 && size <= 11);
+    }
+    // 200 * 0.14 is slightly above 28 in floating point, but exactly 28 as a fraction
+    rand.setSizeFactor(14, 100);
+    for (int i = 0; i < 1000; i++)
+        EXPECT_LE(rand.getScaledSize(0, 200), 28U);
+    // no overflow for large spans
+    rand.setSizeFactor(UINT32_MAX - 1, UINT32_MAX);
+    EXPECT_LE(rand.getScaledSize(0, SIZE_MAX), SIZE_MAX - SIZE_MAX / UINT32_MAX);
+    rand.setSizeFactor(1, 10);
+    // factor survives copy, so that failed runs can be regenerated
+    Random copy = rand;
+    EXPECT_EQ(copy.getSizeFactor(), 0.1);
+    EXPECT_THROW(rand.setSizeFactor(3, 2), std::invalid_argument);
+    EXPECT_THROW(rand.setSizeFactor(0, 0), std::invalid_argument);
+}
+
+TEST(PropTest, TestPropertyTypedPipeline)
+{
+    vector<pair<int, string>> seen;
+    auto prop = property(
+        [&seen](int a, string s) {
+            seen.push_back(util::make_pair(a, s));
+            return a >= 0 && a <= 10;
+        },
+        interval(0, 10));
+    // concrete callable and generator types are kept
+    static_assert(!is_same<decltype(prop), Property<int, string>>::value, "property should not be type-erased");
+    EXPECT_TRUE(prop.setSeed(42).setNumRuns(20).forAll());
+    auto typedSeen = seen;
+
+    // type-erased form generates identical inputs
+    seen.clear();
+    Property<int, string> erased = prop;
+    EXPECT_TRUE(erased.forAll());
+    EXPECT_EQ(typedSeen, seen);
+    // and stays a class of its own, also through chained setters
+    seen.clear();
+    Property<int, string> chained = erased.setNumRuns(20);
+    EXPECT_TRUE(chained.forAll());
+    EXPECT_EQ(typedSeen, seen);
+
+    // explicit generators override the leading ones
+    seen.clear();
+    EXPECT_TRUE(prop.forAll(interval(5, 5)));
+    for (auto& pair : seen)
+        EXPECT_EQ(pair.first, 5);
+
+    // void result and mutable callable
+    EXPECT_TRUE(property([](int) mutable {}).setNumRuns(10).forAll());
+    EXPECT_FALSE(property([](int) { PROP_ASSERT(false); }).setNumRuns(10).forAll());
+}
+
+TEST(PropTest, TestPropertyInstrumentation)
+{
+    uint64_t numCalls = 0;
+    auto prop = property([&numCalls](int, vector<int> v) {
+        numCalls++;
+        PROP_ASSERT(v.size() < 3);
+    });
+    EXPECT_FALSE(prop.setSeed(1).setNumRuns(100).forAll());
+    auto& report = prop.getInstrumentationReport();
+
+    if (!util::Instrumentation::isEnabled()) {
+        EXPECT_EQ(report.total().allocations, 0U);
+        EXPECT_EQ(report.total().invocations, 0U);
+        return;
+    }
+
+    auto& generation = report[InstrumentationReport::Generation];
+    auto& execution = report[InstrumentationReport::Execution];
+    auto& shrinking = report[InstrumentationReport::Shrinking];
+    EXPECT_GT(generation.allocations, 0U);
+    EXPECT_GE(generation.allocatedBytes, generation.allocations);
+    EXPECT_GT(generation.shrinkables, 0U);
+    EXPECT_EQ(generation.invocations, 0U);
+    EXPECT_GT(execution.invocations, 0U);
+    EXPECT_GT(shrinking.invocations, 0U);
+    EXPECT_EQ(execution.invocations + shrinking.invocations, numCalls);
+    EXPECT_GT(shrinking.streamTails, 0U);
+    EXPECT_GT(shrinking.shrinkables, 0U);
+}
+
+TEST(PropTest, TestInstrumentationPhasePerThread)
+{
+    if (!util::Instrumentation::isEnabled())
+        return;
+
+    // forces three tails of a transformed and concatenated stream
+    auto forceTails = []() {
+        auto stream = Stream<int>::two(1, 2).transform<int>([](const int& i) { return i + 1; }).concat(Stream<int>::one(3));
+        for (auto itr = stream.iterator(); itr.hasNext();)
+            itr.next();
+    };
+
+    auto before = util::Instrumentation::snapshot();
+    InstrumentationReport counted;
+    {
+        PropertyContext context;
+        util::InstrumentationPhaseScope scope(InstrumentationReport::Generation);
+        std::thread thread([&forceTails, &context]() {
+            // counted on this thread, and merged into the parent
+            PropertyContext child(context);
+            util::InstrumentationPhaseScope threadScope(InstrumentationReport::Shrinking);
+            forceTails();
+        });
+        thread.join();
+        forceTails();
+        counted = context.getInstrumentation();
+    }
+    // not counted when idle
+    forceTails();
+    // each tail is counted once, in the phase of the thread forcing it
+    EXPECT_EQ(counted[InstrumentationReport::Generation].streamTails, 3U);
+    EXPECT_EQ(counted[InstrumentationReport::Shrinking].streamTails, 3U);
+    EXPECT_EQ(counted[InstrumentationReport::Execution].streamTails, 0U);
+    // counters are per thread
+    auto own = util::Instrumentation::snapshot() - before;
+    EXPECT_EQ(own[InstrumentationReport::Generation].streamTails, 3U);
+    EXPECT_EQ(own[InstrumentationReport::Shrinking].streamTails, 0U);
+}
+
+TEST(PropTest, TestInstrumentationOfConcurrentProperties)
+{
+    if (!util::Instrumentation::isEnabled())
+        return;
+
+    // properties running at the same time count only their own invocations
+    auto run = [](int numRuns, uint64_t& invocations) {
+        auto prop = property([](int) {});
+        prop.setSeed(1).setNumRuns(numRuns).forAll();
+        invocations = prop.getInstrumentationReport()[InstrumentationReport::Execution].invocations;
+    };
+    uint64_t invocations1 = 0, invocations2 = 0;
+    std::thread thread1([&]() { run(100, invocations1); });
+    std::thread thread2([&]() { run(300, invocations2); });
+    thread1.join();
+    thread2.join();
+    EXPECT_EQ(invocations1, 100U);
+    EXPECT_EQ(invocations2, 300U);
+}
+
+namespace {
+
+struct RecordingReporter : public Reporter
+{
+    void onStart(const PropertyReport&) override { events.push_back("start"); }
+    void onFailure(const PropertyReport&) override { events.push_back("failure"); }
+    void onShrinkStep(const PropertyReport&, const ShrinkStep&) override { events.push_back("shrink"); }
+    void onEnd(const PropertyReport& report) override
+    {
+        events.push_back("end");
+        last = report;
+    }
+
+    vector<string> events;
+    PropertyReport last;
+};
+
+}  // namespace
+
+TEST(PropTest, TestPropertyReporter)
+{
+    auto recorder = util::make_shared<RecordingReporter>();
+    stringstream json;
+    auto reporter = util::make_shared<MultiReporter>(
+        vector<shared_ptr<Reporter>>{recorder, util::make_shared<JsonLinesReporter>(json)});
+
+    // passing property with discards and tags
+    auto passing = property([](int a) {
+        if (a % 2 == 0)
+            PROP_DISCARD();
+        PROP_TAG("sign", a < 0 ? "negative" : "positive");
+    });
+    EXPECT_TRUE(passing.setName("odd \"ints\"").setSeed(1).setNumRuns(100).setReporter(reporter).forAll());
+    EXPECT_EQ(recorder->events, (vector<string>{"start", "end"}));
+    auto& passed = recorder->last;
+    EXPECT_TRUE(passed.passed);
+    EXPECT_EQ(passed.runs, 100U);
+    EXPECT_GT(passed.discards, 0U);
+    EXPECT_EQ(passed.tags["sign"]["negative"] + passed.tags["sign"]["positive"], 100U);
+    EXPECT_TRUE(passed.counterexample.empty());
+
+    string line;
+    ASSERT_TRUE(static_cast<bool>(getline(json, line)));
+    EXPECT_EQ(line.find("{\"name\":\"odd \\\"ints\\\"\",\"seed\":1,\"num_runs\":100,\"runs\":100,"), 0U);
+    EXPECT_NE(line.find("\"passed\":true"), string::npos);
+    EXPECT_NE(line.find("\"tags\":{\"sign\":{\"negative\":"), string::npos);
+
+    // failing property with shrinking
+    recorder->events.clear();
+    auto failing = property([](int a) { PROP_ASSERT(a < 100); });
+    EXPECT_FALSE(failing.setSeed(1).setNumRuns(100).setReporter(reporter).forAll());
+    ASSERT_GE(recorder->events.size(), 4U);
+    EXPECT_EQ(recorder->events[0], "start");
+    EXPECT_EQ(recorder->events[1], "failure");
+    EXPECT_EQ(recorder->events.back(), "end");
+    auto& failed = recorder->last;
+    EXPECT_FALSE(failed.passed);
+    EXPECT_GE(failed.runs, 1U);
+    EXPECT_NE(failed.failure.find("a < 100"), string::npos);
+    EXPECT_FALSE(failed.failedArgs.empty());
+    EXPECT_EQ(failed.shrinkSteps.size(), recorder->events.size() - 3);
+    EXPECT_EQ(failed.counterexample, "{ 100 }");
+    EXPECT_EQ(failed.shrinkSteps.back().args, failed.counterexample);
+
+    ASSERT_TRUE(static_cast<bool>(getline(json, line)));
+    EXPECT_NE(line.find("\"passed\":false"), string::npos);
+    EXPECT_NE(line.find("\"counterexample\":\"{ 100 }\""), string::npos);
+    EXPECT_FALSE(static_cast<bool>(getline(json, line)));
+}
+
+TEST(PropTest, TestJsonLinesEscape)
+{
+    EXPECT_EQ(JsonLinesReporter::escape("a\"b\\c\n\x01"), "a\\\"b\\\\c\\n\\u0001");
+    // valid UTF-8 is copied
+    EXPECT_EQ(JsonLinesReporter::escape("caf\xc3\xa9 \xf0\x9f\x98\x80"), "caf\xc3\xa9 \xf0\x9f\x98\x80");
+    // invalid bytes, truncated sequences, overlong encodings and surrogates are escaped byte by byte
+    EXPECT_EQ(JsonLinesReporter::escape("\xff\x80"), "\\u00ff\\u0080");
+    EXPECT_EQ(JsonLinesReporter::escape("a\xc3"), "a\\u00c3");
+    EXPECT_EQ(JsonLinesReporter::escape("\xc0\xaf"), "\\u00c0\\u00af");
+    EXPECT_EQ(JsonLinesReporter::escape("\xed\xa0\x80"), "\\u00ed\\u00a0\\u0080");
+}
+
+TEST(PropTest, TestConsoleReporterVerbosity)
+{
+    stringstream out, err;
+    auto console = util::make_shared<ConsoleReporter>(out, err);
+    auto passing = property([](int) {});
+    auto failing = property([](int a) { PROP_ASSERT(a < 100); });
+
+    EXPECT_TRUE(passing.setSeed(1).setNumRuns(10).setReporter(console).forAll());
+    // followed by the instrumentation counters, if enabled
+    EXPECT_EQ(out.str().find("random seed: 1\nOK, passed 10 tests\n"), 0U);
+    EXPECT_TRUE(err.str().empty());
+
+    // passed tests are not printed if quiet
+    out.str("");
+    {
+        VerbosityGuard quiet(Verbosity::Quiet);
+        EXPECT_TRUE(passing.forAll());
+        EXPECT_TRUE(out.str().empty());
+
+        // failed tests are printed with the seed
+        EXPECT_FALSE(failing.setSeed(1).setNumRuns(100).setReporter(console).forAll());
+    }
+    EXPECT_EQ(out.str().find("random seed: 1\n  with args: "), 0U);
+    EXPECT_NE(out.str().find("  simplest args found by shrinking: { 100 }\n"), string::npos);
+    EXPECT_EQ(err.str().find("Falsifiable, after "), 0U);
+}
+
+TEST(PropTest, TestPropertyTagCounts)
+{
+    PropertyContext context;
+    for (int i = 0; i < 12; i++) {
+        PROP_TAG("parity", i % 2 == 0 ? "even" : "odd");
+        PROP_TAG("mod 3", i % 3);
+        PROP_TAG("unsigned mod 2", static_cast<unsigned int>(i % 2));
+        PROP_TAG(string("dynamic ") + to_string(i % 2), 'a' + (i % 2 == 0 ? 0 : 1));
+        PROP_TAG("char", static_cast<char>('a' + i % 2));
+        PROP_TAG("half", i / 2.0 < 3.0 ? 0.5 : 1.5);
+        PROP_STAT(i < 3);
+        PROP_CLASSIFY(i > 9, "large", string("yes"));
+        PROP_EXPECT_EQ(i, i) << "not formatted: " << i;
+    }
+    context.tag("legacy", "value");
+
+    auto counts = context.getTagCounts();
+    EXPECT_EQ(counts["parity"], (map<string, size_t>{{"even", 6}, {"odd", 6}}));
+    EXPECT_EQ(counts["mod 3"], (map<string, size_t>{{"0", 4}, {"1", 4}, {"2", 4}}));
+    EXPECT_EQ(counts["unsigned mod 2"], (map<string, size_t>{{"0", 6}, {"1", 6}}));
+    EXPECT_EQ(counts["dynamic 0"], (map<string, size_t>{{"97", 6}}));
+    EXPECT_EQ(counts["dynamic 1"], (map<string, size_t>{{"98", 6}}));
+    EXPECT_EQ(counts["char"], (map<string, size_t>{{"a", 6}, {"b", 6}}));
+    EXPECT_EQ(counts["half"], (map<string, size_t>{{"0.5", 6}, {"1.5", 6}}));
+    EXPECT_EQ(counts["i < 3"], (map<string, size_t>{{"false", 9}, {"true", 3}}));
+    EXPECT_EQ(counts["large"], (map<string, size_t>{{"yes", 2}}));
+    EXPECT_EQ(counts["legacy"], (map<string, size_t>{{"value", 1}}));
+    EXPECT_FALSE(context.hasFailures());
+    EXPECT_TRUE(PropertyBase::getLastStream().str().empty());
+
+    PROP_EXPECT_EQ(1, 2) << " formatted";
+    EXPECT_EQ(context.flushFailures().str(), string("(1 == 2) (") + __FILE__ + ":" + to_string(__LINE__ - 1) +
+                                                 ") with 1 != 2 formatted");
+}
+
+TEST(PropTest, TestChildContext)
+{
+    PropertyContext parent;
+    PROP_TAG("thread", "main");
+    std::thread child([&parent]() {
+        EXPECT_EQ(PropertyBase::getContext(), nullptr);
+        PropertyContext context(parent);
+        EXPECT_EQ(PropertyBase::getContext(), &context);
+        PROP_TAG("thread", "child");
+        PROP_EXPECT_EQ(1, 2);
+        // recorded in the child until it is destroyed
+        EXPECT_FALSE(parent.hasFailures());
+    });
+    child.join();
+    EXPECT_EQ(PropertyBase::getContext(), &parent);
+    EXPECT_EQ(parent.getTagCounts()["thread"], (map<string, size_t>{{"child", 1}, {"main", 1}}));
+    EXPECT_NE(parent.flushFailures().str().find("(1 == 2)"), string::npos);
+}
+
+TEST(PropTest, TestExpectInSpawnedThread)
+{
+    auto recorder = util::make_shared<RecordingReporter>();
+    // a thread spawned by the property function has no context of its own
+    auto prop = property(
+        [](int a) {
+            std::thread thread([a]() {
+                PROP_TAG("spawned", true);
+                PROP_EXPECT(a < 100) << " in spawned thread";
+            });
+            thread.join();
+        },
+        interval(0, 1000));
+    EXPECT_FALSE(prop.setSeed(1).setNumRuns(100).setReporter(recorder).forAll());
+
+    auto& report = recorder->last;
+    EXPECT_NE(report.failure.find("a < 100"), string::npos);
+    EXPECT_NE(report.failure.find("in spawned thread"), string::npos);
+    EXPECT_EQ(report.tags["spawned"]["true"], report.runs);
+    // failures are reproduced while shrinking
+    EXPECT_EQ(report.counterexample, "{ 100 }");
+}
+
+TEST(PropTest, TestFallbackContextOfSeveralRoots)
+{
+    PropertyContext root;
+    std::thread other([]() {
+        PropertyContext otherRoot;
+        // a thread without a context cannot be attributed to one of the two roots
+        std::thread spawned([]() { EXPECT_EQ(PropertyContext::getFallbackContext(), nullptr); });
+        spawned.join();
+        EXPECT_FALSE(otherRoot.hasFailures());
+    });
+    other.join();
+
+    std::thread spawned([]() { PROP_EXPECT_EQ(1, 2); });
+    spawned.join();
+    EXPECT_NE(root.flushFailures().str().find("(1 == 2)"), string::npos);
+}
+
+TEST(PropTest, TestParallelForAll)
+{
+    constexpr int numThreads = 4;
+    vector<shared_ptr<RecordingReporter>> recorders;
+    vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++)
+        recorders.push_back(util::make_shared<RecordingReporter>());
+
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([t, &recorders]() {
+            // odd threads fail by an expectation, after tagging their own thread number
+            auto prop = property([t](int a) {
+                PROP_TAG("thread", t);
+                PROP_EXPECT(t % 2 == 0 || a < 100);
+            });
+            prop.setSeed(t + 1).setNumRuns(200).setReporter(recorders[t]).forAll();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int t = 0; t < numThreads; t++) {
+        auto& report = recorders[t]->last;
+        EXPECT_EQ(report.seed, static_cast<uint64_t>(t + 1));
+        EXPECT_EQ(report.tags.size(), 1U);
+        EXPECT_EQ(report.tags["thread"].size(), 1U);
+        EXPECT_EQ(report.tags["thread"][to_string(t)], report.runs);
+        if (t % 2 == 0) {
+            EXPECT_TRUE(report.passed);
+            EXPECT_TRUE(report.failure.empty());
+        } else {
+            EXPECT_FALSE(report.passed);
+            EXPECT_NE(report.failure.find("a < 100"), string::npos);
+            EXPECT_EQ(report.counterexample, "{ 100 }");
+        }
+    }
+}
+
+TEST(PropTest, TestParallelShrink)
+{
+    auto prop = property([](vector<int> vec) {
+        PROP_ASSERT(vec.size() < 5 || vec[1] < 100);
+    }, Arbi<vector<int>>(interval(0, 1000)).setSize(10, 20));
+
+    auto sequential = util::make_shared<RecordingReporter>();
+    prop.setSeed(1).setReporter(sequential).forAll();
+    auto parallel = util::make_shared<RecordingReporter>();
+    prop.setSeed(1).setReporter(parallel).setShrinkThreads(4).forAll();
+
+    EXPECT_FALSE(parallel->last.passed);
+    // the first failing candidate of each batch is taken, as sequential shrinking would
+    EXPECT_EQ(parallel->last.counterexample, sequential->last.counterexample);
+    EXPECT_EQ(parallel->last.shrinkSteps.size(), sequential->last.shrinkSteps.size());
+    // invocations on the shrink threads are counted, including candidates tested needlessly
+    EXPECT_GE(parallel->last.instrumentation[InstrumentationReport::Shrinking].invocations,
+              sequential->last.instrumentation[InstrumentationReport::Shrinking].invocations);
+}
+
+TEST(PropTest, TestParallelShrinkRethrows)
+{
+    // exceptions of other types than std::exception leave shrinking on the calling thread, as in sequential shrinking
+    auto prop = property([](vector<int> vec) {
+        if (vec[0] == 0)
+            throw 1;
+        PROP_ASSERT(vec.size() < 5);
+    }, Arbi<vector<int>>(interval(0, 1000)).setSize(10, 20));
+
+    EXPECT_THROW(prop.setSeed(1).setReporter(util::make_shared<RecordingReporter>()).forAll(), int);
+    EXPECT_THROW(prop.setSeed(1).setReporter(util::make_shared<RecordingReporter>()).setShrinkThreads(4).forAll(), int);
+}
+
+TEST(PropTest, TestShowLimits)
+{
+    auto toString = [](const ShowLimits& limits, const vector<vector<int>>& value) {
+        util::ScopedShowLimits scope(limits);
+        stringstream os;
+        show(os, value);
+        return os.str();
+    };
+
+    vector<vector<int>> vec{{1, 2, 3, 4}, {5}, {6, 7}};
+    EXPECT_EQ(toString(ShowLimits(), vec), "[ [ 1, 2, 3, 4 ], [ 5 ], [ 6, 7 ] ]");
+    string elided = toString(ShowLimits(2, 8, 100), vec);
+    EXPECT_EQ(elided.find("[ [ 1, 2, ... <2 more, #"), 0U) << elided;
+    EXPECT_NE(elided.find("], [ 5 ], ... <1 more, #"), string::npos) << elided;
+    string shallow = toString(ShowLimits(100, 1, 100), vec);
+    EXPECT_EQ(shallow.find("[ [ <4 elements, #"), 0U) << shallow;
+
+    // elided parts are told apart by their hashes
+    vector<vector<int>> other{{1, 2, 3, 5}, {5}, {6, 7}};
+    EXPECT_NE(toString(ShowLimits(2, 8, 100), vec), toString(ShowLimits(2, 8, 100), other));
+    EXPECT_EQ(toString(ShowLimits(2, 8, 100), vec), toString(ShowLimits(2, 8, 100), vec));
+
+    // strings are cut at character boundaries
+    util::ScopedShowLimits scope(ShowLimits(100, 100, 4));
+    stringstream os;
+    show(os, UTF8String("ab\xea\xb0\x80" "cd"));
+    EXPECT_EQ(os.str().find("\"ab...\" (61 62 ...) <5 more bytes, #"), 0U) << os.str();
+    // limits are restored at the end of a scope
+    {
+        util::ScopedShowLimits inner{ShowLimits()};
+        EXPECT_TRUE(util::showState().limits.isUnlimited());
+    }
+    EXPECT_EQ(util::showState().limits.maxBytes, 4U);
+}
+
+TEST(PropTest, TestPropertyShowLimits)
+{
+    auto prop = property([](vector<int> vec) { PROP_ASSERT(vec.size() < 70); },
+                         Arbi<vector<int>>(interval(0, 1000)).setSize(0, 100));
+
+    // steps are reported as changes of size, and the failed arguments within the limits
+    auto summarized = util::make_shared<RecordingReporter>();
+    EXPECT_FALSE(prop.setSeed(1).setReporter(summarized).forAll());
+    auto& report = summarized->last;
+    ASSERT_FALSE(report.shrinkSteps.empty());
+    auto& first = report.shrinkSteps.front();
+    EXPECT_EQ(first.args, "size " + to_string(first.sizeBefore) + " -> " + to_string(first.sizeAfter));
+    EXPECT_GE(first.sizeBefore, 70);
+    EXPECT_EQ(report.shrinkSteps.back().sizeAfter, 70);
+    EXPECT_NE(report.failedArgs.find("more, #"), string::npos);
+    EXPECT_NE(report.counterexample.find(" ... <6 more, #"), string::npos) << report.counterexample;
+
+    // in full on request
+    auto full = util::make_shared<RecordingReporter>();
+    EXPECT_FALSE(prop.setSeed(1).setReporter(full).setShowLimits(ShowLimits()).forAll());
+    EXPECT_EQ(full->last.shrinkSteps.size(), report.shrinkSteps.size());
+    EXPECT_EQ(full->last.shrinkSteps.back().args, full->last.counterexample);
+    EXPECT_EQ(full->last.failedArgs.find("more"), string::npos);
+}
@@ -107,5 +107,8 @@ TEST(StateTest, StateFunctionWithModel)
         cout << "cleanup" << endl;
         // PROP_ASSERT(false);
     });
-    prop.setSeed(0).setNumRuns(10).go();
+    prop.setSeed(0).setNumRuns(10);
+    EXPECT_TRUE(prop.go());
+    // generators and model factory are kept for subsequent runs
+    EXPECT_TRUE(prop.go());
 }
@@ -3,6 +3,10 @@
 #include "googletest/googlemock/include/gmock/gmock.h"
 #include "Random.hpp"
 #include "../util/std.hpp"
+#include "../util/utfscan.hpp"
+#include "../util/unicode.hpp"
+#include "../util/workerpool.hpp"
+#include "../util/scheduler.hpp"
 
 class UtilTestCase : public ::testing::Test {
 };
@@ -508,3 +512,224 @@ TEST(UtilTestCase, asserts)
     PROP_EXPECT_LT(a, b);
     PROP_EXPECT_GT(a, b) << " should print";
 }
+
+namespace {
+
+uint32_t randomCodePoint(Random& rand)
+{
+    switch (rand.getRandomSize(0, 4)) {
+        case 0:
+            return rand.getRandomUInt32(0, 0x7f);
+        case 1:
+            return rand.getRandomUInt32(0x80, 0x7ff);
+        case 2: {
+            uint32_t code = rand.getRandomUInt32(0x800, 0xffff - 0x800);
+            // skip surrogates
+            return code < 0xd800 ? code : code + 0x800;
+        }
+        default:
+            return rand.getRandomUInt32(0x10000, 0x10ffff);
+    }
+}
+
+void checkUTFScan(const vector<uint8_t>& chars, int (*count)(const uint8_t*, size_t, SimdLevel), int expected)
+{
+    for (int level = 0; level <= static_cast<int>(getSimdLevel()); level++) {
+        EXPECT_EQ(count(chars.data(), chars.size(), static_cast<SimdLevel>(level)), expected)
+            << "level " << level << ", size " << chars.size();
+    }
+}
+
+void testUTFScan(void (*encode)(uint32_t, vector<uint8_t>&), int (*count)(const uint8_t*, size_t, SimdLevel))
+{
+    Random rand(getCurrentTime());
+    for (int i = 0; i < 300; i++) {
+        // lengths around block boundaries
+        size_t numChars = rand.getRandomSize(0, 80);
+        vector<uint8_t> chars;
+        for (size_t j = 0; j < numChars; j++)
+            encode(randomCodePoint(rand), chars);
+        checkUTFScan(chars, count, static_cast<int>(numChars));
+
+        // corruptions must be judged the same by all kernels
+        if (chars.empty())
+            continue;
+        vector<uint8_t> corrupted = chars;
+        corrupted[rand.getRandomSize(0, corrupted.size())] = rand.getRandomUInt8();
+        checkUTFScan(corrupted, count, count(corrupted.data(), corrupted.size(), SimdLevel::Scalar));
+        vector<uint8_t> truncated(chars.begin(), chars.begin() + rand.getRandomSize(0, chars.size()));
+        checkUTFScan(truncated, count, count(truncated.data(), truncated.size(), SimdLevel::Scalar));
+        vector<uint8_t> shifted(chars.begin() + 1, chars.end());
+        checkUTFScan(shifted, count, count(shifted.data(), shifted.size(), SimdLevel::Scalar));
+    }
+}
+
+}  // namespace
+
+TEST(UtilTestCase, UTFScanUTF8)
+{
+    testUTFScan(encodeUTF8, countUTF8);
+    checkUTFScan({0xed, 0xa0, 0x80}, countUTF8, -1);  // surrogate
+    checkUTFScan({0xf4, 0x90, 0x80, 0x80}, countUTF8, -1);  // too large
+    checkUTFScan({0xc0, 0x80}, countUTF8, -1);  // overlong
+    vector<uint8_t> cut(31, 'a');
+    cut.push_back(0xe3);
+    checkUTFScan(cut, countUTF8, -1);
+    cut.push_back(0x81);
+    cut.push_back(0x82);
+    checkUTFScan(cut, countUTF8, 32);
+}
+
+TEST(UtilTestCase, UTFScanCESU8)
+{
+    testUTFScan(encodeCESU8, countCESU8);
+    checkUTFScan({0xf0, 0x90, 0x80, 0x80}, countCESU8, -1);  // 4-byte sequence
+    checkUTFScan({0xed, 0xb0, 0x80}, countCESU8, -1);  // lone low surrogate
+    // high surrogate at the end of a block
+    vector<uint8_t> pair(13, 'a');
+    pair.insert(pair.end(), {0xed, 0xa0, 0x80});
+    checkUTFScan(pair, countCESU8, -1);
+    pair.insert(pair.end(), {0xed, 0xb0, 0x80});
+    checkUTFScan(pair, countCESU8, 14);
+}
+
+TEST(UtilTestCase, UTFScanUTF16)
+{
+    testUTFScan(encodeUTF16BE, countUTF16BE);
+    testUTFScan(encodeUTF16LE, countUTF16LE);
+    checkUTFScan({0x00, 0x41, 0x00}, countUTF16BE, -1);  // odd size
+    // high surrogate at the end of a block
+    vector<uint8_t> pair(30, 0);
+    pair.insert(pair.end(), {0xd8, 0x00});
+    checkUTFScan(pair, countUTF16BE, -1);
+    pair.insert(pair.end(), {0xdc, 0x00});
+    checkUTFScan(pair, countUTF16BE, 16);
+}
+
+TEST(UtilTestCase, UTFEncodeInPlace)
+{
+    Random rand(getCurrentTime());
+    for (int i = 0; i < 1000; i++) {
+        uint32_t code = randomCodePoint(rand);
+        vector<uint8_t> chars;
+        uint8_t buffer[6];
+
+        encodeUTF8(code, chars);
+        ASSERT_EQ(UTF8EncodedSize(code), chars.size());
+        encodeUTF8(code, buffer);
+        EXPECT_EQ(vector<uint8_t>(buffer, buffer + chars.size()), chars);
+
+        chars.clear();
+        encodeCESU8(code, chars);
+        ASSERT_EQ(CESU8EncodedSize(code), chars.size());
+        encodeCESU8(code, buffer);
+        EXPECT_EQ(vector<uint8_t>(buffer, buffer + chars.size()), chars);
+
+        chars.clear();
+        encodeUTF16LE(code, chars);
+        ASSERT_EQ(UTF16EncodedSize(code), chars.size());
+        encodeUTF16LE(code, buffer);
+        EXPECT_EQ(vector<uint8_t>(buffer, buffer + chars.size()), chars);
+    }
+    EXPECT_THROW(UTF8EncodedSize(0xD800), runtime_error);
+    EXPECT_THROW(CESU8EncodedSize(0xDFFF), runtime_error);
+    EXPECT_THROW(UTF16EncodedSize(0x110000), runtime_error);
+}
+
+TEST(UtilTestCase, EscapeWriter)
+{
+    // same escapes as the stream manipulating functions
+    for (int c = 0; c < 256; c++) {
+        stringstream expected, actual;
+        validChar(expected, static_cast<uint8_t>(c));
+        validChar2(expected, static_cast<uint8_t>(c));
+        charAsHex(expected, static_cast<uint8_t>(c));
+        {
+            EscapeWriter writer(actual);
+            writer.printable(static_cast<uint8_t>(c));
+            writer.printable2(static_cast<uint8_t>(c));
+            writer.hex(static_cast<uint8_t>(c));
+        }
+        EXPECT_EQ(actual.str(), expected.str());
+    }
+    for (uint32_t code : {0x80U, 0x7ffU, 0xffffU, 0x10000U, 0x1f600U, 0x10ffffU}) {
+        stringstream expected, actual;
+        codepage(expected, code);
+        EscapeWriter(actual).codepage(code);
+        EXPECT_EQ(actual.str(), expected.str());
+    }
+
+    stringstream os;
+    decodeUTF8(os, string("a\\\n\xc3\xa9\xf0\x9f\x98\x80\xff"));
+    EXPECT_EQ(os.str(), "a\\\\\\x0a\\u00e9\\U01f600\\xff");
+
+    // output longer than the buffer
+    string str, expected;
+    for (int i = 0; i < 1000; i++) {
+        str += "\xea\xb0\x80\t";
+        expected += "\\uac00\\x09";
+    }
+    os.str("");
+    decodeUTF8(os, str);
+    EXPECT_EQ(os.str(), expected);
+    os.str("");
+    charAsHex(os, string("\x01\xab\xff"));
+    EXPECT_EQ(os.str(), "01 ab ff");
+}
+
+TEST(UtilTestCase, WorkerPool)
+{
+    WorkerPool pool(8);
+    EXPECT_EQ(pool.size(), 8);
+    vector<std::thread::id> ids(8);
+    for (int run = 0; run < 3; run++) {
+        vector<std::thread::id> runIds(8);
+        pool.run([&runIds](int i) { runIds[i] = std::this_thread::get_id(); });
+        // every worker ran the task, on the same thread in every run
+        for (int i = 0; i < 8; i++) {
+            EXPECT_NE(runIds[i], std::this_thread::get_id());
+            if (run > 0) {
+                EXPECT_EQ(runIds[i], ids[i]);
+            }
+        }
+        ids = runIds;
+    }
+}
+
+TEST(UtilTestCase, Scheduler)
+{
+    WorkerPool pool(4);
+    // order in which 4 threads take 10 steps each, yielding between steps
+    auto order = [&pool](uint64_t seed, Scheduler::Policy policy, int depth) {
+        Scheduler scheduler(4, seed, policy, depth, 40);
+        vector<int> steps;
+        pool.run([&](int i) {
+            Scheduler::Participant participant(scheduler, i);
+            for (int step = 0; step < 10; step++) {
+                steps.push_back(i);
+                proptest::yield();
+            }
+        });
+        EXPECT_EQ(steps.size(), 40U);
+        return steps;
+    };
+
+    for (auto policy : {Scheduler::Policy::Random, Scheduler::Policy::PCT}) {
+        // a schedule is replayed with its seed, and different seeds explore different schedules
+        set<vector<int>> schedules;
+        for (uint64_t seed = 0; seed < 10; seed++) {
+            vector<int> steps = order(seed, policy, 3);
+            EXPECT_EQ(order(seed, policy, 3), steps);
+            schedules.insert(steps);
+        }
+        EXPECT_GT(schedules.size(), 5U);
+    }
+
+    // without priority changes, PCT runs each thread to the end in turn
+    vector<int> steps = order(1, Scheduler::Policy::PCT, 1);
+    for (int i = 0; i < 40; i++)
+        EXPECT_EQ(steps[i], steps[i / 10 * 10]);
+
+    // outside of a scheduler, yield() only yields the processor
+    proptest::yield();
+}
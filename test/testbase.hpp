@@ -35,6 +35,22 @@ using std::bind;
 class PropTestCase : public ::testing::Test {
 };
 
+// sets the global verbosity for the lifetime of this object, restoring the previous one even if a test fails early
+struct VerbosityGuard
+{
+    explicit VerbosityGuard(proptest::Verbosity verbosity) : previous(proptest::PropertyBase::getVerbosity())
+    {
+        proptest::PropertyBase::setVerbosity(verbosity);
+    }
+    ~VerbosityGuard() { proptest::PropertyBase::setVerbosity(previous); }
+
+    VerbosityGuard(const VerbosityGuard&) = delete;
+    VerbosityGuard& operator=(const VerbosityGuard&) = delete;
+
+private:
+    proptest::Verbosity previous;
+};
+
 template <typename T>
 struct NumericTest : public testing::Test
 {
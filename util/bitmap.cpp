@@ -1,122 +1,134 @@
-
 #include "std.hpp"
 #include "bitmap.hpp"
 #include <atomic>
+#include <thread>
 
 namespace proptest {
 namespace util {
 
-Bitmap::Bitmap()
+namespace {
+
+int countTrailingZeros(uint64_t x)
 {
-    for (int i = 0; i < size; i++) {
-        states[i].store(Available);
-    }
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    for (; (x & 1) == 0; x >>= 1)
+        n++;
+    return n;
+#endif
 }
 
-Bitmap::Bitmap(const Bitmap& other)
+// word the calling thread starts searching from. threads start on different cache lines of 8 words
+unsigned int& startHint()
 {
-    for (int i = 0; i < size; i++) {
-        states[i].store(other.states[i].load());
-    }
+    static std::atomic<unsigned int> numThreads(0);
+    thread_local unsigned int hint = numThreads.fetch_add(1) * 8;
+    return hint;
 }
 
-int Bitmap::acquire() {
-    int n = -1;
-    do {
-        n = occupyAvailable(0);
-    } while(n == -1);
+// yields the processor a few times, then sleeps twice as long as before each time, up to a millisecond
+class Backoff {
+public:
+    void wait()
+    {
+        if (attempts < 8)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(std::min(1 << (attempts - 8), 1000)));
+        if (attempts < 18)
+            attempts++;
+    }
 
-    take(n);
-    return n;
-}
+private:
+    int attempts = 0;
+};
 
-int Bitmap::tryAcquire() {
-    int n = occupyAvailable(0);
-    if(n != -1)
-        take(n);
-    return n;
-}
+}  // namespace
 
-void Bitmap::unacquire(int n) {
-    setChangingFromAcquired(n);
-    put(n);
-}
+constexpr int Bitmap::maxCapacity;
+constexpr int Bitmap::size;
+constexpr int Bitmap::wordBits;
+constexpr int Bitmap::maxWords;
 
-void Bitmap::setChanging(int n)
+Bitmap::Bitmap(int capacity) : cap(capacity), numWords((capacity + wordBits - 1) / wordBits)
 {
-    State AvailableState = Available;
-    State UnavailableState = Unavailable;
-    // cas
-    states[n].compare_exchange_strong(AvailableState, Changing) ||
-        states[n].compare_exchange_strong(UnavailableState, Changing);
+    if (capacity <= 0 || capacity > maxCapacity)
+        throw invalid_argument("bitmap capacity must be in 1.." + to_string(maxCapacity));
+    reset();
 }
 
-void Bitmap::setChangingFromAcquired(int n)
+Bitmap::Bitmap(const Bitmap& other) : cap(other.cap), numWords(other.numWords)
 {
-    State UnavailableState = Unavailable;
-    // cas
-    states[n].compare_exchange_strong(UnavailableState, Changing);
+    for (int w = 0; w < numWords; w++)
+        words[w].store(other.words[w].load(std::memory_order_relaxed), std::memory_order_relaxed);
 }
 
-void Bitmap::setChangingFromUnacquired(int n)
+int Bitmap::acquire(std::chrono::nanoseconds timeout)
 {
-    State AvailableState = Available;
-    // cas
-    states[n].compare_exchange_strong(AvailableState, Changing);
+    bool hasDeadline = timeout != std::chrono::nanoseconds::max();
+    auto deadline = hasDeadline ? std::chrono::steady_clock::now() + timeout : std::chrono::steady_clock::time_point::max();
+    Backoff backoff;
+    while (true) {
+        int n = tryAcquire();
+        if (n != -1)
+            return n;
+        if (hasDeadline && std::chrono::steady_clock::now() >= deadline)
+            return -1;
+        backoff.wait();
+    }
 }
 
-void Bitmap::take(int n)
+int Bitmap::tryAcquire()
 {
-    // assert
-    if (states[n] != Changing)
-        throw runtime_error("invalid state");
-    states[n] = Unavailable;
+    unsigned int& hint = startHint();
+    int start = static_cast<int>(hint % static_cast<unsigned int>(numWords));
+    for (int i = 0; i < numWords; i++) {
+        int w = start + i < numWords ? start + i : start + i - numWords;
+        uint64_t mask = wordMask(w);
+        uint64_t word = words[w].load(std::memory_order_relaxed);
+        uint64_t available;
+        while ((available = ~word & mask) != 0) {
+            // lowest available slot of the word. a failed exchange reloads the word
+            uint64_t lowest = available & (~available + 1);
+            if (words[w].compare_exchange_weak(word, word | lowest, std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+                hint = static_cast<unsigned int>(w);
+                return w * wordBits + countTrailingZeros(available);
+            }
+        }
+    }
+    return -1;
 }
 
-void Bitmap::put(int n)
+void Bitmap::unacquire(int n)
 {
-    if (states[n] != Changing)
+    if (n < 0 || n >= cap)
+        throw invalid_argument("bitmap slot out of range: " + to_string(n));
+    uint64_t bit = uint64_t(1) << (n % wordBits);
+    uint64_t old = words[n / wordBits].fetch_and(~bit, std::memory_order_release);
+    if ((old & bit) == 0)
         throw runtime_error("invalid state");
-    states[n] = Available;
 }
 
-void Bitmap::reset()
+bool Bitmap::isAcquired(int n) const
 {
-    for (int i = 0; i < size; i++) {
-        states[i] = Available;
-    }
+    if (n < 0 || n >= cap)
+        throw invalid_argument("bitmap slot out of range: " + to_string(n));
+    return (words[n / wordBits].load(std::memory_order_acquire) >> (n % wordBits)) & 1;
 }
 
-int Bitmap::occupyAvailable(int n)
+void Bitmap::reset()
 {
-    for (int i = n; i < size; i++) {
-        State AvailableState = Available;
-        if (states[i].compare_exchange_strong(AvailableState, Changing))
-            return i;
-    }
-
-    for (int i = 0; i < n; i++) {
-        State AvailableState = Available;
-        if (states[i].compare_exchange_strong(AvailableState, Changing))
-            return i;
-    }
-    return -1;
+    for (int w = 0; w < numWords; w++)
+        words[w].store(0, std::memory_order_release);
 }
 
-int Bitmap::occupyUnavailable(int n)
+uint64_t Bitmap::wordMask(int w) const
 {
-    for (int i = n; i < size; i++) {
-        State UnavailableState = Unavailable;
-        if (states[i].compare_exchange_strong(UnavailableState, Changing))
-            return i;
-    }
-
-    for (int i = 0; i < n; i++) {
-        State UnavailableState = Unavailable;
-        if (states[i].compare_exchange_strong(UnavailableState, Changing))
-            return i;
-    }
-    return -1;
+    int bits = std::min(cap - w * wordBits, wordBits);
+    return bits == wordBits ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
 }
 
 }  // namespace util
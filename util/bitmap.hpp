@@ -6,38 +6,48 @@
 namespace proptest {
 namespace util {
 
-struct PROPTEST_API Bitmap
-{
-    static constexpr int size = 10000;
-
-    typedef enum
-    {
-        Available = 0,
-        Changing = 1,
-        Unavailable = 2
-    } State;
-
-    Bitmap();
-    Bitmap(const Bitmap&);
-
-// private:
-    void setChanging(int n);
-    void setChangingFromAcquired(int n);
-    void setChangingFromUnacquired(int n);
-    void take(int n);
-    void put(int n);
-    void reset();
-
-    int occupyAvailable(int n);
-    int occupyUnavailable(int n);
+/**
+ * @brief Set of slots that threads acquire and release concurrently, without locking
+ * @details Slots are packed as bits into atomic 64-bit words held within the object. A thread starts searching at the
+ * word it last acquired a slot from, so that threads tend to work on different words, and takes the lowest available
+ * slot of a word with a single compare-and-swap. While all slots are taken, `acquire` waits with exponential backoff,
+ * bounded to a millisecond between attempts.
+ * @note breaking change: the public `states` array, the `State` enum and the two-step helpers (`setChanging*`,
+ * `occupyAvailable`, `occupyUnavailable`, `take`, `put`) of earlier versions are removed. use `tryAcquire`,
+ * `unacquire` and `isAcquired` instead
+ */
+class PROPTEST_API Bitmap {
 public:
-    int acquire();
+    /// hard limit of the capacity, as the slots are held within the object (the fixed size of earlier versions)
+    static constexpr int maxCapacity = 10000;
+    [[deprecated("use maxCapacity, or capacity() of a bitmap")]] static constexpr int size = maxCapacity;
+
+    /// throws `invalid_argument` if capacity is not in 1..maxCapacity
+    explicit Bitmap(int capacity = maxCapacity);
+    Bitmap(const Bitmap& other);
+
+    int capacity() const { return cap; }
+
+    /// acquires an available slot, waiting while all are taken. returns -1 if none became available within timeout
+    int acquire(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+    /// acquires an available slot, or returns -1 if all are taken
     int tryAcquire();
+    /// releases an acquired slot. throws if it is not acquired
     void unacquire(int n);
+    bool isAcquired(int n) const;
+    /// releases all slots
+    void reset();
+
+private:
+    static constexpr int wordBits = 64;
+    static constexpr int maxWords = (maxCapacity + wordBits - 1) / wordBits;
 
-// private:
-    std::atomic<State> states[size];
+    // slots of the word within the capacity
+    uint64_t wordMask(int w) const;
 
+    int cap;
+    int numWords;
+    std::atomic<uint64_t> words[maxWords];
 };
 
 }  // namespace util
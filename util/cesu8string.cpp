@@ -1,6 +1,7 @@
 #include "../api.hpp"
 #include "cesu8string.hpp"
 #include "unicode.hpp"
+#include "utfscan.hpp"
 #include "../util/std.hpp"
 
 namespace proptest {
@@ -16,76 +17,6 @@ size_t CESU8String::charsize() const
 
 namespace util {
 
-ostream& validCESU8Char(ostream& os, uint8_t c)
-{
-    if (static_cast<char>(c) == '\\')
-        os << "\\\\";
-    else if (c < 0x20 || c == 0x7f) {
-        util::IosFlagSaver iosFlagSaver(os);
-        os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c);
-    } else
-        os << static_cast<char>(c);
-
-    return os;
-}
-
-ostream& validCESU8Char(ostream& os, uint8_t c1, uint8_t c2)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\u" << setfill('0') << setw(2) << hex << static_cast<int>(c1) << static_cast<int>(c2);
-    return os;
-}
-
-ostream& validCESU8Char(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\U" << setfill('0') << setw(2) << hex << static_cast<int>(0) << static_cast<int>(c1)
-       << static_cast<int>(c2) << static_cast<int>(c3);
-    return os;
-}
-
-ostream& validCESU8Char(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3, uint8_t c4)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\U" << setfill('0') << setw(2) << hex << static_cast<int>(c1) << static_cast<int>(c2)
-       << static_cast<int>(c3) << static_cast<int>(c4);
-    return os;
-}
-
-ostream& cesu8AsHex(ostream& os, uint8_t c)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c);
-    return os;
-}
-
-ostream& cesu8AsHex(ostream& os, uint8_t c1, uint8_t c2)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c1);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c2);
-    return os;
-}
-
-ostream& cesu8AsHex(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c1);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c2);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c3);
-    return os;
-}
-
-ostream& cesu8AsHex(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3, uint8_t c4)
-{
-    util::IosFlagSaver iosFlagSaver(os);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c1);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c2);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c3);
-    os << "\\x" << setfill('0') << setw(2) << hex << static_cast<int>(c4);
-    return os;
-}
-
 ostream& CESU8ToHex(ostream& os, vector<uint8_t>& chars)
 {
     util::IosFlagSaver iosFlagSaver(os);
@@ -101,22 +32,16 @@ ostream& CESU8ToHex(ostream& os, vector<uint8_t>& chars)
 
 ostream& decodeCESU8(ostream& os, const string& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeCESU8(os, chars);
+    EscapeWriter writer(os);
+    decodeCESU8(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 ostream& decodeCESU8(ostream& os, const CESU8String& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeCESU8(os, chars);
+    EscapeWriter writer(os);
+    decodeCESU8(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 /*
@@ -133,58 +58,58 @@ ostream& decodeCESU8(ostream& os, const CESU8String& str)
  * U+E000..U+FFFF     EE..EF   80..BF   80..BF
  * U+10000..: 6-byte surrogate pairs (U+D800..U+DBFF + U+DC00..U+DFFF)
  */
-ostream& decodeCESU8(ostream& os, vector<uint8_t>& chars)
+void decodeCESU8(EscapeWriter& writer, const uint8_t* chars, size_t size)
 {
-    for (size_t i = 0; i < chars.size(); i++) {
+    for (size_t i = 0; i < size; i++) {
         // U+0000..U+007F
         if (chars[i] <= 0x7f) {
-            validCESU8Char(os, chars[i]);
+            writer.printable(chars[i]);
             // os << static_cast<char>(chars[i]);
-        } else if (i + 2 > chars.size()) {
-            cesu8AsHex(os, chars[i]);
+        } else if (i + 2 > size) {
+            writer.hex(chars[i]);
             // U+0080..U+07FF
         } else if (0xc2 <= chars[i] && chars[i] <= 0xdf) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf) {
                 // validChar(os, chars[i] - 0xc2, chars[i+1]);
-                codepage(os, 0x80 + (chars[i] - 0xc2) * (0xbf - 0x80 + 1) + (chars[i + 1] - 0x80));
+                writer.codepage(0x80 + (chars[i] - 0xc2) * (0xbf - 0x80 + 1) + (chars[i + 1] - 0x80));
                 // charAsHex(os, chars[i], chars[i+1]);
                 i++;
             } else {
-                cesu8AsHex(os, chars[i]);
+                writer.hex(chars[i]);
             }
-        } else if (i + 3 > chars.size()) {
-            cesu8AsHex(os, chars[i]);
+        } else if (i + 3 > size) {
+            writer.hex(chars[i]);
             // U+0800..U+0FFF
         } else if (0xe0 == chars[i]) {
             if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
                 // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0x0800 + (chars[i] - 0xe0) * (0xbf - 0xa0 + 1) * (0xbf - 0x80 + 1) +
+                writer.codepage(0x0800 + (chars[i] - 0xe0) * (0xbf - 0xa0 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0xa0) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
                 // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                cesu8AsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+1000..U+CFFF
         } else if (0xe1 <= chars[i] && chars[i] <= 0xec) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
                 // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0x1000 + (chars[i] - 0xe1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                writer.codepage(0x1000 + (chars[i] - 0xe1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
                 // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                cesu8AsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+D000..U+D7FF
         } else if (0xed == chars[i]) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x9f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
                 // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0xD000 + (chars[i] - 0xed) * (0x9f - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                writer.codepage(0xD000 + (chars[i] - 0xed) * (0x9f - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
                 // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else {
-                if (i + 6 > chars.size()) {
-                    cesu8AsHex(os, chars[i]);
+                if (i + 6 > size) {
+                    writer.hex(chars[i]);
                 } else if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xaf && 0x80 <= chars[i + 2] &&
                            chars[i + 2] <= 0xbf && 0xed == chars[i + 3] && 0xb0 <= chars[i + 4] &&
                            chars[i + 4] <= 0xbf && 0x80 <= chars[i + 5] && chars[i + 5] <= 0xbf) {
@@ -194,25 +119,31 @@ ostream& decodeCESU8(ostream& os, vector<uint8_t>& chars)
                     uint16_t low = 0xDC00 + (chars[i + 3] - 0xed) * (0xbf - 0xb0 + 1) * (0xbf - 0x80 + 1) +
                                    (chars[i + 4] - 0xb0) * (0xbf - 0x80 + 1) + (chars[i + 5] - 0x80);
                     uint32_t code = 0x10000 + ((high & 0x03FF) << 10) + (low & 0x03FF);
-                    codepage(os, code);
+                    writer.codepage(code);
                     i += 5;
                 } else
-                    cesu8AsHex(os, chars[i]);
+                    writer.hex(chars[i]);
             }
             // U+E000..U+FFFF
         } else if (0xee <= chars[i] && chars[i] <= 0xef) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
                 // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0xe000 + (chars[i] - 0xee) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                writer.codepage(0xe000 + (chars[i] - 0xee) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
                 // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                cesu8AsHex(os, chars[i]);
+                writer.hex(chars[i]);
         } else {
-            cesu8AsHex(os, chars[i]);
+            writer.hex(chars[i]);
         }
     }
+}
+
+ostream& decodeCESU8(ostream& os, vector<uint8_t>& chars)
+{
+    EscapeWriter writer(os);
+    decodeCESU8(writer, chars.data(), chars.size());
     return os;
 }
 
@@ -284,40 +215,50 @@ uint32_t decodeCESU8(vector<uint8_t>& chars)
     throw runtime_error("invalid CESU8 sequence");
 }
 
-void encodeCESU8(uint32_t code, vector<uint8_t>& chars)
+size_t CESU8EncodedSize(uint32_t code)
+{
+    if (0xD800 <= code && code <= 0xDFFF)
+        throw runtime_error("should not reach here. surrogate region");
+    else if (code > 0x10FFFF)
+        throw runtime_error("should not reach here. code too big");
+    // supplementary characters are encoded as a pair of 3-byte surrogates
+    return code <= 0x7F ? 1 : code <= 0x7FF ? 2 : code <= 0xFFFF ? 3 : 6;
+}
+
+void encodeCESU8(uint32_t code, uint8_t* out)
 {
     if (code <= 0x7f) {
-        chars.push_back(static_cast<uint8_t>(code));
+        *out++ = static_cast<uint8_t>(code);
     } else if (code <= 0x07FF) {
         code -= 0x80;
         uint8_t c0 = (code >> 6) + 0xc2;
         uint8_t c1 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
+        *out++ = c0;
+        *out++ = c1;
     } else if (code <= 0x0FFF) {
         code -= 0x800;
         uint8_t c0 = 0xe0;
         uint8_t c1 = (code >> 6) + 0xa0;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0xCFFF) {
         code -= 0x1000;
         uint8_t c0 = (code >> 12) + 0xe1;
         uint8_t c1 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0xD7FF) {
         code -= 0xD000;
         uint8_t c0 = 0xed;
         uint8_t c1 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0xDFFF) {
         throw runtime_error("should not reach here. surrogate region");
     } else if (code <= 0xFFFF) {
@@ -325,9 +266,9 @@ void encodeCESU8(uint32_t code, vector<uint8_t>& chars)
         uint8_t c0 = (code >> 12) + 0xee;
         uint8_t c1 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0x10FFFF) {
         code -= 0x10000;
         uint16_t surrogates[2] = {static_cast<uint16_t>(0xD800 + (code >> 10)),
@@ -338,26 +279,25 @@ void encodeCESU8(uint32_t code, vector<uint8_t>& chars)
             uint8_t c0 = 0xed;
             uint8_t c1 = ((code >> 6) & 0x3f) + (j == 0 ? 0xa0 : 0xb0);
             uint8_t c2 = (code & 0x3f) + 0x80;
-            chars.push_back(c0);
-            chars.push_back(c1);
-            chars.push_back(c2);
+            *out++ = c0;
+            *out++ = c1;
+            *out++ = c2;
         }
     } else {
         throw runtime_error("should not reach here. code too big");
     }
 }
 
+void encodeCESU8(uint32_t code, vector<uint8_t>& chars)
+{
+    size_t pos = chars.size();
+    chars.resize(pos + CESU8EncodedSize(code));
+    encodeCESU8(code, chars.data() + pos);
+}
+
 int CESU8CharSize(const string& str)
 {
-    vector<uint8_t> chars(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars[i] = str[i];
-    }
-    int numChars = 0;
-    if (isValidCESU8(chars, numChars)) {
-        return numChars;
-    } else
-        return -1;
+    return countCESU8(reinterpret_cast<const uint8_t*>(str.data()), str.size());
 }
 
 bool isValidCESU8(vector<uint8_t>& chars)
@@ -368,52 +308,9 @@ bool isValidCESU8(vector<uint8_t>& chars)
 
 bool isValidCESU8(vector<uint8_t>& chars, int& numChars)
 {
-    numChars = 0;
-    for (size_t i = 0; i < chars.size(); i++, numChars++) {
-        if (chars[i] <= 0x7f) {
-            continue;
-        } else if (i + 2 > chars.size()) {
-            return false;
-        } else if (0xc2 <= chars[i] && chars[i] <= 0xdf) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf) {
-                i++;
-            } else
-                return false;
-        } else if (i + 3 > chars.size()) {
-            return false;
-        } else if (0xe0 == chars[i]) {
-            if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else if (0xe1 <= chars[i] && chars[i] <= 0xec) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else if (0xed == chars[i]) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x9f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else {
-                if (i + 6 > chars.size()) {
-                    return false;
-                } else if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xaf && 0x80 <= chars[i + 2] &&
-                           chars[i + 2] <= 0xbf && 0xed == chars[i + 3] && 0xb0 <= chars[i + 4] &&
-                           chars[i + 4] <= 0xbf && 0x80 <= chars[i + 5] && chars[i + 5] <= 0xbf) {
-                    i += 5;
-                } else
-                    return false;
-            }
-            // U+E000..U+FFFF
-        } else if (0xee <= chars[i] && chars[i] <= 0xef) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else
-            return false;
-    }
-    return true;
+    int count = countCESU8(chars.data(), chars.size());
+    numChars = count < 0 ? 0 : count;
+    return count >= 0;
 }
 
 }  // namespace util
@@ -15,13 +15,22 @@ public:
 };
 
 namespace util {
+
+class EscapeWriter;
+
 PROPTEST_API ostream& CESU8ToHex(ostream& os, vector<uint8_t>& chars);
 PROPTEST_API ostream& decodeCESU8(ostream& os, vector<uint8_t>& chars);
 PROPTEST_API ostream& decodeCESU8(ostream& os, const string& str);
 PROPTEST_API ostream& decodeCESU8(ostream& os, const CESU8String& str);
+/// same as above, decoding from memory into the buffer of given writer
+PROPTEST_API void decodeCESU8(EscapeWriter& writer, const uint8_t* data, size_t size);
 
 PROPTEST_API uint32_t decodeCESU8(vector<uint8_t>& chars);
 PROPTEST_API void encodeCESU8(uint32_t utf32, vector<uint8_t>& chars);
+/// number of bytes encoding the code point. throws if it cannot be encoded
+PROPTEST_API size_t CESU8EncodedSize(uint32_t utf32);
+/// writes CESU8EncodedSize(utf32) bytes at out
+PROPTEST_API void encodeCESU8(uint32_t utf32, uint8_t* out);
 
 
 struct PROPTEST_API DecodeCESU8
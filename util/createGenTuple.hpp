@@ -62,6 +62,27 @@ createGenTuple(TypeList<ARGS...>, EXPGENS&&... gens)
     return tuple_cat(explicits, implicits);
 }
 
+template <typename Tuple, size_t... index>
+decltype(auto) createArbiTupleListed(index_sequence<index...>)
+{
+    return util::make_tuple(Arbi<tuple_element_t<index, Tuple>>()...);
+}
+
+// returns a Tuple<EXPGENS..., Arbi<remaining ARGS>...>, keeping the concrete generator types
+template <typename... ARGS, typename... EXPGENS>
+decltype(auto) createTypedGenTuple(TypeList<ARGS...>, EXPGENS&&... gens)
+{
+    static_assert(sizeof...(EXPGENS) <= sizeof...(ARGS), "more generators than property arguments");
+    constexpr auto ExplicitSize = sizeof...(EXPGENS);
+    constexpr auto ImplicitSize = sizeof...(ARGS) - ExplicitSize;
+    tuple<decay_t<EXPGENS>...> explicits(util::forward<EXPGENS>(gens)...);
+    using ArgsAsTuple = tuple<decay_t<ARGS>...>;
+    auto implicits =
+        createArbiTupleListed<ArgsAsTuple>(addOffset<ExplicitSize>(make_index_sequence<ImplicitSize>{}));
+
+    return tuple_cat(util::move(explicits), util::move(implicits));
+}
+
 }  // namespace util
 
 }  // namespace proptest
@@ -0,0 +1,131 @@
+#include "instrumentation.hpp"
+
+namespace proptest {
+
+InstrumentationCounters::InstrumentationCounters()
+    : allocations(0), allocatedBytes(0), shrinkables(0), streamTails(0), invocations(0)
+{
+}
+
+InstrumentationCounters& InstrumentationCounters::operator+=(const InstrumentationCounters& other)
+{
+    allocations += other.allocations;
+    allocatedBytes += other.allocatedBytes;
+    shrinkables += other.shrinkables;
+    streamTails += other.streamTails;
+    invocations += other.invocations;
+    return *this;
+}
+
+InstrumentationCounters& InstrumentationCounters::operator-=(const InstrumentationCounters& other)
+{
+    allocations -= other.allocations;
+    allocatedBytes -= other.allocatedBytes;
+    shrinkables -= other.shrinkables;
+    streamTails -= other.streamTails;
+    invocations -= other.invocations;
+    return *this;
+}
+
+InstrumentationCounters InstrumentationReport::total() const
+{
+    InstrumentationCounters sum;
+    for (int i = 0; i < NumPhases; i++)
+        sum += phases[i];
+    return sum;
+}
+
+InstrumentationReport& InstrumentationReport::operator+=(const InstrumentationReport& other)
+{
+    for (int i = 0; i < NumPhases; i++)
+        phases[i] += other.phases[i];
+    return *this;
+}
+
+InstrumentationReport InstrumentationReport::operator-(const InstrumentationReport& other) const
+{
+    InstrumentationReport diff = *this;
+    for (int i = 0; i < NumPhases; i++)
+        diff.phases[i] -= other.phases[i];
+    return diff;
+}
+
+ostream& operator<<(ostream& os, const InstrumentationReport& report)
+{
+    static const char* phaseNames[InstrumentationReport::NumPhases] = {"generation", "execution", "shrinking"};
+    for (int i = 0; i < InstrumentationReport::NumPhases; i++) {
+        auto& counters = report.phases[i];
+        os << "    " << phaseNames[i] << ": " << counters.allocations << " allocations (" << counters.allocatedBytes
+           << " bytes), " << counters.shrinkables << " shrinkables, " << counters.streamTails << " stream tails, "
+           << counters.invocations << " invocations" << endl;
+    }
+    return os;
+}
+
+namespace util {
+
+namespace {
+
+enum Counter { Allocations = 0, AllocatedBytes, Shrinkables, StreamTails, Invocations, NumCounters };
+
+// per thread, so that threads running in parallel (e.g. parallel properties or shrink threads) keep their own phase
+// and counts, without contention. counts of other threads reach a property through the contexts of those threads
+thread_local int currentPhase = Instrumentation::Idle;
+thread_local uint64_t counters[InstrumentationReport::NumPhases][NumCounters];
+
+void count(Counter counter, uint64_t amount)
+{
+    int phase = currentPhase;
+    if (phase != Instrumentation::Idle)
+        counters[phase][counter] += amount;
+}
+
+}  // namespace
+
+constexpr int Instrumentation::Idle;
+
+InstrumentationReport Instrumentation::snapshot()
+{
+    InstrumentationReport report;
+    for (int i = 0; i < InstrumentationReport::NumPhases; i++) {
+        auto& phase = report.phases[i];
+        phase.allocations = counters[i][Allocations];
+        phase.allocatedBytes = counters[i][AllocatedBytes];
+        phase.shrinkables = counters[i][Shrinkables];
+        phase.streamTails = counters[i][StreamTails];
+        phase.invocations = counters[i][Invocations];
+    }
+    return report;
+}
+
+int Instrumentation::setPhase(int phase)
+{
+    int previous = currentPhase;
+    currentPhase = phase;
+    return previous;
+}
+
+void Instrumentation::countAllocation(size_t bytes)
+{
+    count(Allocations, 1);
+    count(AllocatedBytes, bytes);
+}
+
+void Instrumentation::countShrinkable()
+{
+    count(Shrinkables, 1);
+}
+
+void Instrumentation::countStreamTail()
+{
+    count(StreamTails, 1);
+}
+
+void Instrumentation::countInvocation()
+{
+    count(Invocations, 1);
+}
+
+}  // namespace util
+
+}  // namespace proptest
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../api.hpp"
+#include "std.hpp"
+
+/**
+ * @file instrumentation.hpp
+ * @brief Optional counters of heap allocations, shrinkable nodes, stream tails and property invocations
+ * @details Counting is compiled in only if `PROPTEST_ENABLE_INSTRUMENTATION` is defined for both the library and the
+ * code using it (CMake option `PROPTEST_INSTRUMENTATION`). Otherwise the hooks compile to nothing and all counters
+ * stay zero. Counters and the phase events are attributed to are kept per thread. A `PropertyContext` adds up the
+ * counters of its own thread and those of the contexts merged into it, so that properties running at the same time
+ * are counted apart. Allocations are counted only if the program links util/instrumentation_new.cpp, which replaces
+ * the global `operator new`, or calls `Instrumentation::countAllocation` from its own allocator.
+ */
+
+namespace proptest {
+
+struct PROPTEST_API InstrumentationCounters
+{
+    InstrumentationCounters();
+
+    InstrumentationCounters& operator+=(const InstrumentationCounters& other);
+    InstrumentationCounters& operator-=(const InstrumentationCounters& other);
+
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+    uint64_t shrinkables;  // Shrinkable nodes created (copies are not counted)
+    uint64_t streamTails;  // Stream tails forced
+    uint64_t invocations;  // property function invocations
+};
+
+/**
+ * @brief Instrumentation counters of a property test, per phase
+ */
+struct PROPTEST_API InstrumentationReport
+{
+    enum Phase {
+        Generation = 0,  // generating arguments
+        Execution = 1,   // running the property function, including startup/cleanup
+        Shrinking = 2,   // regenerating and shrinking a failed input
+        NumPhases = 3
+    };
+
+    const InstrumentationCounters& operator[](Phase phase) const { return phases[phase]; }
+    InstrumentationCounters total() const;
+    InstrumentationReport& operator+=(const InstrumentationReport& other);
+    InstrumentationReport operator-(const InstrumentationReport& other) const;
+
+    InstrumentationCounters phases[NumPhases];
+};
+
+PROPTEST_API ostream& operator<<(ostream& os, const InstrumentationReport& report);
+
+namespace util {
+
+struct PROPTEST_API Instrumentation
+{
+    static constexpr int Idle = -1;
+
+    static constexpr bool isEnabled()
+    {
+#ifdef PROPTEST_ENABLE_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// current values of the counters of the calling thread
+    static InstrumentationReport snapshot();
+
+    /// counts an allocation in the phase of the calling thread, e.g. from a replaced `operator new`
+    static void countAllocation(size_t bytes);
+    static void countShrinkable();
+    static void countStreamTail();
+    static void countInvocation();
+
+private:
+    // sets the phase of the calling thread (`Idle` for none), and returns the previous one
+    static int setPhase(int phase);
+
+    friend struct InstrumentationPhaseScope;
+};
+
+/// sets the phase of the calling thread for the lifetime of this object, restoring the previous one afterwards
+struct PROPTEST_API InstrumentationPhaseScope
+{
+    explicit InstrumentationPhaseScope(int phase) : previous(Instrumentation::setPhase(phase)) {}
+    ~InstrumentationPhaseScope() { Instrumentation::setPhase(previous); }
+
+    InstrumentationPhaseScope(const InstrumentationPhaseScope&) = delete;
+    InstrumentationPhaseScope& operator=(const InstrumentationPhaseScope&) = delete;
+
+private:
+    int previous;
+};
+
+}  // namespace util
+
+}  // namespace proptest
+
+#ifdef PROPTEST_ENABLE_INSTRUMENTATION
+#define PROPTEST_INSTRUMENT(ACTION) ::proptest::util::Instrumentation::ACTION
+#define PROPTEST_INSTRUMENT_PHASE(PHASE)                                    \
+    ::proptest::util::InstrumentationPhaseScope proptest_instrumentation_phase( \
+        ::proptest::InstrumentationReport::PHASE)
+#else
+#define PROPTEST_INSTRUMENT(ACTION) ((void)0)
+#define PROPTEST_INSTRUMENT_PHASE(PHASE) ((void)0)
+#endif
@@ -0,0 +1,55 @@
+#include "instrumentation.hpp"
+#include <cstdlib>
+#include <new>
+
+/**
+ * @file instrumentation_new.cpp
+ * @brief Replacement of the global `operator new` that counts allocations for instrumentation
+ * @details Not part of the library, so that linking the library never replaces the allocator of a program. Link this
+ * object file into a test executable (CMake target `proptest_instrumentation_new` with option
+ * `PROPTEST_INSTRUMENTATION`) to count the allocations made during property tests. A program with its own allocator
+ * can call `proptest::util::Instrumentation::countAllocation()` from it instead.
+ */
+
+namespace {
+
+void* countedAlloc(std::size_t size)
+{
+    proptest::util::Instrumentation::countAllocation(size);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
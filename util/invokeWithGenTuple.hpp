@@ -3,15 +3,26 @@
 #include "invokeWithArgs.hpp"
 #include "tuple.hpp"
 #include "../generator/util.hpp"
+#include "createGenTuple.hpp"
+#include "instrumentation.hpp"
 
 namespace proptest {
 namespace util {
 
+template <typename GenTuple, size_t... index>
+decltype(auto) generateWithGenHelper(Random& rand, GenTuple&& genTup, index_sequence<index...>)
+{
+    PROPTEST_INSTRUMENT_PHASE(Generation);
+    return util::make_tuple(get<index>(genTup)(rand)...);
+}
+
 template <typename Function, typename GenTuple, size_t... index>
 decltype(auto) invokeWithGenHelper(Random& rand, Function&& f, GenTuple&& genTup, index_sequence<index...>)
 {
-    auto valueTup = util::make_tuple(get<index>(genTup)(rand)...);
+    auto valueTup = generateWithGenHelper(rand, util::forward<GenTuple>(genTup), index_sequence<index...>{});
+    PROPTEST_INSTRUMENT_PHASE(Execution);
     auto values = transformHeteroTuple<ShrinkableGet>(util::forward<decltype(valueTup)>(valueTup));
+    PROPTEST_INSTRUMENT(countInvocation());
     try {
         return invokeWithArgTuple(util::forward<Function>(f), util::forward<decltype(values)>(values));
     } catch (const AssertFailed& e) {
@@ -58,5 +69,23 @@ tuple<Ts...> overrideTuple(const tuple<Ts...>& tup)
     return tup;
 }
 
+template <typename Tuple, size_t... index>
+decltype(auto) subTuple(const Tuple& tup, index_sequence<index...>)
+{
+    return tuple<tuple_element_t<index, Tuple>...>(get<index>(tup)...);
+}
+
+// returns a Tuple<ARGS..., remaining Ts...>, replacing leading elements of tup while keeping the concrete types
+template <typename... Ts, typename... ARGS>
+decltype(auto) overrideTupleHead(const tuple<Ts...>& tup, ARGS&&... args)
+{
+    static_assert(sizeof...(ARGS) <= sizeof...(Ts), "more elements than in the tuple");
+    constexpr auto Size = sizeof...(ARGS);
+    constexpr auto RemainingSize = sizeof...(Ts) - Size;
+    tuple<decay_t<ARGS>...> argTup(util::forward<ARGS>(args)...);
+
+    return tuple_cat(util::move(argTup), subTuple(tup, addOffset<Size>(make_index_sequence<RemainingSize>{})));
+}
+
 }  // namespace util
 }  // namespace proptest
@@ -7,13 +7,134 @@
 
 namespace proptest {
 
-PROPTEST_API ostream& show(ostream& os, const char* c_str, size_t len)
+namespace util {
+
+ShowState& showState()
+{
+    static thread_local ShowState state;
+    return state;
+}
+
+ScopedShowLimits::ScopedShowLimits(const ShowLimits& limits) : saved(showState())
+{
+    showState().limits = limits;
+    showState().depth = 0;
+}
+
+ScopedShowLimits::~ScopedShowLimits()
 {
-    string str(c_str, len);
-    os << "\"" << util::StringPrintable(str) << "\" (" << util::StringAsHex(str) << ")";
+    showState() = saved;
+}
+
+HashStream::HashStream() : ostream(&buf) {}
+
+HashStream::HashBuf::int_type HashStream::HashBuf::overflow(int_type c)
+{
+    if (c != traits_type::eof()) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+    }
+    return traits_type::not_eof(c);
+}
+
+streamsize HashStream::HashBuf::xsputn(const char* s, streamsize n)
+{
+    for (streamsize i = 0; i < n; i++)
+        hash = (hash ^ static_cast<uint8_t>(s[i])) * 16777619U;
+    return n;
+}
+
+ostream& showHash(ostream& os, uint32_t hash)
+{
+    auto flags = os.flags();
+    os << "#" << hex << setfill('0') << setw(8) << hash;
+    os.flags(flags);
+    os << setfill(' ');
     return os;
 }
 
+}  // namespace util
+
+namespace {
+
+// bytes of a prefix of at most maxBytes that does not cut a character
+size_t UTF8PrefixSize(const string& str, size_t maxBytes)
+{
+    size_t size = maxBytes;
+    // back up to a leading byte
+    while (size > 0 && (static_cast<uint8_t>(str[size]) & 0xc0) == 0x80)
+        size--;
+    return size;
+}
+
+size_t CESU8PrefixSize(const string& str, size_t maxBytes)
+{
+    size_t size = UTF8PrefixSize(str, maxBytes);
+    // keep a surrogate pair (ED A0..AF xx ED B0..BF xx) together
+    if (size >= 3 && static_cast<uint8_t>(str[size]) == 0xed && (static_cast<uint8_t>(str[size + 1]) & 0xf0) == 0xb0)
+        size -= 3;
+    return size;
+}
+
+size_t UTF16PrefixSize(const string& str, size_t maxBytes, size_t hi)
+{
+    size_t size = maxBytes & ~static_cast<size_t>(1);
+    // keep a surrogate pair together
+    if (size >= 2 && (static_cast<uint8_t>(str[size - 2 + hi]) & 0xfc) == 0xd8)
+        size -= 2;
+    return size;
+}
+
+// prints the string decoded and as hex, only up to the byte limit of the calling thread
+ostream& showString(ostream& os, const string& str, void (*decode)(util::EscapeWriter&, const uint8_t*, size_t),
+                    size_t (*prefixSize)(const string&, size_t))
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(str.data());
+    size_t maxBytes = util::showState().limits.maxBytes;
+    size_t size = str.size() <= maxBytes ? str.size() : prefixSize(str, maxBytes);
+    {
+        util::EscapeWriter writer(os);
+        writer.write("\"");
+        decode(writer, data, size);
+        if (size == str.size()) {
+            writer.write("\" (");
+            writer.hexList(data, size);
+            writer.write(")");
+            return os;
+        }
+        writer.write("...\" (");
+        writer.hexList(data, size);
+        writer.write(" ...)");
+    }
+
+    os << " <" << (str.size() - size) << " more bytes, ";
+    util::HashStream hashStream;
+    hashStream.write(str.data() + size, str.size() - size);
+    util::showHash(os, hashStream.hash()) << ">";
+    return os;
+}
+
+size_t bytePrefixSize(const string&, size_t maxBytes)
+{
+    return maxBytes;
+}
+
+size_t UTF16BEPrefixSize(const string& str, size_t maxBytes)
+{
+    return UTF16PrefixSize(str, maxBytes, 0);
+}
+
+size_t UTF16LEPrefixSize(const string& str, size_t maxBytes)
+{
+    return UTF16PrefixSize(str, maxBytes, 1);
+}
+
+}  // namespace
+
+PROPTEST_API ostream& show(ostream& os, const char* c_str, size_t len)
+{
+    return showString(os, string(c_str, len), util::escapeBytes, bytePrefixSize);
+}
+
 PROPTEST_API ostream& show(ostream& os, const char* c_str)
 {
     string str(c_str);
@@ -23,32 +144,27 @@ PROPTEST_API ostream& show(ostream& os, const char* c_str)
 
 PROPTEST_API ostream& show(ostream& os, const string& str)
 {
-    os << "\"" << util::DecodeUTF8(str) << "\" (" << util::StringAsHex(str) << ")";
-    return os;
+    return showString(os, str, util::decodeUTF8, UTF8PrefixSize);
 }
 
 PROPTEST_API ostream& show(ostream& os, const UTF8String& str)
 {
-    os << "\"" << util::DecodeUTF8(str) << "\" (" << util::StringAsHex(str) << ")";
-    return os;
+    return showString(os, str, util::decodeUTF8, UTF8PrefixSize);
 }
 
 PROPTEST_API ostream& show(ostream& os, const UTF16BEString& str)
 {
-    os << "\"" << util::DecodeUTF16BE(str) << "\" (" << util::StringAsHex(str) << ")";
-    return os;
+    return showString(os, str, util::decodeUTF16BE, UTF16BEPrefixSize);
 }
 
 PROPTEST_API ostream& show(ostream& os, const UTF16LEString& str)
 {
-    os << "\"" << util::DecodeUTF16LE(str) << "\" (" << util::StringAsHex(str) << ")";
-    return os;
+    return showString(os, str, util::decodeUTF16LE, UTF16LEPrefixSize);
 }
 
 PROPTEST_API ostream& show(ostream& os, const CESU8String& str)
 {
-    os << "\"" << util::DecodeCESU8(str) << "\" (" << util::StringAsHex(str) << ")";
-    return os;
+    return showString(os, str, util::decodeCESU8, CESU8PrefixSize);
 }
 
 PROPTEST_API ostream& show(ostream& os, const bool& val)
@@ -9,6 +9,76 @@
 
 namespace proptest {
 
+/**
+ * @brief Bounds of what `show` prints of a value, to keep huge values from flooding the output
+ * @details Elements of a container beyond `maxElements`, elements of containers nested deeper than `maxDepth`, and bytes of a
+ * string beyond `maxBytes` are summarized by their count and a hash, so that elided parts of different values can still
+ * be told apart. Default-constructed limits print everything.
+ */
+struct PROPTEST_API ShowLimits
+{
+    ShowLimits() : maxElements(SIZE_MAX), maxDepth(SIZE_MAX), maxBytes(SIZE_MAX) {}
+    ShowLimits(size_t _maxElements, size_t _maxDepth, size_t _maxBytes)
+        : maxElements(_maxElements), maxDepth(_maxDepth), maxBytes(_maxBytes)
+    {
+    }
+
+    /// limits used for reporting property test results by default
+    static ShowLimits summary() { return ShowLimits(64, 8, 1024); }
+
+    bool isUnlimited() const { return maxElements == SIZE_MAX && maxDepth == SIZE_MAX && maxBytes == SIZE_MAX; }
+
+    size_t maxElements;  // elements printed per container
+    size_t maxDepth;     // levels of nested containers with their elements printed
+    size_t maxBytes;     // bytes printed per string
+};
+
+namespace util {
+
+// limits in effect on the calling thread, and the nesting of containers being printed
+struct ShowState
+{
+    ShowLimits limits;
+    size_t depth = 0;
+};
+
+PROPTEST_API ShowState& showState();
+
+/**
+ * @brief Applies given limits to `show` on the calling thread, until the end of the scope
+ */
+class PROPTEST_API ScopedShowLimits {
+public:
+    explicit ScopedShowLimits(const ShowLimits& limits);
+    ~ScopedShowLimits();
+
+private:
+    ShowState saved;
+};
+
+/**
+ * @brief Output stream that keeps only a 32-bit FNV-1a hash of what is written
+ */
+class PROPTEST_API HashStream : public ostream {
+public:
+    HashStream();
+    uint32_t hash() const { return buf.hash; }
+
+private:
+    struct HashBuf : public streambuf
+    {
+        int_type overflow(int_type c) override;
+        streamsize xsputn(const char* s, streamsize n) override;
+        uint32_t hash = 2166136261U;
+    };
+    HashBuf buf;
+};
+
+/// writes a hash as `#` followed by 8 hex digits
+PROPTEST_API ostream& showHash(ostream& os, uint32_t hash);
+
+}  // namespace util
+
 ostream& show(ostream& os, const char*);
 ostream& show(ostream& os, const char*, size_t len);
 ostream& show(ostream& os, const string&);
@@ -160,6 +230,43 @@ struct ToStreamEach<0, Tuple>
     void get(ostream&, const Tuple&) {}
 };
 
+/**
+ * @brief Prints elements separated by commas, within the limits of the calling thread
+ * @details Elements past the limits are printed in full only to a `HashStream`, for the summary
+ */
+template <typename Iterator, typename ShowElem>
+void showElements(ostream& os, Iterator begin, Iterator end, size_t size, ShowElem showElem)
+{
+    ShowState& state = showState();
+    auto hashOf = [&showElem](Iterator from, Iterator to) {
+        HashStream hashStream;
+        ScopedShowLimits unlimited{ShowLimits()};
+        for (auto itr = from; itr != to; ++itr)
+            showElem(hashStream, *itr);
+        return hashStream.hash();
+    };
+
+    if (size > 0 && state.depth >= state.limits.maxDepth) {
+        os << "<" << size << " elements, ";
+        showHash(os, hashOf(begin, end)) << ">";
+        return;
+    }
+
+    state.depth++;
+    size_t i = 0;
+    auto itr = begin;
+    for (; itr != end && i < state.limits.maxElements; ++itr, ++i) {
+        if (i > 0)
+            os << ", ";
+        showElem(os, *itr);
+    }
+    state.depth--;
+    if (itr != end) {
+        os << (i > 0 ? ", " : "") << "... <" << (size - i) << " more, ";
+        showHash(os, hashOf(itr, end)) << ">";
+    }
+}
+
 }  // namespace util
 
 template <typename ARG1, typename ARG2>
@@ -185,13 +292,8 @@ template <typename T, typename Allocator>
 ostream& show(ostream& os, const vector<T, Allocator>& seq)
 {
     os << "[ ";
-    auto begin = seq.begin();
-    if (begin != seq.end()) {
-        os << Show<T>(*begin);
-        for (auto itr = ++begin; itr != seq.end(); itr++) {
-            os << ", " << Show<T>(*itr);
-        }
-    }
+    util::showElements(os, seq.begin(), seq.end(), seq.size(),
+                       [](ostream& out, const T& elem) { out << Show<T>(elem); });
     os << " ]";
     return os;
 }
@@ -200,13 +302,8 @@ template <typename T, typename Allocator>
 ostream& show(ostream& os, const list<T, Allocator>& seq)
 {
     os << "[ ";
-    auto begin = seq.begin();
-    if (begin != seq.end()) {
-        os << Show<T>(*begin);
-        for (auto itr = ++begin; itr != seq.end(); itr++) {
-            os << ", " << Show<T>(*itr);
-        }
-    }
+    util::showElements(os, seq.begin(), seq.end(), seq.size(),
+                       [](ostream& out, const T& elem) { out << Show<T>(elem); });
     os << " ]";
     return os;
 }
@@ -215,17 +312,8 @@ template <typename T, typename Compare, typename Allocator>
 ostream& show(ostream& os, const set<T, Compare, Allocator>& input)
 {
     os << "{ ";
-    if (input.size() == 1) {
-        os << *input.begin();
-    } else if (input.size() > 0) {
-        os << *input.begin();
-        auto second = input.begin();
-        second++;
-        for (auto itr = second; itr != input.end(); ++itr) {
-            os << ", " << *itr;
-        }
-    }
-
+    util::showElements(os, input.begin(), input.end(), input.size(),
+                       [](ostream& out, const T& elem) { out << elem; });
     os << " }";
     return os;
 }
@@ -234,17 +322,8 @@ template <typename Key, typename T, typename Compare, typename Allocator>
 ostream& show(ostream& os, const map<Key, T, Compare, Allocator>& input)
 {
     os << "{ ";
-    if (input.size() == 1) {
-        os << Show<pair<Key, T>>(*input.begin());
-    } else if (input.size() > 0) {
-        os << Show<pair<Key, T>>(*input.begin());
-        auto second = input.begin();
-        second++;
-        for (auto itr = second; itr != input.end(); ++itr) {
-            os << ", " << Show<pair<Key, T>>(*itr);
-        }
-    }
-
+    util::showElements(os, input.begin(), input.end(), input.size(),
+                       [](ostream& out, const pair<const Key, T>& elem) { out << Show<pair<Key, T>>(elem); });
     os << " }";
     return os;
 }
@@ -0,0 +1,134 @@
+#include "scheduler.hpp"
+#include <algorithm>
+#include <thread>
+
+namespace proptest {
+
+namespace {
+
+struct Binding
+{
+    util::Scheduler* scheduler = nullptr;
+    int thread = -1;
+};
+
+// scheduler the calling thread participates in
+Binding& binding()
+{
+    static thread_local Binding current;
+    return current;
+}
+
+}  // namespace
+
+PROPTEST_API void yield()
+{
+    Binding& current = binding();
+    if (current.scheduler)
+        current.scheduler->yield(current.thread);
+    else
+        std::this_thread::yield();
+}
+
+namespace util {
+
+Scheduler::Scheduler(int _numThreads, uint64_t seed, Policy _policy, int depth, int numSteps)
+    : numThreads(_numThreads),
+      policy(_policy),
+      rand(seed),
+      numJoined(0),
+      numLeft(0),
+      running(-1),
+      finished(_numThreads, false),
+      nextChange(0),
+      numYields(0)
+{
+    if (numThreads <= 0)
+        throw invalid_argument("number of scheduled threads must be positive");
+    if (depth <= 0 || numSteps <= 0)
+        throw invalid_argument("depth and number of steps of a schedule must be positive");
+
+    // initial priorities depth .. depth + numThreads - 1, shuffled
+    for (int i = 0; i < numThreads; i++)
+        priorities.push_back(depth + i);
+    for (int i = numThreads - 1; i > 0; i--)
+        std::swap(priorities[i], priorities[rand.getRandomSize(0, i + 1)]);
+    for (int i = 0; i < depth - 1; i++)
+        changePoints.push_back(static_cast<int>(rand.getRandomSize(1, numSteps + 1)));
+    std::sort(changePoints.begin(), changePoints.end());
+}
+
+Scheduler::Participant::Participant(Scheduler& _scheduler, int _thread) : scheduler(_scheduler), thread(_thread)
+{
+    scheduler.join(thread);
+    binding().scheduler = &scheduler;
+    binding().thread = thread;
+}
+
+Scheduler::Participant::~Participant()
+{
+    binding() = Binding();
+    scheduler.leave(thread);
+}
+
+void Scheduler::join(int thread)
+{
+    if (thread < 0 || thread >= numThreads)
+        throw invalid_argument("scheduled thread out of range: " + to_string(thread));
+    std::unique_lock<std::mutex> lock(mutex);
+    // the first turn is given once all threads are waiting, so that it does not depend on the OS scheduler
+    if (++numJoined == numThreads) {
+        pick();
+        turnCond.notify_all();
+    }
+    turnCond.wait(lock, [this, thread]() { return running == thread; });
+}
+
+void Scheduler::yield(int thread)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    numYields++;
+    // PCT priority change points that are reached lower the running thread below all others
+    while (nextChange < changePoints.size() && changePoints[nextChange] <= numYields) {
+        priorities[thread] = static_cast<int>(changePoints.size() - nextChange);
+        nextChange++;
+    }
+    pick();
+    if (running == thread)
+        return;
+    turnCond.notify_all();
+    turnCond.wait(lock, [this, thread]() { return running == thread; });
+}
+
+void Scheduler::leave(int thread)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    finished[thread] = true;
+    if (++numLeft < numThreads) {
+        pick();
+        turnCond.notify_all();
+    }
+}
+
+void Scheduler::pick()
+{
+    int next = -1;
+    if (policy == Policy::Random) {
+        int k = static_cast<int>(rand.getRandomSize(0, numThreads - numLeft));
+        for (int i = 0; i < numThreads && next == -1; i++) {
+            if (!finished[i] && k-- == 0)
+                next = i;
+        }
+    } else {
+        for (int i = 0; i < numThreads; i++) {
+            if (!finished[i] && (next == -1 || priorities[i] > priorities[next]))
+                next = i;
+        }
+    }
+    if (running != next)
+        trace.push_back(next);
+    running = next;
+}
+
+}  // namespace util
+}  // namespace proptest
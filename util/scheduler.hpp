@@ -0,0 +1,86 @@
+#pragma once
+#include "../api.hpp"
+#include "../Random.hpp"
+#include "std.hpp"
+#include <condition_variable>
+#include <mutex>
+
+namespace proptest {
+
+/**
+ * @brief Scheduling point of a concurrency test
+ * @details On a thread run by a `util::Scheduler`, hands the processor over to the thread the scheduler picks next.
+ * Elsewhere, yields the processor to the OS scheduler. Call it between the steps of an operation whose interleavings
+ * with other threads are to be explored, but not while holding a lock that another scheduled thread may wait for.
+ */
+PROPTEST_API void yield();
+
+namespace util {
+
+/**
+ * @brief Runs threads one at a time, switching between them only at scheduling points, in an order drawn from a seed
+ * @details Threads take turns once all of them have joined, and a turn lasts until the running thread calls `yield()`
+ * or leaves. Since the choice of the next thread depends only on the seed and on the scheduling points reached, a
+ * schedule is replayed by running the same threads with the same seed.
+ *
+ * `Policy::Random` picks any unfinished thread at each scheduling point. `Policy::PCT` (probabilistic concurrency
+ * testing) runs the unfinished thread of highest priority, where threads start with distinct random priorities and
+ * the running thread drops below all others at `depth - 1` random scheduling points out of `numSteps` expected. A bug
+ * that needs `depth` ordering constraints to show up is then found with a probability of at least
+ * 1/(numThreads * numSteps^(depth-1)) per schedule.
+ */
+class PROPTEST_API Scheduler {
+public:
+    enum class Policy { Random, PCT };
+
+    Scheduler(int numThreads, uint64_t seed, Policy policy = Policy::PCT, int depth = 3, int numSteps = 100);
+
+    /**
+     * @brief Binds the calling thread to a scheduler as given thread, until the end of the scope
+     * @details Waits for the first turn of the thread on construction, and ends its turns on destruction
+     */
+    class PROPTEST_API Participant {
+    public:
+        Participant(Scheduler& scheduler, int thread);
+        ~Participant();
+
+        Participant(const Participant&) = delete;
+        Participant& operator=(const Participant&) = delete;
+
+    private:
+        Scheduler& scheduler;
+        int thread;
+    };
+
+    /// threads in the order they were given turns
+    const vector<int>& getTrace() const { return trace; }
+
+private:
+    friend void proptest::yield();
+
+    void join(int thread);
+    void yield(int thread);
+    void leave(int thread);
+    // gives the next turn. called with the mutex held
+    void pick();
+
+    const int numThreads;
+    const Policy policy;
+    Random rand;
+    std::mutex mutex;
+    std::condition_variable turnCond;
+    int numJoined;
+    int numLeft;
+    // thread holding the turn, -1 if none
+    int running;
+    vector<bool> finished;
+    vector<int> priorities;
+    // scheduling points where the running thread is deprioritized, in order
+    vector<int> changePoints;
+    size_t nextChange;
+    int numYields;
+    vector<int> trace;
+};
+
+}  // namespace util
+}  // namespace proptest
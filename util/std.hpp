@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <random>
 #include <limits>
+#include <cmath>
 
 #include <chrono>
 
@@ -75,6 +76,8 @@ using std::function;
 
 using std::string;
 using std::ostream;
+using std::streambuf;
+using std::streamsize;
 using std::stringstream;
 using std::cerr;
 using std::cout;
@@ -85,6 +88,9 @@ using std::setfill;
 using std::hex;
 
 using std::exception;
+using std::exception_ptr;
+using std::current_exception;
+using std::rethrow_exception;
 using std::logic_error;
 using std::runtime_error;
 using std::invalid_argument;
@@ -0,0 +1,191 @@
+#include "tagcounter.hpp"
+#include <mutex>
+
+namespace proptest {
+namespace util {
+
+namespace {
+
+std::mutex& getTagKeysMutex()
+{
+    static std::mutex mtx;
+    return mtx;
+}
+
+vector<string>& getTagKeyList()
+{
+    static vector<string> keys;
+    return keys;
+}
+
+std::unordered_map<string, int>& getTagKeyIds()
+{
+    static std::unordered_map<string, int> ids;
+    return ids;
+}
+
+uint64_t hashEntry(int keyId, uint64_t bits)
+{
+    // splitmix64 finalizer
+    uint64_t x = bits ^ (static_cast<uint64_t>(keyId) * 0x9e3779b97f4a7c15ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}  // namespace
+
+int TagKeys::intern(const string& key)
+{
+    std::lock_guard<std::mutex> guard(getTagKeysMutex());
+    auto& ids = getTagKeyIds();
+    auto itr = ids.find(key);
+    if (itr != ids.end())
+        return itr->second;
+
+    auto& keys = getTagKeyList();
+    int id = static_cast<int>(keys.size());
+    keys.push_back(key);
+    ids.insert(make_pair(key, id));
+    return id;
+}
+
+string TagKeys::keyOf(int id)
+{
+    std::lock_guard<std::mutex> guard(getTagKeysMutex());
+    return getTagKeyList()[id];
+}
+
+int TagSite::keyId(const char* key)
+{
+    // a call site almost always uses the same key, so comparing with the last one avoids the global lookup
+    if (lastId >= 0 && lastKey == key)
+        return lastId;
+    lastKey = key;
+    lastId = TagKeys::intern(lastKey);
+    return lastId;
+}
+
+int TagSite::keyId(const string& key)
+{
+    if (lastId >= 0 && lastKey == key)
+        return lastId;
+    lastKey = key;
+    lastId = TagKeys::intern(lastKey);
+    return lastId;
+}
+
+TagCounters::TagCounters() : slots(16, Entry{-1, Unused, 0, 0}), numUsed(0) {}
+
+void TagCounters::count(int keyId, bool value)
+{
+    add(keyId, Bool, value ? 1 : 0, 1);
+}
+
+void TagCounters::count(int keyId, int64_t value)
+{
+    add(keyId, Signed, static_cast<uint64_t>(value), 1);
+}
+
+void TagCounters::count(int keyId, uint64_t value)
+{
+    add(keyId, Unsigned, value, 1);
+}
+
+void TagCounters::count(int keyId, const string& value)
+{
+    add(keyId, String, internString(value), 1);
+}
+
+void TagCounters::clear()
+{
+    slots.assign(16, Entry{-1, Unused, 0, 0});
+    numUsed = 0;
+    strings.clear();
+    stringIndices.clear();
+}
+
+void TagCounters::merge(const TagCounters& other)
+{
+    for (auto& entry : other.slots) {
+        if (entry.kind == Unused)
+            continue;
+        if (entry.kind == String)
+            add(entry.keyId, String, internString(other.strings[entry.bits]), entry.count);
+        else
+            add(entry.keyId, entry.kind, entry.bits, entry.count);
+    }
+}
+
+uint64_t TagCounters::internString(const string& value)
+{
+    auto itr = stringIndices.find(value);
+    if (itr != stringIndices.end())
+        return itr->second;
+
+    uint64_t index = strings.size();
+    strings.push_back(value);
+    stringIndices.insert(make_pair(value, index));
+    return index;
+}
+
+void TagCounters::add(int keyId, Kind kind, uint64_t bits, size_t amount)
+{
+    size_t mask = slots.size() - 1;
+    size_t pos = static_cast<size_t>(hashEntry(keyId, bits) ^ kind) & mask;
+    while (true) {
+        Entry& entry = slots[pos];
+        if (entry.kind == Unused) {
+            entry = Entry{keyId, kind, bits, amount};
+            // keep load factor under 1/2
+            if (++numUsed * 2 > slots.size())
+                grow();
+            return;
+        }
+        if (entry.keyId == keyId && entry.kind == kind && entry.bits == bits) {
+            entry.count += amount;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+}
+
+void TagCounters::grow()
+{
+    vector<Entry> oldSlots(slots.size() * 2, Entry{-1, Unused, 0, 0});
+    oldSlots.swap(slots);
+    numUsed = 0;
+    for (auto& entry : oldSlots) {
+        if (entry.kind != Unused)
+            add(entry.keyId, entry.kind, entry.bits, entry.count);
+    }
+}
+
+string TagCounters::format(const Entry& entry) const
+{
+    switch (entry.kind) {
+        case Bool:
+            return entry.bits ? "true" : "false";
+        case Signed:
+            return to_string(static_cast<int64_t>(entry.bits));
+        case Unsigned:
+            return to_string(entry.bits);
+        case String:
+            return strings[entry.bits];
+        default:
+            return "";
+    }
+}
+
+map<string, map<string, size_t>> TagCounters::toMap() const
+{
+    map<string, map<string, size_t>> counts;
+    for (auto& entry : slots) {
+        if (entry.kind != Unused)
+            counts[TagKeys::keyOf(entry.keyId)][format(entry)] += entry.count;
+    }
+    return counts;
+}
+
+}  // namespace util
+}  // namespace proptest
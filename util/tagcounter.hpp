@@ -0,0 +1,169 @@
+#pragma once
+
+#include "../api.hpp"
+#include "std.hpp"
+#include <unordered_map>
+
+/**
+ * @file tagcounter.hpp
+ * @brief Counters of tag values for `PROP_TAG`, `PROP_STAT` and `PROP_CLASSIFY`
+ * @details Tag keys are interned to integer ids, cached at each call site, so that counting a tag does not look up
+ * or copy key strings. Boolean and integral values are counted as they are, and formatted only when the counts are
+ * collected into a summary.
+ */
+
+namespace proptest {
+namespace util {
+
+/**
+ * @brief Global table of interned tag keys
+ */
+struct PROPTEST_API TagKeys
+{
+    /// returns the id of given key, adding it if not present
+    static int intern(const string& key);
+    static string keyOf(int id);
+};
+
+/**
+ * @brief Key id cache of a tagging call site, declared as a `static thread_local` by the tagging macros
+ */
+class PROPTEST_API TagSite {
+public:
+    TagSite() : lastId(-1) {}
+
+    int keyId(const char* key);
+    int keyId(const string& key);
+
+private:
+    string lastKey;
+    int lastId;
+};
+
+/**
+ * @brief Open-addressing hash table of counts, by tag key id and value
+ */
+class PROPTEST_API TagCounters {
+public:
+    TagCounters();
+
+    void count(int keyId, bool value);
+    void count(int keyId, int64_t value);
+    void count(int keyId, uint64_t value);
+    void count(int keyId, const string& value);
+
+    bool empty() const { return numUsed == 0; }
+    void clear();
+    /// adds all counts of other
+    void merge(const TagCounters& other);
+    /// formatted values and their counts, by key
+    map<string, map<string, size_t>> toMap() const;
+
+private:
+    enum Kind : uint8_t { Unused = 0, Bool, Signed, Unsigned, String };
+
+    struct Entry
+    {
+        int keyId;
+        Kind kind;
+        uint64_t bits;  // value, or index in `strings` for String
+        size_t count;
+    };
+
+    uint64_t internString(const string& value);
+    void add(int keyId, Kind kind, uint64_t bits, size_t amount);
+    void grow();
+    string format(const Entry& entry) const;
+
+    vector<Entry> slots;  // size is a power of two
+    size_t numUsed;
+    vector<string> strings;
+    std::unordered_map<string, uint64_t> stringIndices;
+};
+
+/// * private
+inline int tagKeyId(TagSite& site, const char* key)
+{
+    return site.keyId(key);
+}
+
+/// * private
+inline int tagKeyId(TagSite& site, const string& key)
+{
+    return site.keyId(key);
+}
+
+/// * private
+template <typename T>
+enable_if_t<!std::is_convertible<const T&, const char*>::value && !is_same<T, string>::value, int> tagKeyId(
+    TagSite& site, const T& key)
+{
+    stringstream str;
+    str << key;
+    return site.keyId(str.str());
+}
+
+/// * private
+template <typename T>
+struct IsCharType
+    : std::integral_constant<bool, is_same<T, char>::value || is_same<T, signed char>::value ||
+                                       is_same<T, unsigned char>::value>
+{
+};
+
+/// * private: counts a tag value, formatting it with `operator<<` (with `boolalpha`) unless it can be counted as it is
+template <typename T, typename Enable = void>
+struct TagValue
+{
+    static void count(TagCounters& counters, int keyId, const T& value)
+    {
+        stringstream str;
+        str << boolalpha << value;
+        counters.count(keyId, str.str());
+    }
+};
+
+template <>
+struct TagValue<bool>
+{
+    static void count(TagCounters& counters, int keyId, bool value) { counters.count(keyId, value); }
+};
+
+template <typename T>
+struct TagValue<T, enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value && !IsCharType<T>::value>>
+{
+    static void count(TagCounters& counters, int keyId, T value)
+    {
+        counters.count(keyId, static_cast<int64_t>(value));
+    }
+};
+
+template <typename T>
+struct TagValue<T, enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value && !IsCharType<T>::value &&
+                               !is_same<T, bool>::value>>
+{
+    static void count(TagCounters& counters, int keyId, T value)
+    {
+        counters.count(keyId, static_cast<uint64_t>(value));
+    }
+};
+
+template <>
+struct TagValue<string>
+{
+    static void count(TagCounters& counters, int keyId, const string& value) { counters.count(keyId, value); }
+};
+
+template <>
+struct TagValue<const char*>
+{
+    static void count(TagCounters& counters, int keyId, const char* value) { counters.count(keyId, string(value)); }
+};
+
+template <>
+struct TagValue<char*> : public TagValue<const char*>
+{
+};
+
+}  // namespace util
+}  // namespace proptest
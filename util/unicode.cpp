@@ -1,10 +1,130 @@
 #include "misc.hpp"
 #include "unicode.hpp"
 #include "std.hpp"
+#include <cstring>
 
 namespace proptest {
 namespace util {
 
+namespace {
+
+const char hexDigits[] = "0123456789abcdef";
+
+// bytes as validChar writes them
+struct EscapeTable
+{
+    EscapeTable()
+    {
+        for (int c = 0; c < 256; c++) {
+            char* escape = str[c];
+            if (c == '\\') {
+                escape[0] = escape[1] = '\\';
+                size[c] = 2;
+            } else if (c < 0x20 || c == 0x7f) {
+                escape[0] = '\\';
+                escape[1] = 'x';
+                escape[2] = hexDigits[c >> 4];
+                escape[3] = hexDigits[c & 0xf];
+                size[c] = 4;
+            } else {
+                escape[0] = static_cast<char>(c);
+                size[c] = 1;
+            }
+        }
+    }
+
+    char str[256][4];
+    uint8_t size[256];
+};
+
+const EscapeTable& escapeTable()
+{
+    static const EscapeTable table;
+    return table;
+}
+
+}  // namespace
+
+void EscapeWriter::printable(uint8_t c)
+{
+    static const EscapeTable& table = escapeTable();
+    char* out = reserve(4);
+    memcpy(out, table.str[c], 4);
+    pos += table.size[c];
+}
+
+void EscapeWriter::printable2(uint8_t c)
+{
+    if (c < 0x20 || c == 0x7f) {
+        char* out = reserve(6);
+        out[0] = '\\';
+        out[1] = 'u';
+        out[2] = out[3] = '0';
+        out[4] = hexDigits[c >> 4];
+        out[5] = hexDigits[c & 0xf];
+        pos += 6;
+    } else
+        printable(c);
+}
+
+void EscapeWriter::codepage(uint32_t code)
+{
+    char* out = reserve(8);
+    int numDigits = code < 0x10000 ? 4 : 6;
+    out[0] = '\\';
+    out[1] = code < 0x10000 ? 'u' : 'U';
+    for (int i = 0; i < numDigits; i++)
+        out[2 + i] = hexDigits[(code >> ((numDigits - 1 - i) * 4)) & 0xf];
+    pos += 2 + numDigits;
+}
+
+void EscapeWriter::hex(uint8_t c)
+{
+    char* out = reserve(4);
+    out[0] = '\\';
+    out[1] = 'x';
+    out[2] = hexDigits[c >> 4];
+    out[3] = hexDigits[c & 0xf];
+    pos += 4;
+}
+
+void EscapeWriter::hexList(const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        char* out = reserve(3);
+        size_t n = 0;
+        if (i > 0)
+            out[n++] = ' ';
+        out[n++] = hexDigits[data[i] >> 4];
+        out[n++] = hexDigits[data[i] & 0xf];
+        pos += n;
+    }
+}
+
+void EscapeWriter::write(const char* str, size_t size)
+{
+    if (size > sizeof(buf)) {
+        flush();
+        os.write(str, size);
+        return;
+    }
+    memcpy(reserve(size), str, size);
+    pos += size;
+}
+
+void EscapeWriter::flush()
+{
+    if (pos > 0)
+        os.write(buf, pos);
+    pos = 0;
+}
+
+void escapeBytes(EscapeWriter& writer, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        writer.printable(data[i]);
+}
+
 ostream& codepage(ostream& os, uint32_t code)
 {
     util::IosFlagSaver iosFlagSaver(os);
@@ -24,8 +144,8 @@ ostream& codepage(ostream& os, uint32_t code)
 
 ostream& validString(ostream& os, const string& str)
 {
-    for (size_t i = 0; i < str.size(); i++)
-        validChar(os, static_cast<uint8_t>(str[i]));
+    EscapeWriter writer(os);
+    escapeBytes(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
     return os;
 }
 
@@ -65,26 +185,15 @@ ostream& charAsHex(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3, uint8_t c4)
 
 ostream& charAsHex(ostream& os, vector<uint8_t>& chars)
 {
-    util::IosFlagSaver iosFlagSaver(os);
-
-    if (chars.size() > 0)
-        os << /*"\\x" <<*/ setfill('0') << setw(2) << hex << static_cast<int>(chars[0]);
-    for (size_t i = 1; i < chars.size(); i++) {
-        os << " " << setfill('0') << setw(2) << hex << static_cast<int>(chars[i]);
-    }
+    EscapeWriter writer(os);
+    writer.hexList(chars.data(), chars.size());
     return os;
 }
 
 ostream& charAsHex(ostream& os, const string& chars)
 {
-    util::IosFlagSaver iosFlagSaver(os);
-
-    if (chars.size() > 0)
-        os << /*"\\x" <<*/ setfill('0') << setw(2) << hex
-           << static_cast<int>(static_cast<uint8_t>(chars[0]));
-    for (size_t i = 1; i < chars.size(); i++) {
-        os << " " << setfill('0') << setw(2) << hex << static_cast<int>(static_cast<uint8_t>(chars[i]));
-    }
+    EscapeWriter writer(os);
+    writer.hexList(reinterpret_cast<const uint8_t*>(chars.data()), chars.size());
     return os;
 }
 
@@ -35,6 +35,51 @@ struct PROPTEST_API StringPrintable
 
 ostream& validChar(ostream& os, uint8_t c);
 ostream& validChar2(ostream& os, uint8_t c);
+
+/**
+ * @brief Writes escaped characters into a fixed buffer, passed to the stream when full and when destroyed
+ * @details Escapes of bytes are looked up in a table, instead of formatting each of them with stream manipulators.
+ * The output is the same as of `validChar`, `validChar2`, `codepage` and `charAsHex`.
+ */
+class PROPTEST_API EscapeWriter {
+public:
+    explicit EscapeWriter(ostream& os) : os(os), pos(0) {}
+    ~EscapeWriter() { flush(); }
+
+    /// printable ASCII as is, control characters as `\xNN` (as `validChar`)
+    void printable(uint8_t c);
+    /// printable ASCII as is, control characters as `\u00NN` (as `validChar2`)
+    void printable2(uint8_t c);
+    /// `\uNNNN`, or `\UNNNNNN` above U+FFFF (as `codepage`)
+    void codepage(uint32_t code);
+    /// `\xNN` (as `charAsHex`)
+    void hex(uint8_t c);
+    /// bytes as 2 hex digits each, separated by spaces
+    void hexList(const uint8_t* data, size_t size);
+    void write(const char* str, size_t size);
+    template <size_t N>
+    void write(const char (&str)[N])
+    {
+        write(str, N - 1);
+    }
+
+    void flush();
+
+private:
+    char* reserve(size_t size)
+    {
+        if (pos + size > sizeof(buf))
+            flush();
+        return buf + pos;
+    }
+
+    ostream& os;
+    size_t pos;
+    char buf[512];
+};
+
+/// writes bytes as `validChar` does
+PROPTEST_API void escapeBytes(EscapeWriter& writer, const uint8_t* data, size_t size);
 // ostream& validChar(ostream& os, uint8_t c1, uint8_t c2);
 // ostream& validChar(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3);
 // ostream& validChar(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3, uint8_t c4);
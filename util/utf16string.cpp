@@ -1,6 +1,7 @@
 #include "../api.hpp"
 #include "utf16string.hpp"
 #include "unicode.hpp"
+#include "utfscan.hpp"
 #include "std.hpp"
 
 namespace proptest {
@@ -39,42 +40,30 @@ namespace util {
 
 ostream& decodeUTF16BE(ostream& os, const string& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeUTF16BE(os, chars);
+    EscapeWriter writer(os);
+    decodeUTF16BE(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 ostream& decodeUTF16BE(ostream& os, const UTF16BEString& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeUTF16BE(os, chars);
+    EscapeWriter writer(os);
+    decodeUTF16BE(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 ostream& decodeUTF16LE(ostream& os, const string& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeUTF16LE(os, chars);
+    EscapeWriter writer(os);
+    decodeUTF16LE(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 ostream& decodeUTF16LE(ostream& os, const UTF16LEString& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeUTF16LE(os, chars);
+    EscapeWriter writer(os);
+    decodeUTF16LE(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 /*
@@ -87,23 +76,27 @@ ostream& decodeUTF16LE(ostream& os, const UTF16LEString& str)
  * U+E000..U+FFFF     (as code point in LE/BE)
  * U+10000..: 4-byte surrogate pairs (U+D800..U+DBFF + U+DC00..U+DFFF)
  */
-ostream& decodeUTF16BE(ostream& os, vector<uint8_t>& chars)
+void decodeUTF16BE(EscapeWriter& writer, const uint8_t* chars, size_t size)
 {
-    for (size_t i = 0; i < chars.size(); i++) {
-        if (i + 2 > chars.size()) {
-            charAsHex(os, chars[i]);
+    for (size_t i = 0; i < size; i++) {
+        // a trailing odd byte
+        if (i + 2 > size) {
+            writer.hex(chars[i]);
+            break;
         }
         // ASCII: U+0000..U+007F
         if (chars[i] == 0 && chars[i + 1] <= 0x7f) {
-            validChar2(os, chars[i + 1]);
+            writer.printable2(chars[i + 1]);
             i++;
         }
         // U+0000..U+D7FF or U+E000..U+FFFF
         else if (chars[i] <= 0xD7 || 0xE0 <= chars[i]) {
-            codepage(os, (chars[i] << 8) + chars[i + 1]);
+            writer.codepage((chars[i] << 8) + chars[i + 1]);
             i++;
-        } else if (i + 4 > chars.size()) {
-            charAsHex(os, chars[i], chars[i + 1], chars[i + 2], chars[i + 3]);
+        } else if (i + 4 > size) {
+            // an unpaired surrogate at the end
+            for (; i < size; i++)
+                writer.hex(chars[i]);
             break;
         }
         // U+10000.. use surrogate pairs
@@ -113,13 +106,19 @@ ostream& decodeUTF16BE(ostream& os, vector<uint8_t>& chars)
             uint16_t s1 = ((chars[i+2] << 8) + chars[i+3]);
             uint32_t p0 = (s0 - 0xD800) << 10;
             uint32_t p1 = (s1 - 0xDC00);
-            codepage(os, 0x10000 + p0 + p1);
+            writer.codepage(0x10000 + p0 + p1);
             // uint16_t c0 = ((chars[i] - 0xD8) << 8) + chars[i + 1];
             // uint16_t c1 = ((chars[i + 2] - 0xDC) << 8) + chars[i + 3];
-            // codepage(os, 0x10000 + (c0 << 16) + c1);
+            // writer.codepage(0x10000 + (c0 << 16) + c1);
             i += 3;
         }
     }
+}
+
+ostream& decodeUTF16BE(ostream& os, vector<uint8_t>& chars)
+{
+    EscapeWriter writer(os);
+    decodeUTF16BE(writer, chars.data(), chars.size());
     return os;
 }
 
@@ -150,13 +149,22 @@ uint32_t decodeUTF16BE(vector<uint8_t>& chars)
     throw runtime_error("invalid UTF-16 BE sequence");
 }
 
-void encodeUTF16BE(uint32_t code, vector<uint8_t>& chars)
+size_t UTF16EncodedSize(uint32_t code)
+{
+    if (0xD800 <= code && code <= 0xDFFF)
+        throw runtime_error("should not reach here. surrogate region");
+    else if (code > 0x10FFFF)
+        throw runtime_error("should not reach here. code too big");
+    return code <= 0xFFFF ? 2 : 4;
+}
+
+void encodeUTF16BE(uint32_t code, uint8_t* out)
 {
     if (code <= 0xd7FF || (0xE000 <= code && code <= 0xFFFF)) {
         uint8_t c0 = (code >> 8);
         uint8_t c1 = (code & 0xff);
-        chars.push_back(c0);
-        chars.push_back(c1);
+        *out++ = c0;
+        *out++ = c1;
     }
     // code page U+10000..U+10FFFF
     else {
@@ -177,30 +185,41 @@ void encodeUTF16BE(uint32_t code, vector<uint8_t>& chars)
             throw runtime_error(os.str());
         }
 
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
-        chars.push_back(c3);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
+        *out++ = c3;
     }
 }
 
-ostream& decodeUTF16LE(ostream& os, vector<uint8_t>& chars)
+void encodeUTF16BE(uint32_t code, vector<uint8_t>& chars)
+{
+    size_t pos = chars.size();
+    chars.resize(pos + UTF16EncodedSize(code));
+    encodeUTF16BE(code, chars.data() + pos);
+}
+
+void decodeUTF16LE(EscapeWriter& writer, const uint8_t* chars, size_t size)
 {
-    for (size_t i = 0; i < chars.size(); i++) {
-        if (i + 2 > chars.size()) {
-            charAsHex(os, chars[i]);
+    for (size_t i = 0; i < size; i++) {
+        // a trailing odd byte
+        if (i + 2 > size) {
+            writer.hex(chars[i]);
+            break;
         }
         // ASCII: U+0000..U+007F
         if (chars[i + 1] == 0 && chars[i] <= 0x7f) {
-            validChar2(os, chars[i]);
+            writer.printable2(chars[i]);
             i++;
         }
         // U+0000..U+D7FF or U+E000..U+FFFF
         else if (chars[i + 1] <= 0xD7 || 0xE0 <= chars[i + 1]) {
-            codepage(os, (chars[i + 1] << 8) + chars[i]);
+            writer.codepage((chars[i + 1] << 8) + chars[i]);
             i++;
-        } else if (i + 4 > chars.size()) {
-            charAsHex(os, chars[i], chars[i + 1], chars[i + 2], chars[i + 3]);
+        } else if (i + 4 > size) {
+            // an unpaired surrogate at the end
+            for (; i < size; i++)
+                writer.hex(chars[i]);
             break;
         }
         // U+10000.. use surrogate pairs
@@ -210,10 +229,16 @@ ostream& decodeUTF16LE(ostream& os, vector<uint8_t>& chars)
             uint16_t s1 = ((chars[i+3] << 8) + chars[i+2]);
             uint32_t p0 = (s0 - 0xD800) << 10;
             uint32_t p1 = (s1 - 0xDC00);
-            codepage(os, 0x10000 + p0 + p1);
+            writer.codepage(0x10000 + p0 + p1);
             i += 3;
         }
     }
+}
+
+ostream& decodeUTF16LE(ostream& os, vector<uint8_t>& chars)
+{
+    EscapeWriter writer(os);
+    decodeUTF16LE(writer, chars.data(), chars.size());
     return os;
 }
 
@@ -244,13 +269,13 @@ uint32_t decodeUTF16LE(vector<uint8_t>& chars)
     throw runtime_error("invalid UTF-16 LE sequence");
 }
 
-void encodeUTF16LE(uint32_t code, vector<uint8_t>& chars)
+void encodeUTF16LE(uint32_t code, uint8_t* out)
 {
     if (code <= 0xd7ff || (0xE000 <= code && code <= 0xFFFF)) {
         uint8_t c0 = (code >> 8);
         uint8_t c1 = (code & 0xff);
-        chars.push_back(c1);
-        chars.push_back(c0);
+        *out++ = c1;
+        *out++ = c0;
     }
     // code page U+10000..U+10FFFF
     else {
@@ -271,37 +296,28 @@ void encodeUTF16LE(uint32_t code, vector<uint8_t>& chars)
             throw runtime_error(os.str());
             // throw runtime_error("invalid surrogate pairs: ");
         }
-        chars.push_back(c1);
-        chars.push_back(c0);
-        chars.push_back(c3);
-        chars.push_back(c2);
+        *out++ = c1;
+        *out++ = c0;
+        *out++ = c3;
+        *out++ = c2;
     }
 }
 
+void encodeUTF16LE(uint32_t code, vector<uint8_t>& chars)
+{
+    size_t pos = chars.size();
+    chars.resize(pos + UTF16EncodedSize(code));
+    encodeUTF16LE(code, chars.data() + pos);
+}
+
 int UTF16BECharSize(const string& str)
 {
-    vector<uint8_t> chars(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars[i] = str[i];
-    }
-    int numChars = 0;
-    if (isValidUTF16BE(chars, numChars)) {
-        return numChars;
-    } else
-        return -1;
+    return countUTF16BE(reinterpret_cast<const uint8_t*>(str.data()), str.size());
 }
 
 int UTF16LECharSize(const string& str)
 {
-    vector<uint8_t> chars(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars[i] = str[i];
-    }
-    int numChars = 0;
-    if (isValidUTF16LE(chars, numChars)) {
-        return numChars;
-    } else
-        return -1;
+    return countUTF16LE(reinterpret_cast<const uint8_t*>(str.data()), str.size());
 }
 
 bool isValidUTF16BE(vector<uint8_t>& chars)
@@ -312,22 +328,9 @@ bool isValidUTF16BE(vector<uint8_t>& chars)
 
 bool isValidUTF16BE(vector<uint8_t>& chars, int& numChars)
 {
-    numChars = 0;
-    for (size_t i = 0; i < chars.size(); i++, numChars++) {
-        if (i + 2 > chars.size()) {
-            return false;
-        } else if (chars[i] <= 0xD7 || 0xE0 <= chars[i]) {
-            i++;
-        } else if (i + 4 > chars.size()) {
-            return false;
-        }
-        // D800~DBFF + DC00~DF00
-        else if (0xD8 <= chars[i] && chars[i] <= 0xDB && 0xDC <= chars[i + 2] && chars[i + 2] <= 0xDF) {
-            i += 3;
-        } else
-            return false;
-    }
-    return true;
+    int count = countUTF16BE(chars.data(), chars.size());
+    numChars = count < 0 ? 0 : count;
+    return count >= 0;
 }
 
 bool isValidUTF16LE(vector<uint8_t>& chars)
@@ -338,22 +341,9 @@ bool isValidUTF16LE(vector<uint8_t>& chars)
 
 bool isValidUTF16LE(vector<uint8_t>& chars, int& numChars)
 {
-    numChars = 0;
-    for (size_t i = 0; i < chars.size(); i++, numChars++) {
-        if (i + 2 > chars.size()) {
-            return false;
-        } else if (chars[i + 1] <= 0xD7 || 0xE0 <= chars[i + 1]) {
-            i++;
-        } else if (i + 4 > chars.size()) {
-            return false;
-        }
-        // D800~DBFF + DC00~DF00
-        else if (0xD8 <= chars[i + 1] && chars[i + 1] <= 0xDB && 0xDC <= chars[i + 3] && chars[i + 3] <= 0xDF) {
-            i += 3;
-        } else
-            return false;
-    }
-    return true;
+    int count = countUTF16LE(chars.data(), chars.size());
+    numChars = count < 0 ? 0 : count;
+    return count >= 0;
 }
 
 }  // namespace util
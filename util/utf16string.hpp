@@ -24,6 +24,9 @@ public:
 };
 
 namespace util {
+
+class EscapeWriter;
+
 ostream& validUTF16Char(ostream& os, uint8_t c);
 ostream& validUTF16Char(ostream& os, uint8_t c1, uint8_t c2);
 ostream& validUTF16Char(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3);
@@ -32,9 +35,15 @@ ostream& validUTF16Char(ostream& os, uint8_t c1, uint8_t c2, uint8_t c3, uint8_t
 PROPTEST_API ostream& decodeUTF16BE(ostream& os, vector<uint8_t>& chars);
 PROPTEST_API ostream& decodeUTF16BE(ostream& os, const string& str);
 PROPTEST_API ostream& decodeUTF16BE(ostream& os, const UTF16BEString& str);
+/// same as above, decoding from memory into the buffer of given writer
+PROPTEST_API void decodeUTF16BE(EscapeWriter& writer, const uint8_t* data, size_t size);
 
 PROPTEST_API uint32_t decodeUTF16BE(vector<uint8_t>& chars);
 PROPTEST_API void encodeUTF16BE(uint32_t utf32, vector<uint8_t>& chars);
+/// number of bytes encoding the code point in either byte order. throws if it cannot be encoded
+PROPTEST_API size_t UTF16EncodedSize(uint32_t utf32);
+/// writes UTF16EncodedSize(utf32) bytes at out
+PROPTEST_API void encodeUTF16BE(uint32_t utf32, uint8_t* out);
 
 
 struct PROPTEST_API DecodeUTF16BE
@@ -53,9 +62,12 @@ PROPTEST_API int UTF16BECharSize(const string& str);
 PROPTEST_API ostream& decodeUTF16LE(ostream& os, vector<uint8_t>& chars);
 PROPTEST_API ostream& decodeUTF16LE(ostream& os, const string& str);
 PROPTEST_API ostream& decodeUTF16LE(ostream& os, const UTF16LEString& str);
+/// same as above, decoding from memory into the buffer of given writer
+PROPTEST_API void decodeUTF16LE(EscapeWriter& writer, const uint8_t* data, size_t size);
 
 PROPTEST_API uint32_t decodeUTF16LE(vector<uint8_t>& chars);
 PROPTEST_API void encodeUTF16LE(uint32_t utf32, vector<uint8_t>& chars);
+PROPTEST_API void encodeUTF16LE(uint32_t utf32, uint8_t* out);
 
 
 struct PROPTEST_API DecodeUTF16LE
@@ -1,6 +1,7 @@
 #include "../api.hpp"
 #include "utf8string.hpp"
 #include "unicode.hpp"
+#include "utfscan.hpp"
 #include "std.hpp"
 
 namespace proptest {
@@ -37,22 +38,16 @@ ostream& UTF8ToHex(ostream& os, vector<uint8_t>& chars)
 
 ostream& decodeUTF8(ostream& os, const string& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeUTF8(os, chars);
+    EscapeWriter writer(os);
+    decodeUTF8(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 ostream& decodeUTF8(ostream& os, const UTF8String& str)
 {
-    vector<uint8_t> chars;
-    chars.reserve(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars.push_back(str[i]);
-    }
-    return decodeUTF8(os, chars);
+    EscapeWriter writer(os);
+    decodeUTF8(writer, reinterpret_cast<const uint8_t*>(str.data()), str.size());
+    return os;
 }
 
 /*
@@ -71,110 +66,116 @@ ostream& decodeUTF8(ostream& os, const UTF8String& str)
  * U+100000..U+10FFFF F4       80..8F   80..BF   80..BF
  *
  */
-ostream& decodeUTF8(ostream& os, vector<uint8_t>& chars)
+void decodeUTF8(EscapeWriter& writer, const uint8_t* chars, size_t size)
 {
-    for (size_t i = 0; i < chars.size(); i++) {
+    for (size_t i = 0; i < size; i++) {
         // U+0000..U+007F
         if (chars[i] <= 0x7f) {
-            validChar(os, chars[i]);
+            writer.printable(chars[i]);
             // os << static_cast<char>(chars[i]);
-        } else if (i + 2 > chars.size()) {
-            charAsHex(os, chars[i]);
+        } else if (i + 2 > size) {
+            writer.hex(chars[i]);
             // U+0080..U+07FF
         } else if (0xc2 <= chars[i] && chars[i] <= 0xdf) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf) {
-                // validChar(os, chars[i] - 0xc2, chars[i+1]);
-                codepage(os, 0x80 + (chars[i] - 0xc2) * (0xbf - 0x80 + 1) + (chars[i + 1] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1]);
+                // writer.printable(chars[i] - 0xc2, chars[i+1]);
+                writer.codepage(0x80 + (chars[i] - 0xc2) * (0xbf - 0x80 + 1) + (chars[i + 1] - 0x80));
+                // writer.hex(chars[i], chars[i+1]);
                 i++;
             } else {
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             }
-        } else if (i + 3 > chars.size()) {
-            charAsHex(os, chars[i]);
+        } else if (i + 3 > size) {
+            writer.hex(chars[i]);
             // U+0800..U+0FFF
         } else if (0xe0 == chars[i]) {
             if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0x0800 + (chars[i] - 0xe0) * (0xbf - 0xa0 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2]);
+                writer.codepage(0x0800 + (chars[i] - 0xe0) * (0xbf - 0xa0 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0xa0) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+1000..U+CFFF
         } else if (0xe1 <= chars[i] && chars[i] <= 0xec) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0x1000 + (chars[i] - 0xe1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2]);
+                writer.codepage(0x1000 + (chars[i] - 0xe1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+D000..U+D7FF
         } else if (0xed == chars[i]) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x9f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0xD000 + (chars[i] - 0xed) * (0x9f - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2]);
+                writer.codepage(0xD000 + (chars[i] - 0xed) * (0x9f - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+E000..U+FFFF
         } else if (0xee <= chars[i] && chars[i] <= 0xef) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2]);
-                codepage(os, 0xe000 + (chars[i] - 0xee) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2]);
+                writer.codepage(0xe000 + (chars[i] - 0xee) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 2] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2]);
                 i += 2;
             } else
-                charAsHex(os, chars[i]);
-        } else if (i + 4 > chars.size()) {
-            charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
+        } else if (i + 4 > size) {
+            writer.hex(chars[i]);
             // U+10000..U+3FFFF
         } else if (0xf0 == chars[i]) {
             if (0x90 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
                 0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2], chars[i+3]);
-                codepage(os, 0x10000 + (chars[i] - 0xf0) * (0xbf - 0x90 + 1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2], chars[i+3]);
+                writer.codepage(0x10000 + (chars[i] - 0xf0) * (0xbf - 0x90 + 1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x90) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 2] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 3] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2], chars[i+3]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2], chars[i+3]);
                 i += 3;
             } else
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+40000..U+FFFFF
         } else if (0xf1 <= chars[i] && chars[i] <= 0xf3) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
                 0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2], chars[i+3]);
-                codepage(os, 0x40000 + (chars[i] - 0xf1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2], chars[i+3]);
+                writer.codepage(0x40000 + (chars[i] - 0xf1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 2] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 3] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2], chars[i+3]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2], chars[i+3]);
                 i += 3;
             } else
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             // U+100000..U+10FFFF
         } else if (0xf4 == chars[i]) {
             if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x8f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
                 0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
-                // validChar(os, chars[i], chars[i+1], chars[i+2], chars[i+3]);
-                codepage(os, 0x100000 + (chars[i] - 0xf4) * (0x8f - 0x80 + 1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
+                // writer.printable(chars[i], chars[i+1], chars[i+2], chars[i+3]);
+                writer.codepage(0x100000 + (chars[i] - 0xf4) * (0x8f - 0x80 + 1) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 1] - 0x80) * (0xbf - 0x80 + 1) * (0xbf - 0x80 + 1) +
                                  (chars[i + 2] - 0x80) * (0xbf - 0x80 + 1) + (chars[i + 3] - 0x80));
-                // charAsHex(os, chars[i], chars[i+1], chars[i+2], chars[i+3]);
+                // writer.hex(chars[i], chars[i+1], chars[i+2], chars[i+3]);
                 i += 3;
             } else {
-                charAsHex(os, chars[i]);
+                writer.hex(chars[i]);
             }
         } else {
-            charAsHex(os, chars[i]);
+            writer.hex(chars[i]);
         }
     }
+}
+
+ostream& decodeUTF8(ostream& os, vector<uint8_t>& chars)
+{
+    EscapeWriter writer(os);
+    decodeUTF8(writer, chars.data(), chars.size());
     return os;
 }
 
@@ -261,40 +262,49 @@ uint32_t decodeUTF8(vector<uint8_t>& chars)
     throw runtime_error("invalid UTF-8 sequence");
 }
 
-void encodeUTF8(uint32_t code, vector<uint8_t>& chars)
+size_t UTF8EncodedSize(uint32_t code)
+{
+    if (0xD800 <= code && code <= 0xDFFF)
+        throw runtime_error("should not reach here. surrogate region");
+    else if (code > 0x10FFFF)
+        throw runtime_error("should not reach here. code too big");
+    return code <= 0x7F ? 1 : code <= 0x7FF ? 2 : code <= 0xFFFF ? 3 : 4;
+}
+
+void encodeUTF8(uint32_t code, uint8_t* out)
 {
     if (code <= 0x7f) {
-        chars.push_back(static_cast<uint8_t>(code));
+        *out++ = static_cast<uint8_t>(code);
     } else if (code <= 0x07FF) {
         code -= 0x80;
         uint8_t c0 = (code >> 6) + 0xc2;
         uint8_t c1 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
+        *out++ = c0;
+        *out++ = c1;
     } else if (code <= 0x0FFF) {
         code -= 0x800;
         uint8_t c0 = 0xe0;
         uint8_t c1 = (code >> 6) + 0xa0;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0xCFFF) {
         code -= 0x1000;
         uint8_t c0 = (code >> 12) + 0xe1;
         uint8_t c1 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0xD7FF) {
         code -= 0xD000;
         uint8_t c0 = 0xed;
         uint8_t c1 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0xDFFF) {
         throw runtime_error("should not reach here. surrogate region");
     } else if (code <= 0xFFFF) {
@@ -302,56 +312,55 @@ void encodeUTF8(uint32_t code, vector<uint8_t>& chars)
         uint8_t c0 = (code >> 12) + 0xee;
         uint8_t c1 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c2 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
     } else if (code <= 0x3FFFF) {
         code -= 0x10000;
         uint8_t c0 = 0xf0;
         uint8_t c1 = (code >> 12) + 0x90;
         uint8_t c2 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c3 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
-        chars.push_back(c3);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
+        *out++ = c3;
     } else if (code <= 0xFFFFF) {
         code -= 0x40000;
         uint8_t c0 = (code >> 18) + 0xf1;
         uint8_t c1 = ((code >> 12) & 0x3f) + 0x80;
         uint8_t c2 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c3 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
-        chars.push_back(c3);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
+        *out++ = c3;
     } else if (code <= 0x10FFFF) {
         code -= 0x100000;
         uint8_t c0 = 0xf4;
         uint8_t c1 = (code >> 12) + 0x80;
         uint8_t c2 = ((code >> 6) & 0x3f) + 0x80;
         uint8_t c3 = (code & 0x3f) + 0x80;
-        chars.push_back(c0);
-        chars.push_back(c1);
-        chars.push_back(c2);
-        chars.push_back(c3);
+        *out++ = c0;
+        *out++ = c1;
+        *out++ = c2;
+        *out++ = c3;
 
     } else {
         throw runtime_error("should not reach here. code too big");
     }
 }
 
+void encodeUTF8(uint32_t code, vector<uint8_t>& chars)
+{
+    size_t pos = chars.size();
+    chars.resize(pos + UTF8EncodedSize(code));
+    encodeUTF8(code, chars.data() + pos);
+}
+
 int UTF8CharSize(const string& str)
 {
-    vector<uint8_t> chars(str.size());
-    for (size_t i = 0; i < str.size(); i++) {
-        chars[i] = str[i];
-    }
-    int numChars = 0;
-    if (isValidUTF8(chars, numChars)) {
-        return numChars;
-    } else
-        return -1;
+    return countUTF8(reinterpret_cast<const uint8_t*>(str.data()), str.size());
 }
 
 bool isValidUTF8(vector<uint8_t>& chars)
@@ -362,65 +371,9 @@ bool isValidUTF8(vector<uint8_t>& chars)
 
 bool isValidUTF8(vector<uint8_t>& chars, int& numChars)
 {
-    numChars = 0;
-    for (size_t i = 0; i < chars.size(); i++, numChars++) {
-        if (chars[i] <= 0x7f) {
-            continue;
-        } else if (i + 2 > chars.size()) {
-            return false;
-        } else if (0xc2 <= chars[i] && chars[i] <= 0xdf) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf) {
-                i++;
-            } else
-                return false;
-        } else if (i + 3 > chars.size()) {
-            return false;
-        } else if (0xe0 == chars[i]) {
-            if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else if (0xe1 <= chars[i] && chars[i] <= 0xec) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else if (0xed == chars[i]) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x9f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else if (0xee <= chars[i] && chars[i] <= 0xef) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
-                i += 2;
-            } else
-                return false;
-        } else if (i + 4 > chars.size()) {
-            return false;
-        } else if (0xf0 == chars[i]) {
-            if (0x90 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
-                0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
-                i += 3;
-            } else
-                return false;
-        } else if (0xf1 <= chars[i] && chars[i] <= 0xf3) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
-                0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
-                i += 3;
-            } else
-                return false;
-
-        } else if (0xf4 == chars[i]) {
-            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x8f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
-                0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
-                i += 3;
-            } else
-                return false;
-
-        } else
-            return false;
-    }
-    return true;
+    int count = countUTF8(chars.data(), chars.size());
+    numChars = count < 0 ? 0 : count;
+    return count >= 0;
 }
 
 }  // namespace util
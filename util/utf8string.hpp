@@ -16,12 +16,19 @@ public:
 
 namespace util {
 
+class EscapeWriter;
+
+
 PROPTEST_API ostream& UTF8ToHex(ostream& os, vector<uint8_t>& chars);
 PROPTEST_API ostream& decodeUTF8(ostream& os, const string& str);
 PROPTEST_API ostream& decodeUTF8(ostream& os, const UTF8String& str);
 
 PROPTEST_API uint32_t decodeUTF8(vector<uint8_t>& chars);
 void encodeUTF8(uint32_t code, vector<uint8_t>& chars);
+/// number of bytes encoding the code point. throws if it cannot be encoded
+PROPTEST_API size_t UTF8EncodedSize(uint32_t code);
+/// writes UTF8EncodedSize(code) bytes at out
+PROPTEST_API void encodeUTF8(uint32_t code, uint8_t* out);
 
 struct PROPTEST_API DecodeUTF8
 {
@@ -33,6 +40,8 @@ struct PROPTEST_API DecodeUTF8
 };
 
 PROPTEST_API ostream& decodeUTF8(ostream& os, vector<uint8_t>& chars);
+/// same as above, decoding from memory into the buffer of given writer
+PROPTEST_API void decodeUTF8(EscapeWriter& writer, const uint8_t* data, size_t size);
 
 PROPTEST_API bool isValidUTF8(vector<uint8_t>& chars);
 PROPTEST_API bool isValidUTF8(vector<uint8_t>& chars, int& numChars);
@@ -0,0 +1,573 @@
+#include "utfscan.hpp"
+#include "std.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PROPTEST_UTF_SIMD 1
+#include <immintrin.h>
+#define PROPTEST_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace proptest {
+namespace util {
+
+namespace {
+
+/*
+ * scalar kernels
+ */
+
+int64_t scalarUTF8(const uint8_t* chars, size_t size)
+{
+    int64_t numChars = 0;
+    for (size_t i = 0; i < size; i++, numChars++) {
+        if (chars[i] <= 0x7f) {
+            continue;
+        } else if (i + 2 > size) {
+            return -1;
+        } else if (0xc2 <= chars[i] && chars[i] <= 0xdf) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf) {
+                i++;
+            } else
+                return -1;
+        } else if (i + 3 > size) {
+            return -1;
+        } else if (0xe0 == chars[i]) {
+            if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else if (0xe1 <= chars[i] && chars[i] <= 0xec) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else if (0xed == chars[i]) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x9f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else if (0xee <= chars[i] && chars[i] <= 0xef) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else if (i + 4 > size) {
+            return -1;
+        } else if (0xf0 == chars[i]) {
+            if (0x90 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
+                0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
+                i += 3;
+            } else
+                return -1;
+        } else if (0xf1 <= chars[i] && chars[i] <= 0xf3) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
+                0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
+                i += 3;
+            } else
+                return -1;
+        } else if (0xf4 == chars[i]) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x8f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf &&
+                0x80 <= chars[i + 3] && chars[i + 3] <= 0xbf) {
+                i += 3;
+            } else
+                return -1;
+        } else
+            return -1;
+    }
+    return numChars;
+}
+
+int64_t scalarCESU8(const uint8_t* chars, size_t size)
+{
+    int64_t numChars = 0;
+    for (size_t i = 0; i < size; i++, numChars++) {
+        if (chars[i] <= 0x7f) {
+            continue;
+        } else if (i + 2 > size) {
+            return -1;
+        } else if (0xc2 <= chars[i] && chars[i] <= 0xdf) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf) {
+                i++;
+            } else
+                return -1;
+        } else if (i + 3 > size) {
+            return -1;
+        } else if (0xe0 == chars[i]) {
+            if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else if (0xe1 <= chars[i] && chars[i] <= 0xec) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else if (0xed == chars[i]) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0x9f && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else {
+                // surrogate pair (U+10000..U+10FFFF)
+                if (i + 6 > size) {
+                    return -1;
+                } else if (0xa0 <= chars[i + 1] && chars[i + 1] <= 0xaf && 0x80 <= chars[i + 2] &&
+                           chars[i + 2] <= 0xbf && 0xed == chars[i + 3] && 0xb0 <= chars[i + 4] &&
+                           chars[i + 4] <= 0xbf && 0x80 <= chars[i + 5] && chars[i + 5] <= 0xbf) {
+                    i += 5;
+                } else
+                    return -1;
+            }
+        } else if (0xee <= chars[i] && chars[i] <= 0xef) {
+            if (0x80 <= chars[i + 1] && chars[i + 1] <= 0xbf && 0x80 <= chars[i + 2] && chars[i + 2] <= 0xbf) {
+                i += 2;
+            } else
+                return -1;
+        } else
+            return -1;
+    }
+    return numChars;
+}
+
+// hi: offset of the more significant byte of a code unit (0 for big endian, 1 for little endian)
+int64_t scalarUTF16(const uint8_t* chars, size_t size, size_t hi)
+{
+    int64_t numChars = 0;
+    for (size_t i = 0; i < size; i++, numChars++) {
+        if (i + 2 > size) {
+            return -1;
+        } else if (chars[i + hi] <= 0xD7 || 0xE0 <= chars[i + hi]) {
+            i++;
+        } else if (i + 4 > size) {
+            return -1;
+        }
+        // D800~DBFF + DC00~DF00
+        else if (0xD8 <= chars[i + hi] && chars[i + hi] <= 0xDB && 0xDC <= chars[i + 2 + hi] &&
+                 chars[i + 2 + hi] <= 0xDF) {
+            i += 3;
+        } else
+            return -1;
+    }
+    return numChars;
+}
+
+#ifdef PROPTEST_UTF_SIMD
+
+/*
+ * UTF-8 and CESU-8 kernels validate each byte by looking up its high nibble and the two nibbles of the preceding
+ * byte in tables of possible errors (J. Keiser and D. Lemire, "Validating UTF-8 In Less Than One Instruction Per
+ * Byte", 2021). An error remains only if all three lookups agree on it.
+ */
+
+enum : uint8_t {
+    TooShort = 1 << 0,  // 11______ 0_______ or 11______ 11______
+    TooLong = 1 << 1,   // 0_______ 10______
+    Overlong3 = 1 << 2,  // 11100000 100_____
+    TooLarge = 1 << 3,   // 11110100 1001____, 11110100 101_____, or 11110101 and above
+    Surrogate = 1 << 4,  // 11101101 101_____
+    Overlong2 = 1 << 5,  // 1100000_ 10______
+    TooLarge1000 = 1 << 6,  // 11110101 1000____ and above
+    Overlong4 = 1 << 6,     // 11110000 1000____
+    Lead4 = 1 << 6,         // 1111____ 10______ (CESU-8 has no 4-byte sequences)
+    TwoConts = 1 << 7,      // 10______ 10______
+    Carry = TooShort | TooLong | TwoConts,
+};
+
+struct LookupTables
+{
+    uint8_t byte1High[16];
+    uint8_t byte1Low[16];
+    uint8_t byte2High[16];
+};
+
+const LookupTables utf8Tables = {
+    {TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TwoConts, TwoConts, TwoConts, TwoConts,
+     TooShort | Overlong2, TooShort, TooShort | Overlong3 | Surrogate,
+     TooShort | TooLarge | TooLarge1000 | Overlong4},
+    {Carry | Overlong3 | Overlong2 | Overlong4, Carry | Overlong2, Carry, Carry, Carry | TooLarge,
+     Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+     Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+     Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000,
+     Carry | TooLarge | TooLarge1000 | Surrogate, Carry | TooLarge | TooLarge1000, Carry | TooLarge | TooLarge1000},
+    {TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+     TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4,
+     TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge, TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+     TooLong | Overlong2 | TwoConts | Surrogate | TooLarge, TooShort, TooShort, TooShort, TooShort}};
+
+// surrogates are allowed, as their pairing is checked separately
+const LookupTables cesu8Tables = {
+    {TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TwoConts, TwoConts, TwoConts, TwoConts,
+     TooShort | Overlong2, TooShort, TooShort | Overlong3, TooShort | Lead4},
+    {Carry | Overlong3 | Overlong2 | Lead4, Carry | Overlong2 | Lead4, Carry | Lead4, Carry | Lead4, Carry | Lead4,
+     Carry | Lead4, Carry | Lead4, Carry | Lead4, Carry | Lead4, Carry | Lead4, Carry | Lead4, Carry | Lead4,
+     Carry | Lead4, Carry | Lead4, Carry | Lead4, Carry | Lead4},
+    {TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+     TooLong | Overlong2 | TwoConts | Overlong3 | Lead4, TooLong | Overlong2 | TwoConts | Overlong3 | Lead4,
+     TooLong | Overlong2 | TwoConts | Lead4, TooLong | Overlong2 | TwoConts | Lead4, TooShort, TooShort, TooShort,
+     TooShort}};
+
+/*
+ * SSE4.1 (16 bytes per block)
+ */
+
+struct SSEBlock
+{
+    __m128i errors;  // nonzero bytes where the block is not valid
+    uint32_t numLeads;  // bytes that start a character
+    uint32_t secondOfHigh;  // (CESU-8) bits of second bytes of high surrogates
+    uint32_t secondOfLow;   // (CESU-8) bits of second bytes of low surrogates
+};
+
+PROPTEST_TARGET("sse4.1,popcnt")
+inline SSEBlock checkSSE(__m128i input, __m128i prevInput, const __m128i (&tables)[3], bool cesu8)
+{
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+    __m128i prev1 = _mm_alignr_epi8(input, prevInput, 15);
+    __m128i byte1High = _mm_shuffle_epi8(tables[0], _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask));
+    __m128i byte1Low = _mm_shuffle_epi8(tables[1], _mm_and_si128(prev1, nibbleMask));
+    __m128i byte2High = _mm_shuffle_epi8(tables[2], _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+    __m128i specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // third and fourth bytes of multibyte characters are where TwoConts is expected
+    __m128i prev2 = _mm_alignr_epi8(input, prevInput, 14);
+    __m128i mustBeCont = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+    if (!cesu8) {
+        __m128i prev3 = _mm_alignr_epi8(input, prevInput, 13);
+        mustBeCont = _mm_or_si128(mustBeCont, _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xf0 - 0x80))));
+    }
+    mustBeCont = _mm_and_si128(mustBeCont, _mm_set1_epi8(static_cast<char>(0x80)));
+
+    SSEBlock block;
+    block.errors = _mm_xor_si128(mustBeCont, specialCases);
+    // any byte but continuation bytes (0x80..0xbf), compared as signed
+    block.numLeads = static_cast<uint32_t>(
+        __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(input, _mm_set1_epi8(static_cast<char>(0xbf))))));
+    block.secondOfHigh = block.secondOfLow = 0;
+    if (cesu8) {
+        __m128i afterED = _mm_cmpeq_epi8(prev1, _mm_set1_epi8(static_cast<char>(0xed)));
+        __m128i highNibble = _mm_and_si128(input, _mm_set1_epi8(static_cast<char>(0xf0)));
+        block.secondOfHigh = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(afterED, _mm_cmpeq_epi8(highNibble, _mm_set1_epi8(static_cast<char>(0xa0))))));
+        block.secondOfLow = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(afterED, _mm_cmpeq_epi8(highNibble, _mm_set1_epi8(static_cast<char>(0xb0))))));
+    }
+    return block;
+}
+
+PROPTEST_TARGET("sse4.1,popcnt")
+int64_t sseUTF8(const uint8_t* data, size_t size, bool cesu8)
+{
+    const LookupTables& lookup = cesu8 ? cesu8Tables : utf8Tables;
+    const __m128i tables[3] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(lookup.byte1High)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(lookup.byte1Low)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(lookup.byte2High))};
+    __m128i prevInput = _mm_setzero_si128();
+    __m128i errors = _mm_setzero_si128();
+    int64_t numChars = 0;
+    uint32_t pendingLows = 0;  // (CESU-8) second bytes of low surrogates expected in the next block
+    size_t i = 0;
+    // the last block is padded with zeros, which also reveals a character cut at the end
+    for (bool last = false; !last; i += 16) {
+        __m128i input;
+        size_t numPadding = 0;
+        if (i + 16 <= size) {
+            input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        } else {
+            uint8_t buffer[16] = {0};
+            std::memcpy(buffer, data + i, size - i);
+            input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+            numPadding = 16 - (size - i);
+            last = true;
+        }
+        SSEBlock block = checkSSE(input, prevInput, tables, cesu8);
+        errors = _mm_or_si128(errors, block.errors);
+        numChars += static_cast<int64_t>(block.numLeads) - static_cast<int64_t>(numPadding);
+        if (cesu8) {
+            // a low surrogate follows every high surrogate, 3 bytes apart
+            uint32_t expectedLows = ((block.secondOfHigh << 3) | pendingLows) & 0xffff;
+            if (block.secondOfLow != expectedLows)
+                return -1;
+            pendingLows = block.secondOfHigh >> 13;
+            numChars -= __builtin_popcount(block.secondOfLow);
+        }
+        prevInput = input;
+    }
+    // a high surrogate at the end without its low surrogate
+    if (pendingLows != 0)
+        return -1;
+    return _mm_testz_si128(errors, errors) ? numChars : -1;
+}
+
+/*
+ * AVX2 (32 bytes per block)
+ */
+
+PROPTEST_TARGET("avx2,popcnt")
+inline __m256i prevAVX2(__m256i input, __m256i prevInput, int n)
+{
+    // bytes of prevInput's upper lane and input's lower lane, so that each lane can be shifted in with alignr
+    __m256i shifted = _mm256_permute2x128_si256(prevInput, input, 0x21);
+    switch (n) {
+        case 1:
+            return _mm256_alignr_epi8(input, shifted, 15);
+        case 2:
+            return _mm256_alignr_epi8(input, shifted, 14);
+        default:
+            return _mm256_alignr_epi8(input, shifted, 13);
+    }
+}
+
+PROPTEST_TARGET("avx2,popcnt")
+inline __m256i loadTableAVX2(const uint8_t* table)
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+PROPTEST_TARGET("avx2,popcnt")
+int64_t avx2UTF8(const uint8_t* data, size_t size, bool cesu8)
+{
+    const LookupTables& lookup = cesu8 ? cesu8Tables : utf8Tables;
+    const __m256i byte1HighTable = loadTableAVX2(lookup.byte1High);
+    const __m256i byte1LowTable = loadTableAVX2(lookup.byte1Low);
+    const __m256i byte2HighTable = loadTableAVX2(lookup.byte2High);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+    __m256i prevInput = _mm256_setzero_si256();
+    __m256i errors = _mm256_setzero_si256();
+    int64_t numChars = 0;
+    uint32_t pendingLows = 0;
+    size_t i = 0;
+    for (bool last = false; !last; i += 32) {
+        __m256i input;
+        size_t numPadding = 0;
+        if (i + 32 <= size) {
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        } else {
+            uint8_t buffer[32] = {0};
+            std::memcpy(buffer, data + i, size - i);
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer));
+            numPadding = 32 - (size - i);
+            last = true;
+        }
+
+        __m256i prev1 = prevAVX2(input, prevInput, 1);
+        __m256i byte1High = _mm256_shuffle_epi8(byte1HighTable, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibbleMask));
+        __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(prev1, nibbleMask));
+        __m256i byte2High = _mm256_shuffle_epi8(byte2HighTable, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibbleMask));
+        __m256i specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+        __m256i mustBeCont =
+            _mm256_subs_epu8(prevAVX2(input, prevInput, 2), _mm256_set1_epi8(static_cast<char>(0xe0 - 0x80)));
+        if (!cesu8)
+            mustBeCont = _mm256_or_si256(mustBeCont, _mm256_subs_epu8(prevAVX2(input, prevInput, 3),
+                                                                      _mm256_set1_epi8(static_cast<char>(0xf0 - 0x80))));
+        mustBeCont = _mm256_and_si256(mustBeCont, _mm256_set1_epi8(static_cast<char>(0x80)));
+        errors = _mm256_or_si256(errors, _mm256_xor_si256(mustBeCont, specialCases));
+
+        uint32_t leads = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpgt_epi8(input, _mm256_set1_epi8(static_cast<char>(0xbf)))));
+        numChars += __builtin_popcount(leads) - static_cast<int64_t>(numPadding);
+        if (cesu8) {
+            __m256i afterED = _mm256_cmpeq_epi8(prev1, _mm256_set1_epi8(static_cast<char>(0xed)));
+            __m256i highNibble = _mm256_and_si256(input, _mm256_set1_epi8(static_cast<char>(0xf0)));
+            uint32_t secondOfHigh = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(afterED, _mm256_cmpeq_epi8(highNibble, _mm256_set1_epi8(static_cast<char>(0xa0))))));
+            uint32_t secondOfLow = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_and_si256(afterED, _mm256_cmpeq_epi8(highNibble, _mm256_set1_epi8(static_cast<char>(0xb0))))));
+            if (secondOfLow != ((secondOfHigh << 3) | pendingLows))
+                return -1;
+            pendingLows = secondOfHigh >> 29;
+            numChars -= __builtin_popcount(secondOfLow);
+        }
+        prevInput = input;
+    }
+    if (pendingLows != 0)
+        return -1;
+    return _mm256_testz_si256(errors, errors) ? numChars : -1;
+}
+
+/*
+ * UTF-16 kernels find high (D800..DBFF) and low (DC00..DFFF) surrogates of a block as bit masks. The sequence is
+ * valid if low surrogates are exactly at the positions right after high surrogates.
+ */
+
+// returns false if invalid. numChars is decreased by low surrogates, and carry is set if the block ends with a high
+// surrogate
+PROPTEST_TARGET("popcnt")
+inline bool checkSurrogates(uint32_t highs, uint32_t lows, uint32_t numUnits, uint32_t& carry, int64_t& numChars)
+{
+    uint32_t unitMask = numUnits == 32 ? 0xffffffff : (1u << numUnits) - 1;
+    if (lows != (((highs << 1) | carry) & unitMask))
+        return false;
+    carry = (highs >> (numUnits - 1)) & 1;
+    numChars += numUnits - __builtin_popcount(lows);
+    return true;
+}
+
+PROPTEST_TARGET("sse4.1,popcnt")
+int64_t sseUTF16(const uint8_t* data, size_t size, bool bigEndian)
+{
+    if (size % 2 != 0)
+        return -1;
+    int64_t numChars = 0;
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // more significant byte of each unit, masked to tell high and low surrogates apart
+        __m128i hi = bigEndian ? _mm_and_si128(units, _mm_set1_epi16(0x00ff)) : _mm_srli_epi16(units, 8);
+        hi = _mm_and_si128(hi, _mm_set1_epi16(0xfc));
+        __m128i isHigh = _mm_cmpeq_epi16(hi, _mm_set1_epi16(0xd8));
+        __m128i isLow = _mm_cmpeq_epi16(hi, _mm_set1_epi16(0xdc));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(isHigh, isLow)));
+        if (!checkSurrogates(mask & 0xff, mask >> 8, 8, carry, numChars))
+            return -1;
+    }
+    if (carry) {
+        // continue with the high surrogate at the end
+        i -= 2;
+        numChars--;
+    }
+    int64_t rest = scalarUTF16(data + i, size - i, bigEndian ? 0 : 1);
+    return rest < 0 ? -1 : numChars + rest;
+}
+
+PROPTEST_TARGET("avx2,popcnt")
+int64_t avx2UTF16(const uint8_t* data, size_t size, bool bigEndian)
+{
+    if (size % 2 != 0)
+        return -1;
+    int64_t numChars = 0;
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i units = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = bigEndian ? _mm256_and_si256(units, _mm256_set1_epi16(0x00ff)) : _mm256_srli_epi16(units, 8);
+        hi = _mm256_and_si256(hi, _mm256_set1_epi16(0xfc));
+        __m256i isHigh = _mm256_cmpeq_epi16(hi, _mm256_set1_epi16(0xd8));
+        __m256i isLow = _mm256_cmpeq_epi16(hi, _mm256_set1_epi16(0xdc));
+        // packing interleaves the lanes: highs 0-7, lows 0-7, highs 8-15, lows 8-15
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(isHigh, isLow), 0xd8);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(packed));
+        if (!checkSurrogates(mask & 0xffff, mask >> 16, 16, carry, numChars))
+            return -1;
+    }
+    if (carry) {
+        i -= 2;
+        numChars--;
+    }
+    int64_t rest = scalarUTF16(data + i, size - i, bigEndian ? 0 : 1);
+    return rest < 0 ? -1 : numChars + rest;
+}
+
+#endif  // PROPTEST_UTF_SIMD
+
+int toCount(int64_t numChars)
+{
+    return static_cast<int>(numChars);
+}
+
+SimdLevel effectiveLevel(SimdLevel level)
+{
+    SimdLevel available = getSimdLevel();
+    return static_cast<int>(level) < static_cast<int>(available) ? level : available;
+}
+
+}  // namespace
+
+SimdLevel getSimdLevel()
+{
+#ifdef PROPTEST_UTF_SIMD
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("popcnt"))
+            return SimdLevel::Scalar;
+        else if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::AVX2;
+        else if (__builtin_cpu_supports("sse4.1"))
+            return SimdLevel::SSE4;
+        else
+            return SimdLevel::Scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+int countUTF8(const uint8_t* data, size_t size, SimdLevel level)
+{
+    switch (effectiveLevel(level)) {
+#ifdef PROPTEST_UTF_SIMD
+        case SimdLevel::AVX2:
+            return toCount(avx2UTF8(data, size, false));
+        case SimdLevel::SSE4:
+            return toCount(sseUTF8(data, size, false));
+#endif
+        default:
+            return toCount(scalarUTF8(data, size));
+    }
+}
+
+int countCESU8(const uint8_t* data, size_t size, SimdLevel level)
+{
+    switch (effectiveLevel(level)) {
+#ifdef PROPTEST_UTF_SIMD
+        case SimdLevel::AVX2:
+            return toCount(avx2UTF8(data, size, true));
+        case SimdLevel::SSE4:
+            return toCount(sseUTF8(data, size, true));
+#endif
+        default:
+            return toCount(scalarCESU8(data, size));
+    }
+}
+
+int countUTF16BE(const uint8_t* data, size_t size, SimdLevel level)
+{
+    switch (effectiveLevel(level)) {
+#ifdef PROPTEST_UTF_SIMD
+        case SimdLevel::AVX2:
+            return toCount(avx2UTF16(data, size, true));
+        case SimdLevel::SSE4:
+            return toCount(sseUTF16(data, size, true));
+#endif
+        default:
+            return toCount(scalarUTF16(data, size, 0));
+    }
+}
+
+int countUTF16LE(const uint8_t* data, size_t size, SimdLevel level)
+{
+    switch (effectiveLevel(level)) {
+#ifdef PROPTEST_UTF_SIMD
+        case SimdLevel::AVX2:
+            return toCount(avx2UTF16(data, size, false));
+        case SimdLevel::SSE4:
+            return toCount(sseUTF16(data, size, false));
+#endif
+        default:
+            return toCount(scalarUTF16(data, size, 1));
+    }
+}
+
+int countUTF8(const uint8_t* data, size_t size)
+{
+    return countUTF8(data, size, SimdLevel::AVX2);
+}
+
+int countCESU8(const uint8_t* data, size_t size)
+{
+    return countCESU8(data, size, SimdLevel::AVX2);
+}
+
+int countUTF16BE(const uint8_t* data, size_t size)
+{
+    return countUTF16BE(data, size, SimdLevel::AVX2);
+}
+
+int countUTF16LE(const uint8_t* data, size_t size)
+{
+    return countUTF16LE(data, size, SimdLevel::AVX2);
+}
+
+}  // namespace util
+}  // namespace proptest
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../api.hpp"
+#include "std.hpp"
+
+/**
+ * @file utfscan.hpp
+ * @brief Validation and character counting of UTF-8, CESU-8 and UTF-16 byte sequences
+ * @details Vectorized kernels are selected at run time by the instruction sets the CPU supports (AVX2 or SSE4.1 on
+ * x86 with GCC or Clang), with a scalar kernel as fallback. All kernels accept exactly the same byte sequences.
+ */
+
+namespace proptest {
+namespace util {
+
+enum class SimdLevel {
+    Scalar = 0,
+    SSE4 = 1,
+    AVX2 = 2,
+};
+
+/// best kernel level available on this CPU
+PROPTEST_API SimdLevel getSimdLevel();
+
+/// number of characters of a valid byte sequence, or -1 if the sequence is not valid
+PROPTEST_API int countUTF8(const uint8_t* data, size_t size);
+PROPTEST_API int countCESU8(const uint8_t* data, size_t size);
+PROPTEST_API int countUTF16BE(const uint8_t* data, size_t size);
+PROPTEST_API int countUTF16LE(const uint8_t* data, size_t size);
+
+/// same as above, with the kernel of given level if available (or the best available one below it)
+PROPTEST_API int countUTF8(const uint8_t* data, size_t size, SimdLevel level);
+PROPTEST_API int countCESU8(const uint8_t* data, size_t size, SimdLevel level);
+PROPTEST_API int countUTF16BE(const uint8_t* data, size_t size, SimdLevel level);
+PROPTEST_API int countUTF16LE(const uint8_t* data, size_t size, SimdLevel level);
+
+}  // namespace util
+}  // namespace proptest
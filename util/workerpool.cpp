@@ -0,0 +1,65 @@
+#include "workerpool.hpp"
+
+namespace proptest {
+namespace util {
+
+WorkerPool::WorkerPool(int _numWorkers)
+    : numWorkers(_numWorkers), task(nullptr), generation(0), numRunning(0), stopping(false), numArrived(0)
+{
+    for (int i = 0; i < numWorkers; i++)
+        threads.emplace_back(&WorkerPool::work, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCond.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void WorkerPool::run(const function<void(int)>& _task)
+{
+    std::lock_guard<std::mutex> runLock(runMutex);
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &_task;
+    numRunning = size();
+    numArrived = 0;
+    generation++;
+    startCond.notify_all();
+    doneCond.wait(lock, [this]() { return numRunning == 0; });
+    task = nullptr;
+}
+
+void WorkerPool::work(int id)
+{
+    uint64_t lastGeneration = 0;
+    while (true) {
+        const function<void(int)>* current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            startCond.wait(lock, [&]() { return stopping || generation != lastGeneration; });
+            if (stopping)
+                return;
+            lastGeneration = generation;
+            current = task;
+        }
+
+        // barrier
+        numArrived.fetch_add(1);
+        while (numArrived.load() < numWorkers)
+            std::this_thread::yield();
+
+        (*current)(id);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--numRunning == 0)
+            doneCond.notify_one();
+    }
+}
+
+}  // namespace util
+}  // namespace proptest
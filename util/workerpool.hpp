@@ -0,0 +1,51 @@
+#pragma once
+#include "../api.hpp"
+#include "std.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace proptest {
+namespace util {
+
+/**
+ * @brief Fixed set of threads that run a task together, reused from one run to the next
+ * @details Workers are created on construction and joined on destruction. `run` wakes all workers and returns when
+ * all have finished. Workers pass a barrier before calling the task, so that the tasks start as close together as
+ * possible for their actions to interleave. Waiting workers yield the processor instead of spinning, so that more
+ * workers than processors do not slow each other down.
+ */
+class PROPTEST_API WorkerPool {
+public:
+    explicit WorkerPool(int numWorkers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int size() const { return numWorkers; }
+
+    /// calls task(i) on worker i for each worker, and waits until all have returned. task must not throw
+    void run(const function<void(int)>& task);
+
+private:
+    void work(int id);
+
+    const int numWorkers;
+    // serializes runs from different threads
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable startCond;
+    std::condition_variable doneCond;
+    const function<void(int)>* task;
+    uint64_t generation;
+    int numRunning;
+    bool stopping;
+    // workers that reached the barrier of the current run
+    std::atomic<int> numArrived;
+    vector<std::thread> threads;
+};
+
+}  // namespace util
+}  // namespace proptest